@@ -0,0 +1,186 @@
+#pragma once
+
+#include "engine/entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief ArenaArray is the identifier of an array in an ArenaLayout.
+ */
+using ArenaArray = std::size_t;
+
+/**
+ * \brief ArenaLayout is a class that describes the arrays of an Arena, placed one after the other in the same buffer.
+ * An array holds either one value, or one element per Entity up to the capacity of the Arena.
+ */
+class ArenaLayout
+{
+public:
+    template<typename T>
+    ArenaArray AddArray() { return AddArrayInfo<T>(true); }
+    template<typename T>
+    ArenaArray AddValue() { return AddArrayInfo<T>(false); }
+    /**
+     * \brief ComputeOffsets is a method that gives the offset in bytes of each array in an Arena of the given capacity.
+     * \param capacity is the number of entities that the Arena can hold.
+     * \param offsets is filled with the offset of each array.
+     * \return the total size in bytes of the Arena.
+     */
+    std::size_t ComputeOffsets(std::size_t capacity, std::vector<std::size_t>& offsets) const;
+    /**
+     * \brief GetArraySize is a method that gives the size in bytes of an array in an Arena of the given capacity.
+     */
+    [[nodiscard]] std::size_t GetArraySize(ArenaArray array, std::size_t capacity) const;
+    [[nodiscard]] std::size_t GetArrayNmb() const { return arrays_.size(); }
+    /**
+     * \brief Two ArenaLayout objects are equal when they describe the same arrays in the same order,
+     * such that their Arenas can be copied into each other.
+     */
+    bool operator==(const ArenaLayout& other) const = default;
+private:
+    template<typename T>
+    ArenaArray AddArrayInfo(bool isPerEntity)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Arena arrays are copied with memcpy");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Arena buffer is only aligned on std::max_align_t");
+        arrays_.push_back({ sizeof(T), alignof(T), isPerEntity });
+        return arrays_.size() - 1;
+    }
+
+    struct ArrayInfo
+    {
+        std::size_t elementSize = 0;
+        std::size_t alignment = 0;
+        bool isPerEntity = false;
+        bool operator==(const ArrayInfo& other) const = default;
+    };
+    std::vector<ArrayInfo> arrays_;
+};
+
+/**
+ * \brief Arena is a class that owns one contiguous buffer holding all the arrays of an ArenaLayout.
+ * Copying an Arena into another one of the same capacity is a single memcpy, without any allocation.
+ * The buffer is zero-initialized, such that the arrays start empty.
+ */
+class Arena
+{
+public:
+    Arena(const ArenaLayout& layout, std::size_t capacity);
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    [[nodiscard]] std::size_t GetCapacity() const { return capacity_; }
+    [[nodiscard]] std::size_t GetByteSize() const { return byteSize_; }
+    template<typename T>
+    [[nodiscard]] T* Get(ArenaArray array) { return reinterpret_cast<T*>(data_.get() + offsets_[array]); }
+    template<typename T>
+    [[nodiscard]] const T* Get(ArenaArray array) const { return reinterpret_cast<const T*>(data_.get() + offsets_[array]); }
+    /**
+     * \brief CopyFrom is a method that replaces the content of the Arena by the one of another Arena with an equal layout and the same capacity.
+     */
+    void CopyFrom(const Arena& arena);
+    /**
+     * \brief Reserve is a method that grows the Arena to hold at least capacity entities, keeping the content of its arrays.
+     * It is the only method allocating after the construction.
+     */
+    void Reserve(std::size_t capacity);
+private:
+    const ArenaLayout* layout_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t byteSize_ = 0;
+    std::vector<std::size_t> offsets_;
+    std::unique_ptr<std::byte[]> data_;
+};
+
+/**
+ * \brief ArenaSparseSet is a class that describes a sparse set stored in an Arena: a dense array of entities sorted by Entity,
+ * an Entity to dense index array, and the component arrays following the dense order.
+ * It does not own any data and works on the given Arena, such that all the copies of a world share it.
+ */
+class ArenaSparseSet
+{
+public:
+    static constexpr std::size_t INVALID_INDEX = std::numeric_limits<std::size_t>::max();
+
+    explicit ArenaSparseSet(ArenaLayout& layout);
+    /**
+     * \brief AddComponentArray is a method that adds an array to the layout that is reordered with the dense entities.
+     */
+    template<typename T>
+    ArenaArray AddComponentArray(ArenaLayout& layout)
+    {
+        const auto array = layout.AddArray<T>();
+        componentArrays_.push_back({ array, sizeof(T) });
+        return array;
+    }
+    [[nodiscard]] std::size_t GetSize(const Arena& arena) const { return *arena.Get<std::uint32_t>(size_); }
+    [[nodiscard]] bool Contains(const Arena& arena, Entity entity) const
+    {
+        return entity < arena.GetCapacity() && arena.Get<std::uint32_t>(indices_)[entity] != 0;
+    }
+    /**
+     * \brief GetIndex is a method that returns the dense index of an Entity, or INVALID_INDEX if it is not in the set.
+     */
+    [[nodiscard]] std::size_t GetIndex(const Arena& arena, Entity entity) const
+    {
+        return Contains(arena, entity) ? arena.Get<std::uint32_t>(indices_)[entity] - 1u : INVALID_INDEX;
+    }
+    [[nodiscard]] std::span<const Entity> GetEntities(const Arena& arena) const
+    {
+        return { arena.Get<Entity>(entities_), GetSize(arena) };
+    }
+    /**
+     * \brief Insert is a method that adds an Entity keeping the dense arrays sorted, the next elements being shifted by one.
+     * \param arena is the Arena to change, its capacity needs to be greater than entity.
+     * \param entity is the Entity to add, it must not be in the set.
+     * \return the dense index of the Entity, whose component values need to be set.
+     */
+    std::size_t Insert(Arena& arena, Entity entity) const;
+    /**
+     * \brief Erase is a method that removes an Entity and its components keeping the dense arrays sorted.
+     * \param arena is the Arena to change.
+     * \param entity is the Entity to remove, it must be in the set.
+     */
+    void Erase(Arena& arena, Entity entity) const;
+private:
+    void UpdateIndices(Arena& arena, std::size_t startIndex) const;
+
+    /**
+     * \brief ComponentArray is a struct that holds an array reordered with the dense entities, and the size of its elements.
+     */
+    struct ComponentArray
+    {
+        ArenaArray array = 0;
+        std::size_t elementSize = 0;
+    };
+    ArenaArray size_;
+    ArenaArray entities_;
+    //Dense index plus one, such that a zeroed array is empty
+    ArenaArray indices_;
+    std::vector<ComponentArray> componentArrays_;
+};
+
+/**
+ * \brief ArenaComponentLayout is a struct that describes the arrays of one Component type stored in an Arena,
+ * a sparse set and its dense component array.
+ */
+template<typename T>
+struct ArenaComponentLayout
+{
+    explicit ArenaComponentLayout(ArenaLayout& layout) : sparseSet(layout), components(sparseSet.AddComponentArray<T>(layout))
+    {
+    }
+    ArenaSparseSet sparseSet;
+    ArenaArray components;
+};
+} // namespace core
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "engine/arena.h"
 #include "engine/globals.h"
 #include "engine/entity.h"
+#include "engine/sparse_set.h"
 #include "utils/assert.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 
 namespace core
@@ -34,6 +38,8 @@ template<typename T, Component C>
 class ComponentManager
 {
 public:
+    static constexpr Component componentType = C;
+
     ComponentManager(EntityManager& entityManager) : entityManager_(entityManager)
     {
         components_.resize(entityInitNmb);
@@ -84,9 +90,133 @@ public:
      * \param components is the new component array to be copy instead of the old components array
      */
     void CopyAllComponents(const std::vector<T>& components);
+    /**
+     * \brief ForEach is a method that calls func(entity, component) on every Entity having the flag C, in ascending Entity order.
+     * Components must not be added or removed while iterating.
+     */
+    template<typename Func>
+    void ForEach(Func func);
+    template<typename Func>
+    void ForEach(Func func) const;
+protected:
+    EntityManager& entityManager_;
+    std::vector<T> components_;
+};
+
+/**
+ * \brief SparseComponentManager is a ComponentManager storage mode that only owns the Component of the entities that have it.
+ * Components are packed in a dense array sorted by Entity, and an Entity to dense index array gives a constant time access.
+ * Iterating with ForEach only visits the entities that have the Component, in ascending Entity order like ComponentManager.
+ * \tparam T type of the component
+ * \tparam C unique binary flag of the component. This will be set in the EntityMask of the EntityManager when added.
+ */
+template<typename T, Component C>
+class SparseComponentManager
+{
+public:
+    static constexpr Component componentType = C;
+
+    SparseComponentManager(EntityManager& entityManager) : entityManager_(entityManager)
+    {
+    }
+    virtual ~SparseComponentManager() = default;
+
+    SparseComponentManager(const SparseComponentManager&) = delete;
+    SparseComponentManager& operator=(SparseComponentManager&) = delete;
+    SparseComponentManager(SparseComponentManager&&) = delete;
+    SparseComponentManager& operator=(SparseComponentManager&&) = delete;
+
+    /**
+     * \brief AddComponent is a method that sets the flag C in the EntityManager and inserts a default Component in the dense array if needed.
+     * \param entity will have its flag C added in EntityManager
+     */
+    virtual void AddComponent(Entity entity);
+    /**
+     * \brief RemoveComponent is a method that unsets the flag C in the EntityManager and removes the Component from the dense array.
+     * \param entity will have its flag C removed
+     */
+    virtual void RemoveComponent(Entity entity);
+    [[nodiscard]] const T& GetComponent(Entity entity) const;
+    [[nodiscard]] T& GetComponent(Entity entity);
+    void SetComponent(Entity entity, const T& value);
+    /**
+     * \brief GetAllComponents is a method that returns the dense array of components, sorted by Entity.
+     */
+    [[nodiscard]] const std::vector<T>& GetAllComponents() const { return components_; }
+    /**
+     * \brief GetAllEntities is a method that returns the Entity owning each Component of the dense array.
+     */
+    [[nodiscard]] const std::vector<Entity>& GetAllEntities() const { return sparseSet_.GetEntities(); }
+    /**
+     * \brief CopyAllComponents is a method that replaces the dense arrays by copying newly provided ones.
+     * Components of entities that lost the flag C in the meantime (destroyed entities) are dropped.
+     * It is used by the RollbackManager when reverting the current game world data with the last validated game world data.
+     * \param components is the new dense component array
+     * \param entities is the Entity owning each Component of components
+     */
+    void CopyAllComponents(const std::vector<T>& components, const std::vector<Entity>& entities);
+    /**
+     * \brief ForEach is a method that calls func(entity, component) on every Entity having the flag C, in ascending Entity order.
+     * Components must not be added or removed while iterating.
+     */
+    template<typename Func>
+    void ForEach(Func func);
+    template<typename Func>
+    void ForEach(Func func) const;
 protected:
     EntityManager& entityManager_;
     std::vector<T> components_;
+    SparseSet sparseSet_;
+};
+
+/**
+ * \brief ArenaComponentManager is a SparseComponentManager storage mode whose sparse set and dense array live in an Arena.
+ * The manager only holds the layout and the Arena it works on, such that saving or restoring all the components of a world
+ * is a copy of its Arena. The Arena needs to be reserved for an Entity before adding its Component.
+ * References to components are invalidated when the Arena grows.
+ * \tparam T type of the component, it needs to be trivially copyable
+ * \tparam C unique binary flag of the component. This will be set in the EntityMask of the EntityManager when added.
+ */
+template<typename T, Component C>
+class ArenaComponentManager
+{
+public:
+    static constexpr Component componentType = C;
+
+    ArenaComponentManager(EntityManager& entityManager, const ArenaComponentLayout<T>& layout, Arena& arena) :
+        entityManager_(entityManager), layout_(layout), arena_(arena)
+    {
+    }
+    virtual ~ArenaComponentManager() = default;
+
+    ArenaComponentManager(const ArenaComponentManager&) = delete;
+    ArenaComponentManager& operator=(ArenaComponentManager&) = delete;
+    ArenaComponentManager(ArenaComponentManager&&) = delete;
+    ArenaComponentManager& operator=(ArenaComponentManager&&) = delete;
+
+    /**
+     * \brief AddComponent is a method that sets the flag C in the EntityManager and inserts a default Component in the Arena if needed.
+     * \param entity will have its flag C added in EntityManager
+     */
+    virtual void AddComponent(Entity entity);
+    /**
+     * \brief RemoveComponent is a method that unsets the flag C in the EntityManager and removes the Component from the Arena.
+     * \param entity will have its flag C removed
+     */
+    virtual void RemoveComponent(Entity entity);
+    [[nodiscard]] const T& GetComponent(Entity entity) const;
+    [[nodiscard]] T& GetComponent(Entity entity);
+    void SetComponent(Entity entity, const T& value);
+    /**
+     * \brief ForEach is a method that calls func(entity, component) on every Entity having the flag C, in ascending Entity order.
+     * Components must not be added or removed while iterating.
+     */
+    template<typename Func>
+    void ForEach(Func func);
+protected:
+    EntityManager& entityManager_;
+    const ArenaComponentLayout<T>& layout_;
+    Arena& arena_;
 };
 
 template <typename T, Component C>
@@ -154,4 +284,193 @@ void ComponentManager<T, C>::CopyAllComponents(const std::vector<T>& components)
 {
     components_ = components;
 }
+
+template <typename T, Component C>
+template <typename Func>
+void ComponentManager<T, C>::ForEach(Func func)
+{
+    const auto size = std::min(components_.size(), entityManager_.GetEntitiesSize());
+    for (Entity entity = 0; entity < size; entity++)
+    {
+        if (entityManager_.HasComponent(entity, C))
+        {
+            func(entity, components_[entity]);
+        }
+    }
+}
+
+template <typename T, Component C>
+template <typename Func>
+void ComponentManager<T, C>::ForEach(Func func) const
+{
+    const auto size = std::min(components_.size(), entityManager_.GetEntitiesSize());
+    for (Entity entity = 0; entity < size; entity++)
+    {
+        if (entityManager_.HasComponent(entity, C))
+        {
+            func(entity, components_[entity]);
+        }
+    }
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::AddComponent(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    //Invalid entity would allocate too much memory
+    if (entity == INVALID_ENTITY)
+        return;
+    if (!sparseSet_.Contains(entity))
+    {
+        //Keep the dense array sorted to iterate in the same order as ComponentManager
+        const auto index = sparseSet_.Insert(entity);
+        components_.insert(components_.begin() + static_cast<std::ptrdiff_t>(index), T{});
+    }
+    entityManager_.AddComponent(entity, C);
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::RemoveComponent(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the removing component");
+    entityManager_.RemoveComponent(entity, C);
+    if (!sparseSet_.Contains(entity))
+        return;
+    const auto index = sparseSet_.Erase(entity);
+    components_.erase(components_.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+template <typename T, Component C>
+const T& SparseComponentManager<T, C>::GetComponent(Entity entity) const
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
+    gpr_assert(sparseSet_.Contains(entity), "Entity component is not stored");
+    return components_[sparseSet_.GetIndex(entity)];
+}
+
+template <typename T, Component C>
+T& SparseComponentManager<T, C>::GetComponent(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
+    gpr_assert(sparseSet_.Contains(entity), "Entity component is not stored");
+    return components_[sparseSet_.GetIndex(entity)];
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::SetComponent(Entity entity, const T& value)
+{
+    GetComponent(entity) = value;
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::CopyAllComponents(const std::vector<T>& components, const std::vector<Entity>& entities)
+{
+    gpr_assert(components.size() == entities.size(), "Components and entities arrays have different sizes");
+    sparseSet_.Clear();
+    components_.clear();
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        const auto entity = entities[i];
+        if (!entityManager_.HasComponent(entity, C))
+            continue;
+        sparseSet_.PushBack(entity);
+        components_.push_back(components[i]);
+    }
+}
+
+template <typename T, Component C>
+template <typename Func>
+void SparseComponentManager<T, C>::ForEach(Func func)
+{
+    const auto& entities = sparseSet_.GetEntities();
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        if (entityManager_.HasComponent(entities[i], C))
+        {
+            func(entities[i], components_[i]);
+        }
+    }
+}
+
+template <typename T, Component C>
+template <typename Func>
+void SparseComponentManager<T, C>::ForEach(Func func) const
+{
+    const auto& entities = sparseSet_.GetEntities();
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        if (entityManager_.HasComponent(entities[i], C))
+        {
+            func(entities[i], components_[i]);
+        }
+    }
+}
+
+template <typename T, Component C>
+void ArenaComponentManager<T, C>::AddComponent(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    if (entity == INVALID_ENTITY)
+        return;
+    if (!layout_.sparseSet.Contains(arena_, entity))
+    {
+        //Keep the dense array sorted to iterate in the same order as ComponentManager
+        const auto index = layout_.sparseSet.Insert(arena_, entity);
+        arena_.Get<T>(layout_.components)[index] = T{};
+    }
+    entityManager_.AddComponent(entity, C);
+}
+
+template <typename T, Component C>
+void ArenaComponentManager<T, C>::RemoveComponent(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the removing component");
+    entityManager_.RemoveComponent(entity, C);
+    if (!layout_.sparseSet.Contains(arena_, entity))
+        return;
+    layout_.sparseSet.Erase(arena_, entity);
+}
+
+template <typename T, Component C>
+const T& ArenaComponentManager<T, C>::GetComponent(Entity entity) const
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
+    gpr_assert(layout_.sparseSet.Contains(arena_, entity), "Entity component is not stored");
+    return arena_.Get<T>(layout_.components)[layout_.sparseSet.GetIndex(arena_, entity)];
+}
+
+template <typename T, Component C>
+T& ArenaComponentManager<T, C>::GetComponent(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
+    gpr_assert(layout_.sparseSet.Contains(arena_, entity), "Entity component is not stored");
+    return arena_.Get<T>(layout_.components)[layout_.sparseSet.GetIndex(arena_, entity)];
+}
+
+template <typename T, Component C>
+void ArenaComponentManager<T, C>::SetComponent(Entity entity, const T& value)
+{
+    GetComponent(entity) = value;
+}
+
+template <typename T, Component C>
+template <typename Func>
+void ArenaComponentManager<T, C>::ForEach(Func func)
+{
+    const auto entities = layout_.sparseSet.GetEntities(arena_);
+    auto* components = arena_.Get<T>(layout_.components);
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        if (entityManager_.HasComponent(entities[i], C))
+        {
+            func(entities[i], components[i]);
+        }
+    }
+}
 } // namespace core
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <vector>
 #include <limits>
 
@@ -20,6 +21,11 @@ using Entity = std::uint32_t;
  * It is used to know what Component an Entity has.
  */
 using EntityMask = std::uint32_t;
+/**
+ * \brief EntityGeneration is the type used to count how many times an Entity index was destroyed.
+ * It allows to detect that a stored Entity was destroyed and its index reused by another one.
+ */
+using EntityGeneration = std::uint32_t;
 /**
  * \brief INVALID_ENTITY is a constant that define an invalid Entity.
  */
@@ -28,6 +34,26 @@ constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
  * \brief INVALID_ENTITY_MASK is a constant that define an invalid or empty entity mask.
  */
 constexpr EntityMask INVALID_ENTITY_MASK = 0u;
+/**
+ * \brief EntityQuery is a struct that holds the sorted list of entities matching an include and an exclude mask.
+ * It is kept up to date by the EntityManager each time an EntityMask changes.
+ */
+struct EntityQuery
+{
+    EntityMask includeMask = INVALID_ENTITY_MASK;
+    EntityMask excludeMask = INVALID_ENTITY_MASK;
+    std::vector<Entity> entities;
+    /**
+     * \brief version is incremented each time the entities list changes, such that iterations can detect it.
+     */
+    std::uint32_t version = 0;
+
+    [[nodiscard]] bool Matches(EntityMask mask) const
+    {
+        return mask != INVALID_ENTITY_MASK && (mask & includeMask) == includeMask && (mask & excludeMask) == 0;
+    }
+};
+
 /**
  * \brief Manages the entities in an array using bitwise operations to know if it has components.
  */
@@ -38,7 +64,7 @@ public:
     EntityManager(std::size_t reservedSize);
     /**
      * \brief CreateEntity is a method that will return the next available Entity index.
-     * It will look at the internal entityMasks_ array and give the first one that is free to use.
+     * It will look at the free entities bitset and give the first one that is free to use.
      * If none are free, the array is reallocated.
      * \return the newly created Entity
      */
@@ -47,6 +73,7 @@ public:
      * \brief DestroyEntity is a method that will erase all Component from the EntityMask.
      * It means that EntityExists will be false and that HasComponent will always return false.
      * It will not do anything to the actual ComponentManager.
+     * The generation of the Entity index is incremented, such that stored copies of the Entity can be detected as outdated.
      * \param entity is the mask that will be voided
      */
     void DestroyEntity(Entity entity);
@@ -81,10 +108,55 @@ public:
      * \return the total size of the EntityMask array.
      */
     [[nodiscard]] std::size_t GetEntitiesSize() const;
-
+    /**
+     * \brief GetGeneration is a method that returns the generation of an Entity index, incremented each time the Entity is destroyed.
+     * \param entity is the Entity that we check
+     * \return the current generation of the Entity index
+     */
+    [[nodiscard]] EntityGeneration GetGeneration(Entity entity) const;
+    /**
+     * \brief FindEntities is a method that scans all the EntityMask at once and gives the entities having all the includeMask components and none of the excludeMask ones.
+     * The scan uses SSE2 (4 masks at a time) or AVX2 (8 masks at a time, with the ENABLE_AVX2 CMake option) when available.
+     * \param includeMask is the Component bitwise mask that the entities need to have.
+     * \param excludeMask is the Component bitwise mask that the entities must not have.
+     * \param entities is cleared and filled with the matching entities in ascending order.
+     */
+    void FindEntities(EntityMask includeMask, EntityMask excludeMask, std::vector<Entity>& entities) const;
+    /**
+     * \brief GetQuery is a method that returns the cached EntityQuery of the given masks.
+     * The first call registers the query and fills it with one scan of the entities,
+     * afterwards it is updated incrementally when an EntityMask changes.
+     * \param includeMask is the Component bitwise mask that the entities need to have.
+     * \param excludeMask is the Component bitwise mask that the entities must not have.
+     * \return the registered EntityQuery, whose reference stays valid for the lifetime of the EntityManager.
+     */
+    [[nodiscard]] const EntityQuery& GetQuery(EntityMask includeMask, EntityMask excludeMask) const;
+    /**
+     * \brief CopyFrom is a method that copies the EntityMask, generations and free entities of another EntityManager.
+     * The arrays keep their allocation when they are large enough, and the registered queries are kept and scanned again.
+     * \param entityManager is the copied EntityManager, its queries are not copied.
+     */
+    void CopyFrom(const EntityManager& entityManager);
 
 private:
+    void SetEntityMask(Entity entity, EntityMask newMask);
+    void ResizeEntities(std::size_t newSize);
+    void SetEntityFree(Entity entity, bool isFree);
+
     std::vector<EntityMask> entityMasks_;
+    std::vector<EntityGeneration> generations_;
+    /**
+     * \brief freeEntities_ is a bitset with one bit per Entity, set when the Entity is free to use.
+     */
+    std::vector<std::uint64_t> freeEntities_;
+    /**
+     * \brief firstFreeWord_ is the lowest index of freeEntities_ that might contain a free Entity.
+     */
+    std::size_t firstFreeWord_ = 0;
+    /**
+     * \brief queries_ is a deque to keep the EntityQuery references stable when registering new ones.
+     */
+    mutable std::deque<EntityQuery> queries_;
 };
 
 } // namespace core
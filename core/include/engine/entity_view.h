@@ -0,0 +1,87 @@
+#pragma once
+
+#include "engine/entity.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief EntityView is a class that gives access to the entities having all the IncludeMask components and none of the ExcludeMask ones.
+ * It uses the cached EntityQuery of the EntityManager, so iterating does not scan the whole EntityMask array.
+ * Entities are visited in ascending Entity order, and the iteration stays valid when EntityMasks change in the meantime
+ * (an Entity leaving the view is not visited anymore, an Entity entering it after the visited one will be).
+ * \tparam IncludeMask Component bitwise mask that the entities need to have.
+ * \tparam ExcludeMask Component bitwise mask that the entities must not have.
+ */
+template<EntityMask IncludeMask, EntityMask ExcludeMask = INVALID_ENTITY_MASK>
+class EntityView
+{
+    static_assert((IncludeMask & ExcludeMask) == 0, "An EntityView cannot include and exclude the same component");
+public:
+    explicit EntityView(const EntityManager& entityManager) : query_(entityManager.GetQuery(IncludeMask, ExcludeMask))
+    {
+    }
+    /**
+     * \brief GetEntities is a method that returns the sorted list of entities currently in the view.
+     */
+    [[nodiscard]] const std::vector<Entity>& GetEntities() const { return query_.entities; }
+    /**
+     * \brief ForEach is a method that calls func(entity, components...) on every Entity of the view.
+     * \param func is the function called with the Entity and a reference to its Component in each given manager.
+     * \param componentManagers are the ComponentManager or SparseComponentManager whose Component are given to func.
+     * Their Component needs to be part of IncludeMask.
+     */
+    template<typename Func, typename... ComponentManagers>
+    void ForEach(Func func, ComponentManagers&... componentManagers) const
+    {
+        static_assert((((ComponentManagers::componentType & IncludeMask) == ComponentManagers::componentType) && ...),
+            "The components given to an EntityView need to be in its include mask");
+        Iterate(0, [&func, &componentManagers...](Entity entity)
+        {
+            func(entity, componentManagers.GetComponent(entity)...);
+        });
+    }
+    /**
+     * \brief ForEachAfter is a method that calls func(otherEntity) on every Entity of the view greater than entity.
+     * It allows to iterate over each pair of entities of the view once.
+     */
+    template<typename Func>
+    void ForEachAfter(Entity entity, Func func) const
+    {
+        Iterate(GetIndexAfter(entity), func);
+    }
+private:
+    [[nodiscard]] std::size_t GetIndexAfter(Entity entity) const
+    {
+        const auto& entities = query_.entities;
+        return static_cast<std::size_t>(std::distance(entities.begin(),
+            std::upper_bound(entities.begin(), entities.end(), entity)));
+    }
+    template<typename Func>
+    void Iterate(std::size_t index, Func func) const
+    {
+        const auto& entities = query_.entities;
+        auto version = query_.version;
+        while (index < entities.size())
+        {
+            const Entity entity = entities[index];
+            func(entity);
+            if (version != query_.version)
+            {
+                //The view changed during the call, restart after the visited entity
+                index = GetIndexAfter(entity);
+                version = query_.version;
+            }
+            else
+            {
+                index++;
+            }
+        }
+    }
+
+    const EntityQuery& query_;
+};
+} // namespace core
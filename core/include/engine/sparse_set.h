@@ -0,0 +1,53 @@
+#pragma once
+
+#include "engine/entity.h"
+
+#include <limits>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief SparseSet is a class that keeps a dense array of entities sorted by Entity,
+ * and an Entity to dense index array giving a constant time lookup.
+ * It is used by the component managers packing their components in dense arrays.
+ */
+class SparseSet
+{
+public:
+    static constexpr std::size_t INVALID_INDEX = std::numeric_limits<std::size_t>::max();
+
+    SparseSet();
+    [[nodiscard]] bool Contains(Entity entity) const { return entity < indices_.size() && indices_[entity] != INVALID_INDEX; }
+    /**
+     * \brief GetIndex is a method that returns the dense index of an Entity.
+     * \return the dense index of the Entity, or INVALID_INDEX if it is not in the set.
+     */
+    [[nodiscard]] std::size_t GetIndex(Entity entity) const { return Contains(entity) ? indices_[entity] : INVALID_INDEX; }
+    /**
+     * \brief Insert is a method that adds an Entity, keeping the dense array sorted.
+     * \param entity is the Entity to add, it must not be in the set.
+     * \return the dense index where the Entity was inserted, the next entities being shifted by one.
+     */
+    std::size_t Insert(Entity entity);
+    /**
+     * \brief Erase is a method that removes an Entity, keeping the dense array sorted.
+     * \param entity is the Entity to remove, it must be in the set.
+     * \return the dense index that the Entity had, the next entities being shifted back by one.
+     */
+    std::size_t Erase(Entity entity);
+    /**
+     * \brief PushBack is a method that appends an Entity greater than all the others at the end of the dense array.
+     */
+    void PushBack(Entity entity);
+    void Clear();
+    [[nodiscard]] const std::vector<Entity>& GetEntities() const { return entities_; }
+    [[nodiscard]] std::size_t GetSize() const { return entities_.size(); }
+private:
+    void Resize(Entity entity);
+    void UpdateIndices(std::size_t startIndex);
+
+    std::vector<Entity> entities_;
+    std::vector<std::size_t> indices_;
+};
+} // namespace core
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "engine/component.h"
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
@@ -11,16 +13,22 @@ namespace core
 class TransformManager;
 
 /**
- * \brief SpriteManager is a ComponentManager that manages sprites, order by greater entity index, background entity < foreground entity
+ * \brief SpriteBuffer is a list of sprites already placed on the render target, in drawing order.
+ * It can be drawn by another thread than the one updating the SpriteManager.
+ */
+using SpriteBuffer = std::vector<sf::Sprite>;
+
+/**
+ * \brief SpriteManager is a SparseComponentManager that manages sprites, order by greater entity index, background entity < foreground entity
  * Positions are centered at the center of the render target and use pixelPerMeter from globals.h
  */
 class SpriteManager :
-    public ComponentManager<sf::Sprite, static_cast<Component>(ComponentType::SPRITE)>,
+    public SparseComponentManager<sf::Sprite, static_cast<Component>(ComponentType::SPRITE)>,
     public DrawInterface
 {
 public:
     SpriteManager(EntityManager& entityManager, TransformManager& transformManager) :
-        ComponentManager(entityManager),
+        SparseComponentManager(entityManager),
         transformManager_(transformManager)
     {
 
@@ -30,9 +38,19 @@ public:
     void SetCenter(sf::Vector2f center) { center_ = center; }
     void SetWindowSize(sf::Vector2f newWindowSize) { windowSize_ = newWindowSize; }
     void Draw(sf::RenderTarget& window) override;
+    /**
+     * \brief Draw is a method that draws the sprites copied by CopySprites, without reading any component.
+     */
+    static void Draw(sf::RenderTarget& window, const SpriteBuffer& sprites);
+    /**
+     * \brief CopySprites is a method that places the sprites with their transforms and copies them into sprites, replacing its content.
+     */
+    void CopySprites(SpriteBuffer& sprites);
     void SetColor(Entity entity, sf::Color color);
 
 protected:
+    void PlaceSprite(Entity entity, sf::Sprite& sprite) const;
+
     TransformManager& transformManager_;
     sf::Vector2f center_{};
     sf::Vector2f windowSize_{};
@@ -6,6 +6,8 @@
 #include <numbers>
 #include <cmath>
 
+#include "maths/fixed.h"
+
 namespace core
 {
 
@@ -20,13 +22,13 @@ class Radian
 {
 public:
     constexpr Radian() = default;
-    constexpr Radian(float value) : value_(value){}
+    constexpr Radian(Scalar value) : value_(value){}
     /**
      * \brief Conversion constructor that implicitly converts Degree to Radian
      * \param angle is the degree angle to be converted to Radian
      */
     constexpr Radian(const Degree& angle);
-    [[nodiscard]] constexpr float value() const { return value_; }
+    [[nodiscard]] constexpr Scalar value() const { return value_; }
 
     constexpr Radian operator+(Radian angle) const { return { value_ + angle.value() }; }
     constexpr Radian& operator+=(Radian angle)
@@ -40,11 +42,11 @@ public:
         value_ -= angle.value();
         return *this;
     }
-    constexpr Radian operator*(float value) const { return { value_ * value }; }
-    constexpr Radian operator/(float value) const { return { value_ / value }; }
+    constexpr Radian operator*(Scalar value) const { return { value_ * value }; }
+    constexpr Radian operator/(Scalar value) const { return { value_ / value }; }
     constexpr Radian operator-() const { return { -value_ }; }
 private:
-    float value_ = 0.0f;
+    Scalar value_ = 0.0f;
 };
 
 /**
@@ -56,13 +58,13 @@ class Degree
 {
 public:
     constexpr Degree() = default;
-    constexpr Degree(float value) : value_(value){}
+    constexpr Degree(Scalar value) : value_(value){}
     /**
      * \brief Conversion constructor that implicitly converts Radian to Degree
      * \param angle is the radian angle to be converted to Degree 
      */
     constexpr Degree(const Radian& angle) : value_(angle.value()/PI*180.0f){}
-    [[nodiscard]] constexpr float value() const { return value_; }
+    [[nodiscard]] constexpr Scalar value() const { return value_; }
     constexpr Degree operator+(Degree angle) const { return { value_ + angle.value() }; }
     constexpr Degree& operator+=(Degree angle)
     {
@@ -75,14 +77,14 @@ public:
         value_ -= angle.value();
         return *this;
     }
-    constexpr Degree operator*(float value) const { return { value_ * value }; }
-    constexpr Degree operator/(float value) const { return { value_ / value }; }
+    constexpr Degree operator*(Scalar value) const { return { value_ * value }; }
+    constexpr Degree operator/(Scalar value) const { return { value_ / value }; }
     constexpr Degree operator-() const { return { -value_ }; }
 private:
-    float value_ = 0.0f;
+    Scalar value_ = 0.0f;
 };
 
-constexpr Degree operator*(float value, Degree angle) { return angle.value() * value; }
+constexpr Degree operator*(Scalar value, Degree angle) { return angle.value() * value; }
 
 
 constexpr Radian::Radian(const Degree& angle)
@@ -97,7 +99,7 @@ constexpr Radian::Radian(const Degree& angle)
  */
 inline float Sin(Radian angle)
 {
-    return std::sin(angle.value());
+    return std::sin(ToFloat(angle.value()));
 }
 
 /**
@@ -107,7 +109,7 @@ inline float Sin(Radian angle)
  */
 inline float Cos(Radian angle)
 {
-    return std::cos(angle.value());
+    return std::cos(ToFloat(angle.value()));
 }
 
 /**
@@ -117,7 +119,7 @@ inline float Cos(Radian angle)
  */
 inline float Tan(Radian angle)
 {
-    return std::tan(angle.value());
+    return std::tan(ToFloat(angle.value()));
 }
 
 /**
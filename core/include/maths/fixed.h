@@ -0,0 +1,99 @@
+/**
+ * \file fixed.h
+ */
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <type_traits>
+
+namespace core
+{
+/**
+ * \brief Fixed is a utility class that describes a signed fixed-point number with 16 fractional bits in a 64-bit integer.
+ * All its operations are integer operations, giving the same results on every compiler and instruction set,
+ * whatever the optimization or floating-point flags.
+ * It is implicitly constructed from arithmetic values and needs to be explicitly converted back to float.
+ */
+class Fixed
+{
+public:
+    using Raw = std::int64_t;
+    static constexpr int fractionalBits = 16;
+    static constexpr Raw one = Raw{ 1 } << fractionalBits;
+
+    constexpr Fixed() = default;
+    /**
+     * \brief Conversion constructor from integers and floating-point values, rounding to the nearest fixed-point value.
+     */
+    template<typename T> requires std::is_arithmetic_v<T>
+    constexpr Fixed(T value) : raw_(FromArithmetic(value)){}
+    /**
+     * \brief FromRaw is a function that creates a Fixed from its underlying integer.
+     */
+    [[nodiscard]] static constexpr Fixed FromRaw(Raw raw)
+    {
+        Fixed fixed;
+        fixed.raw_ = raw;
+        return fixed;
+    }
+    [[nodiscard]] constexpr Raw GetRaw() const { return raw_; }
+    [[nodiscard]] explicit constexpr operator float() const { return static_cast<float>(static_cast<double>(raw_) / one); }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw(a.raw_ + b.raw_); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw(a.raw_ - b.raw_); }
+    //Products and quotients round toward negative infinity, the arithmetic shift being defined since C++20
+    friend constexpr Fixed operator*(Fixed a, Fixed b) { return FromRaw((a.raw_ * b.raw_) >> fractionalBits); }
+    friend constexpr Fixed operator/(Fixed a, Fixed b) { return FromRaw(a.raw_ * one / b.raw_); }
+    friend constexpr bool operator==(Fixed a, Fixed b) = default;
+    friend constexpr std::strong_ordering operator<=>(Fixed a, Fixed b) = default;
+    constexpr Fixed operator-() const { return FromRaw(-raw_); }
+    constexpr Fixed& operator+=(Fixed value)
+    {
+        raw_ += value.raw_;
+        return *this;
+    }
+    constexpr Fixed& operator-=(Fixed value)
+    {
+        raw_ -= value.raw_;
+        return *this;
+    }
+    constexpr Fixed& operator*=(Fixed value) { return *this = *this * value; }
+    constexpr Fixed& operator/=(Fixed value) { return *this = *this / value; }
+private:
+    template<typename T>
+    static constexpr Raw FromArithmetic(T value)
+    {
+        if constexpr (std::is_integral_v<T>)
+        {
+            return static_cast<Raw>(value) * one;
+        }
+        else
+        {
+            const auto scaled = static_cast<double>(value) * static_cast<double>(one);
+            return static_cast<Raw>(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5);
+        }
+    }
+
+    Raw raw_ = 0;
+};
+
+/**
+ * \brief Scalar is the type of the simulation values (core::Vec2f, core::Degree and the game constants).
+ * It is core::Fixed when compiled with GPR_FIXED_POINT (ENABLE_FIXED_POINT CMake option), such that the server and clients
+ * compute the exact same world on any compiler and instruction set, and float otherwise.
+ */
+#ifdef GPR_FIXED_POINT
+using Scalar = Fixed;
+#else
+using Scalar = float;
+#endif
+
+/**
+ * \brief ToFloat is a function that converts a Scalar to float, for the graphics and the other non-simulated parts.
+ */
+constexpr float ToFloat(Scalar value)
+{
+    return static_cast<float>(value);
+}
+}
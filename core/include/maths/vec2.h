@@ -2,40 +2,42 @@
 
 #include <SFML/System/Vector2.hpp>
 #include <maths/angle.h>
+#include <maths/fixed.h>
 
 namespace core
 {
 /**
  * \brief Vec2f is a utility class that represents a mathematical 2d vector.
+ * Its coordinates are core::Scalar, fixed-point numbers when compiled with GPR_FIXED_POINT.
  */
 struct Vec2f
 {
-    float x = 0.0f, y = 0.0f;
+    Scalar x = 0.0f, y = 0.0f;
 
     constexpr Vec2f() = default;
-    constexpr Vec2f(float newX, float newY) : x(newX), y(newY)
+    constexpr Vec2f(Scalar newX, Scalar newY) : x(newX), y(newY)
     {
 
     }
     Vec2f(sf::Vector2f v);
 
 
-    [[nodiscard]] float GetMagnitude() const;
+    [[nodiscard]] Scalar GetMagnitude() const;
     void Normalize();
     [[nodiscard]] Vec2f GetNormalized() const;
-    [[nodiscard]] float GetSqrMagnitude() const;
+    [[nodiscard]] Scalar GetSqrMagnitude() const;
     [[nodiscard]] Vec2f Rotate(Degree rotation) const;
-    static float Dot(Vec2f a, Vec2f b);
-    static Vec2f Lerp(Vec2f a, Vec2f b, float t);
+    static Scalar Dot(Vec2f a, Vec2f b);
+    static Vec2f Lerp(Vec2f a, Vec2f b, Scalar t);
 
-    [[nodiscard]] operator sf::Vector2f() const { return { x, y }; }
+    [[nodiscard]] operator sf::Vector2f() const { return { ToFloat(x), ToFloat(y) }; }
 
     Vec2f operator+(Vec2f v) const;
     Vec2f& operator+=(Vec2f v);
     Vec2f operator-(Vec2f v) const;
     Vec2f& operator-=(Vec2f v);
-    Vec2f operator*(float f) const;
-    Vec2f operator/(float f) const;
+    Vec2f operator*(Scalar f) const;
+    Vec2f operator/(Scalar f) const;
 
     static constexpr Vec2f zero() { return {}; }
     static constexpr Vec2f one() { return {1,1}; }
@@ -45,6 +47,6 @@ struct Vec2f
     static constexpr Vec2f right() { return {1,0}; }
 };
 
-Vec2f operator*(float f, Vec2f v);
+Vec2f operator*(Scalar f, Vec2f v);
 
 }
\ No newline at end of file
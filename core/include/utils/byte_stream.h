@@ -0,0 +1,143 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace core
+{
+/**
+ * \brief ByteWriter is a class that writes values in little-endian order at the end of a fixed-size byte buffer.
+ * The buffer is given by the caller and never grows, a write past its end marks the writer invalid instead.
+ */
+class ByteWriter
+{
+public:
+    explicit ByteWriter(std::span<std::uint8_t> buffer) : buffer_(buffer)
+    {
+    }
+    /**
+     * \brief Write is a method that writes an integer, an enum, a bool or a float in little-endian order,
+     * whatever the endianness of the machine.
+     */
+    template<typename T>
+    void Write(T value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            Write(static_cast<std::underlying_type_t<T>>(value));
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            Write(static_cast<std::uint8_t>(value ? 1 : 0));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 32-bit and 64-bit floats are written");
+            using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            Write(std::bit_cast<Bits>(value));
+        }
+        else
+        {
+            static_assert(std::is_integral_v<T>, "Only arithmetic and enum values are written");
+            if (size_ + sizeof(T) > buffer_.size())
+            {
+                isValid_ = false;
+                return;
+            }
+            auto bits = static_cast<std::make_unsigned_t<T>>(value);
+            for (std::size_t i = 0; i < sizeof(T); i++)
+            {
+                buffer_[size_++] = static_cast<std::uint8_t>(bits & 0xFFu);
+                bits = static_cast<std::make_unsigned_t<T>>(bits >> 8u);
+            }
+        }
+    }
+    /**
+     * \brief GetSize is a method that gives the number of bytes written.
+     */
+    [[nodiscard]] std::size_t GetSize() const { return size_; }
+    /**
+     * \brief IsValid is a method that returns false when a value did not fit in the buffer.
+     */
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+private:
+    std::span<std::uint8_t> buffer_;
+    std::size_t size_ = 0;
+    bool isValid_ = true;
+};
+
+/**
+ * \brief ByteReader is a class that reads in place the little-endian values written by a ByteWriter.
+ * Reading past the end of the data gives zero values and marks the reader invalid.
+ */
+class ByteReader
+{
+public:
+    explicit ByteReader(std::span<const std::uint8_t> data) : data_(data)
+    {
+    }
+    /**
+     * \brief Read is a method that reads an integer, an enum, a bool or a float written in little-endian order.
+     */
+    template<typename T>
+    void Read(T& value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            std::underlying_type_t<T> underlying{};
+            Read(underlying);
+            value = static_cast<T>(underlying);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            std::uint8_t byte = 0;
+            Read(byte);
+            value = byte != 0;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 32-bit and 64-bit floats are read");
+            using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            Bits bits = 0;
+            Read(bits);
+            value = std::bit_cast<T>(bits);
+        }
+        else
+        {
+            static_assert(std::is_integral_v<T>, "Only arithmetic and enum values are read");
+            if (position_ + sizeof(T) > data_.size())
+            {
+                isValid_ = false;
+                value = T{};
+                return;
+            }
+            std::make_unsigned_t<T> bits = 0;
+            for (std::size_t i = 0; i < sizeof(T); i++)
+            {
+                bits = static_cast<std::make_unsigned_t<T>>(bits | static_cast<std::make_unsigned_t<T>>(data_[position_++]) << (8u * i));
+            }
+            value = static_cast<T>(bits);
+        }
+    }
+    /**
+     * \brief GetRemainingSize is a method that gives the number of bytes not read yet.
+     */
+    [[nodiscard]] std::size_t GetRemainingSize() const { return data_.size() - position_; }
+    /**
+     * \brief IsValid is a method that returns false when a value was read past the end of the data,
+     * or when the data was invalidated by the caller.
+     */
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+    /**
+     * \brief Invalidate is a method that marks the data invalid when the read values are not coherent.
+     */
+    void Invalidate() { isValid_ = false; }
+private:
+    std::span<const std::uint8_t> data_;
+    std::size_t position_ = 0;
+    bool isValid_ = true;
+};
+} // namespace core
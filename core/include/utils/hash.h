@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace core
+{
+/**
+ * \brief Hasher is a utility class that computes a 64-bit xxHash (XXH64) of the data given in several calls.
+ * Its main loop mixes four independent 64-bit lanes per 32-byte stripe, which the compiler pipelines like SIMD lanes.
+ * The hash is computed from the bytes in memory, so the given values must not contain any padding bytes.
+ */
+class Hasher
+{
+public:
+    explicit Hasher(std::uint64_t seed = 0);
+    /**
+     * \brief Update is a method that adds size bytes to the hash.
+     */
+    void Update(const void* data, std::size_t size);
+    /**
+     * \brief Update is a method that adds the bytes of a value without padding to the hash.
+     */
+    template<typename T>
+    void Update(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Hashed values are read as bytes");
+        Update(&value, sizeof(T));
+    }
+    /**
+     * \brief UpdateArray is a method that adds count contiguous values without padding to the hash.
+     */
+    template<typename T>
+    void UpdateArray(const T* values, std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Hashed values are read as bytes");
+        Update(values, count * sizeof(T));
+    }
+    /**
+     * \brief Digest is a method that returns the hash of all the data given since the construction.
+     */
+    [[nodiscard]] std::uint64_t Digest() const;
+private:
+    static constexpr std::size_t stripeSize = 32;
+    std::uint64_t seed_ = 0;
+    std::uint64_t totalSize_ = 0;
+    std::array<std::uint64_t, 4> lanes_{};
+    std::array<std::byte, stripeSize> buffer_{};
+    std::size_t bufferSize_ = 0;
+};
+} // namespace core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace core
+{
+/**
+ * \brief SpscQueue is a lock-free single producer single consumer FIFO queue of at most Capacity values of T.
+ * The producer pushes copies of the values and the consumer pops them in the same order, none of them ever waits for the other.
+ * T values are stored in a fixed ring buffer, such that pushing never allocates.
+ */
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity needs to be a power of two");
+public:
+    /**
+     * \brief TryPush is a method called only by the producer thread that copies the value at the back of the queue.
+     * \return false when the queue is full, the value is then not pushed
+     */
+    bool TryPush(const T& value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        buffer_[tail & indexMask] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    /**
+     * \brief Front is a method called only by the consumer thread that gives the oldest value of the queue, nullptr when it is empty.
+     * The value stays valid until it is popped.
+     */
+    [[nodiscard]] T* Front()
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &buffer_[head & indexMask];
+    }
+    /**
+     * \brief Pop is a method called only by the consumer thread that removes the value given by Front.
+     */
+    void Pop()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+private:
+    static constexpr std::size_t indexMask = Capacity - 1;
+
+    std::array<T, Capacity> buffer_{};
+    alignas(64) std::atomic<std::size_t> head_{ 0 };
+    alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+} // namespace core
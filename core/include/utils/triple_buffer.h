@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace core
+{
+/**
+ * \brief TripleBuffer is a lock-free single producer single consumer buffer that passes the latest value of T from one thread to another.
+ * The writer fills the write buffer and publishes it, while the reader acquires the last published buffer without ever waiting for the writer.
+ * The third buffer in the middle is exchanged atomically between both sides, so the values published between two acquisitions are skipped.
+ * T values are reused from one publication to the next, such that their allocations are kept.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * \brief GetWriteBuffer is a method called only by the writer thread that gives the buffer to fill before publishing it.
+     * It contains an older published value.
+     */
+    [[nodiscard]] T& GetWriteBuffer() { return buffers_[writeIndex_]; }
+    /**
+     * \brief Publish is a method called only by the writer thread that makes the write buffer the next one acquired by the reader.
+     */
+    void Publish()
+    {
+        writeIndex_ = middle_.exchange(static_cast<std::uint8_t>(writeIndex_ | freshFlag), std::memory_order_acq_rel) & indexMask;
+    }
+    /**
+     * \brief Acquire is a method called only by the reader thread that gives the last published buffer.
+     * The buffer stays valid until the next call to Acquire, and is default constructed if nothing was published yet.
+     */
+    [[nodiscard]] const T& Acquire()
+    {
+        if (middle_.load(std::memory_order_relaxed) & freshFlag)
+        {
+            readIndex_ = middle_.exchange(readIndex_, std::memory_order_acq_rel) & indexMask;
+        }
+        return buffers_[readIndex_];
+    }
+    /**
+     * \brief HasNewBuffer is a method that returns true when a buffer was published since the last call to Acquire.
+     */
+    [[nodiscard]] bool HasNewBuffer() const
+    {
+        return middle_.load(std::memory_order_relaxed) & freshFlag;
+    }
+private:
+    static constexpr std::uint8_t indexMask = 0b11;
+    static constexpr std::uint8_t freshFlag = 0b100;
+
+    std::array<T, 3> buffers_{};
+    std::uint8_t writeIndex_ = 0;
+    std::atomic<std::uint8_t> middle_{ 1 };
+    std::uint8_t readIndex_ = 2;
+};
+} // namespace core
@@ -0,0 +1,121 @@
+#include "engine/arena.h"
+#include "utils/assert.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace core
+{
+std::size_t ArenaLayout::ComputeOffsets(std::size_t capacity, std::vector<std::size_t>& offsets) const
+{
+    offsets.resize(arrays_.size());
+    std::size_t offset = 0;
+    for (std::size_t array = 0; array < arrays_.size(); array++)
+    {
+        const auto alignment = arrays_[array].alignment;
+        offset = (offset + alignment - 1) / alignment * alignment;
+        offsets[array] = offset;
+        offset += GetArraySize(array, capacity);
+    }
+    return offset;
+}
+
+std::size_t ArenaLayout::GetArraySize(ArenaArray array, std::size_t capacity) const
+{
+    const auto& arrayInfo = arrays_[array];
+    return arrayInfo.elementSize * (arrayInfo.isPerEntity ? capacity : 1);
+}
+
+Arena::Arena(const ArenaLayout& layout, std::size_t capacity) : layout_(&layout), capacity_(capacity)
+{
+    byteSize_ = layout_->ComputeOffsets(capacity_, offsets_);
+    data_ = std::make_unique<std::byte[]>(byteSize_);
+}
+
+void Arena::CopyFrom(const Arena& arena)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    gpr_assert((layout_ == arena.layout_ || *layout_ == *arena.layout_) && capacity_ == arena.capacity_,
+        "Arenas need the same layout and capacity to be copied");
+    std::memcpy(data_.get(), arena.data_.get(), byteSize_);
+}
+
+void Arena::Reserve(std::size_t capacity)
+{
+    if (capacity <= capacity_)
+        return;
+    std::vector<std::size_t> offsets;
+    const auto byteSize = layout_->ComputeOffsets(capacity, offsets);
+    auto data = std::make_unique<std::byte[]>(byteSize);
+    for (ArenaArray array = 0; array < offsets.size(); array++)
+    {
+        std::memcpy(data.get() + offsets[array], data_.get() + offsets_[array], layout_->GetArraySize(array, capacity_));
+    }
+    capacity_ = capacity;
+    byteSize_ = byteSize;
+    offsets_ = std::move(offsets);
+    data_ = std::move(data);
+}
+
+ArenaSparseSet::ArenaSparseSet(ArenaLayout& layout) :
+    size_(layout.AddValue<std::uint32_t>()),
+    entities_(layout.AddArray<Entity>()),
+    indices_(layout.AddArray<std::uint32_t>())
+{
+}
+
+std::size_t ArenaSparseSet::Insert(Arena& arena, Entity entity) const
+{
+    gpr_assert(entity < arena.GetCapacity(), "Arena needs to be reserved before adding the Entity");
+    gpr_assert(!Contains(arena, entity), "Entity is already in the sparse set");
+    auto& size = *arena.Get<std::uint32_t>(size_);
+    auto* entities = arena.Get<Entity>(entities_);
+    const auto index = static_cast<std::size_t>(std::lower_bound(entities, entities + size, entity) - entities);
+    const auto movedNmb = size - index;
+    std::memmove(entities + index + 1, entities + index, movedNmb * sizeof(Entity));
+    entities[index] = entity;
+    for (const auto& [array, elementSize] : componentArrays_)
+    {
+        auto* components = arena.Get<std::byte>(array);
+        std::memmove(components + (index + 1) * elementSize, components + index * elementSize, movedNmb * elementSize);
+    }
+    size++;
+    UpdateIndices(arena, index);
+    return index;
+}
+
+void ArenaSparseSet::Erase(Arena& arena, Entity entity) const
+{
+    gpr_assert(Contains(arena, entity), "Entity is not in the sparse set");
+    auto& size = *arena.Get<std::uint32_t>(size_);
+    auto* entities = arena.Get<Entity>(entities_);
+    const auto index = GetIndex(arena, entity);
+    const auto movedNmb = size - index - 1;
+    std::memmove(entities + index, entities + index + 1, movedNmb * sizeof(Entity));
+    for (const auto& [array, elementSize] : componentArrays_)
+    {
+        auto* components = arena.Get<std::byte>(array);
+        std::memmove(components + index * elementSize, components + (index + 1) * elementSize, movedNmb * elementSize);
+    }
+    size--;
+    arena.Get<std::uint32_t>(indices_)[entity] = 0;
+    UpdateIndices(arena, index);
+}
+
+void ArenaSparseSet::UpdateIndices(Arena& arena, std::size_t startIndex) const
+{
+    const auto size = GetSize(arena);
+    const auto* entities = arena.Get<Entity>(entities_);
+    auto* indices = arena.Get<std::uint32_t>(indices_);
+    for (std::size_t i = startIndex; i < size; i++)
+    {
+        indices[entities[i]] = static_cast<std::uint32_t>(i + 1);
+    }
+}
+} // namespace core
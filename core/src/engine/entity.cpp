@@ -3,40 +3,63 @@
 #include "utils/assert.h"
 
 #include <algorithm>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GPR_ENTITY_SSE2 1
+#include <emmintrin.h>
+#endif
 
 namespace core
 {
+namespace
+{
+constexpr std::size_t bitsPerWord = 64;
+
+#if defined(__AVX2__) || defined(GPR_ENTITY_SSE2)
+/**
+ * \brief AddMatchingEntities adds the entities whose lane is set in matchBits, the movemask of a SIMD mask comparison.
+ */
+void AddMatchingEntities(std::vector<Entity>& entities, std::size_t firstEntity, unsigned matchBits)
+{
+    while (matchBits != 0)
+    {
+        entities.push_back(static_cast<Entity>(firstEntity + static_cast<std::size_t>(std::countr_zero(matchBits))));
+        matchBits &= matchBits - 1;
+    }
+}
+#endif
+}
+
 EntityManager::EntityManager()
 {
-    entityMasks_.resize(entityInitNmb, INVALID_ENTITY_MASK);
+    ResizeEntities(entityInitNmb);
 }
 
 EntityManager::EntityManager(std::size_t reservedSize)
 {
-    entityMasks_.resize(reservedSize, INVALID_ENTITY_MASK);
+    ResizeEntities(reservedSize);
 }
 
 Entity EntityManager::CreateEntity()
 {
-    const auto entityMaskIt = std::find_if(entityMasks_.begin(), entityMasks_.end(),
-        [](EntityMask entityMask)
-        {
-            return entityMask == INVALID_ENTITY_MASK;
-        });
-
-    if (entityMaskIt == entityMasks_.end())
+    //Look for the first free entity, skipping the words without any free bit
+    for (; firstFreeWord_ < freeEntities_.size(); firstFreeWord_++)
     {
-        const auto newEntity = entityMasks_.size();
-        entityMasks_.resize(newEntity + newEntity / 2, INVALID_ENTITY_MASK);
-        AddComponent(
-            static_cast<Entity>(newEntity),
-            static_cast<EntityMask>(ComponentType::EMPTY));
-        return static_cast<Entity>(newEntity);
+        const auto freeWord = freeEntities_[firstFreeWord_];
+        if (freeWord == 0)
+            continue;
+        const auto newEntity = static_cast<Entity>(firstFreeWord_ * bitsPerWord + std::countr_zero(freeWord));
+        AddComponent(newEntity, static_cast<EntityMask>(ComponentType::EMPTY));
+        return newEntity;
     }
-    
-    const auto newEntity = std::distance(entityMasks_.begin(), entityMaskIt);
+
+    const auto newEntity = entityMasks_.size();
+    ResizeEntities(std::max<std::size_t>(newEntity + newEntity / 2, 2));
     AddComponent(
-        static_cast<Entity>(newEntity), 
+        static_cast<Entity>(newEntity),
         static_cast<EntityMask>(ComponentType::EMPTY));
     return static_cast<Entity>(newEntity);
 }
@@ -44,19 +67,19 @@ Entity EntityManager::CreateEntity()
 void EntityManager::DestroyEntity(Entity entity)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
-    entityMasks_[entity] = INVALID_ENTITY_MASK;
+    SetEntityMask(entity, INVALID_ENTITY_MASK);
 }
 
 void EntityManager::AddComponent(Entity entity, EntityMask mask)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
-    entityMasks_[entity] |= mask;
+    SetEntityMask(entity, entityMasks_[entity] | mask);
 }
 
 void EntityManager::RemoveComponent(Entity entity, EntityMask mask)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
-    entityMasks_[entity] &= ~mask;
+    SetEntityMask(entity, entityMasks_[entity] & ~mask);
 
 }
 
@@ -71,6 +94,150 @@ std::size_t EntityManager::GetEntitiesSize() const
     return entityMasks_.size();
 }
 
+EntityGeneration EntityManager::GetGeneration(Entity entity) const
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    return generations_[entity];
+}
+
+const EntityQuery& EntityManager::GetQuery(EntityMask includeMask, EntityMask excludeMask) const
+{
+    const auto queryIt = std::find_if(queries_.begin(), queries_.end(),
+        [includeMask, excludeMask](const EntityQuery& query)
+        {
+            return query.includeMask == includeMask && query.excludeMask == excludeMask;
+        });
+    if (queryIt != queries_.end())
+    {
+        return *queryIt;
+    }
+    auto& query = queries_.emplace_back();
+    query.includeMask = includeMask;
+    query.excludeMask = excludeMask;
+    FindEntities(includeMask, excludeMask, query.entities);
+    return query;
+}
+
+void EntityManager::CopyFrom(const EntityManager& entityManager)
+{
+    if (&entityManager == this)
+        return;
+    entityMasks_.assign(entityManager.entityMasks_.begin(), entityManager.entityMasks_.end());
+    generations_.assign(entityManager.generations_.begin(), entityManager.generations_.end());
+    freeEntities_.assign(entityManager.freeEntities_.begin(), entityManager.freeEntities_.end());
+    firstFreeWord_ = entityManager.firstFreeWord_;
+    for (auto& query : queries_)
+    {
+        FindEntities(query.includeMask, query.excludeMask, query.entities);
+        query.version++;
+    }
+}
+
+void EntityManager::FindEntities(EntityMask includeMask, EntityMask excludeMask, std::vector<Entity>& entities) const
+{
+    entities.clear();
+    const auto size = entityMasks_.size();
+    const auto* masks = entityMasks_.data();
+    std::size_t entity = 0;
+    //A lane matches when its mask is not empty, has all of includeMask and nothing of excludeMask
+#if defined(__AVX2__)
+    const auto include = _mm256_set1_epi32(static_cast<int>(includeMask));
+    const auto exclude = _mm256_set1_epi32(static_cast<int>(excludeMask));
+    const auto zero = _mm256_setzero_si256();
+    for (; entity + 8 <= size; entity += 8)
+    {
+        const auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + entity));
+        const auto hasInclude = _mm256_cmpeq_epi32(_mm256_and_si256(mask, include), include);
+        const auto hasNoExclude = _mm256_cmpeq_epi32(_mm256_and_si256(mask, exclude), zero);
+        const auto isEmpty = _mm256_cmpeq_epi32(mask, zero);
+        const auto match = _mm256_andnot_si256(isEmpty, _mm256_and_si256(hasInclude, hasNoExclude));
+        AddMatchingEntities(entities, entity, static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(match))));
+    }
+#elif defined(GPR_ENTITY_SSE2)
+    const auto include = _mm_set1_epi32(static_cast<int>(includeMask));
+    const auto exclude = _mm_set1_epi32(static_cast<int>(excludeMask));
+    const auto zero = _mm_setzero_si128();
+    for (; entity + 4 <= size; entity += 4)
+    {
+        const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + entity));
+        const auto hasInclude = _mm_cmpeq_epi32(_mm_and_si128(mask, include), include);
+        const auto hasNoExclude = _mm_cmpeq_epi32(_mm_and_si128(mask, exclude), zero);
+        const auto isEmpty = _mm_cmpeq_epi32(mask, zero);
+        const auto match = _mm_andnot_si128(isEmpty, _mm_and_si128(hasInclude, hasNoExclude));
+        AddMatchingEntities(entities, entity, static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(match))));
+    }
+#endif
+    //Scalar fallback and remaining masks
+    for (; entity < size; entity++)
+    {
+        const auto mask = masks[entity];
+        if (mask != INVALID_ENTITY_MASK && (mask & includeMask) == includeMask && (mask & excludeMask) == 0)
+        {
+            entities.push_back(static_cast<Entity>(entity));
+        }
+    }
+}
+
+void EntityManager::SetEntityMask(Entity entity, EntityMask newMask)
+{
+    const auto oldMask = entityMasks_[entity];
+    entityMasks_[entity] = newMask;
+    if (oldMask == INVALID_ENTITY_MASK && newMask != INVALID_ENTITY_MASK)
+    {
+        SetEntityFree(entity, false);
+    }
+    else if (oldMask != INVALID_ENTITY_MASK && newMask == INVALID_ENTITY_MASK)
+    {
+        SetEntityFree(entity, true);
+        generations_[entity]++;
+    }
+    for (auto& query : queries_)
+    {
+        const bool wasMatching = query.Matches(oldMask);
+        const bool isMatching = query.Matches(newMask);
+        if (wasMatching == isMatching)
+            continue;
+        //Entities are kept sorted to iterate in the same order as a scan of the EntityMask array
+        const auto it = std::lower_bound(query.entities.begin(), query.entities.end(), entity);
+        if (isMatching)
+        {
+            query.entities.insert(it, entity);
+        }
+        else
+        {
+            query.entities.erase(it);
+        }
+        query.version++;
+    }
+}
+
+void EntityManager::ResizeEntities(std::size_t newSize)
+{
+    const auto oldSize = entityMasks_.size();
+    entityMasks_.resize(newSize, INVALID_ENTITY_MASK);
+    generations_.resize(newSize, 0);
+    freeEntities_.resize((newSize + bitsPerWord - 1) / bitsPerWord, 0);
+    for (auto entity = oldSize; entity < newSize; entity++)
+    {
+        SetEntityFree(static_cast<Entity>(entity), true);
+    }
+}
+
+void EntityManager::SetEntityFree(Entity entity, bool isFree)
+{
+    const auto word = entity / bitsPerWord;
+    const auto bit = std::uint64_t{ 1 } << (entity % bitsPerWord);
+    if (isFree)
+    {
+        freeEntities_[word] |= bit;
+        firstFreeWord_ = std::min(firstFreeWord_, word);
+    }
+    else
+    {
+        freeEntities_[word] &= ~bit;
+    }
+}
+
 bool EntityManager::HasComponent(Entity entity, EntityMask mask) const
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
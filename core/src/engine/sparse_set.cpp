@@ -0,0 +1,73 @@
+#include "engine/sparse_set.h"
+#include "engine/globals.h"
+#include "utils/assert.h"
+
+#include <algorithm>
+
+namespace core
+{
+SparseSet::SparseSet()
+{
+    indices_.resize(entityInitNmb, INVALID_INDEX);
+}
+
+std::size_t SparseSet::Insert(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_assert(!Contains(entity), "Entity is already in the sparse set");
+    Resize(entity);
+    const auto it = std::lower_bound(entities_.begin(), entities_.end(), entity);
+    const auto index = static_cast<std::size_t>(std::distance(entities_.begin(), it));
+    entities_.insert(it, entity);
+    UpdateIndices(index);
+    return index;
+}
+
+std::size_t SparseSet::Erase(Entity entity)
+{
+    gpr_assert(Contains(entity), "Entity is not in the sparse set");
+    const auto index = indices_[entity];
+    entities_.erase(entities_.begin() + static_cast<std::ptrdiff_t>(index));
+    indices_[entity] = INVALID_INDEX;
+    UpdateIndices(index);
+    return index;
+}
+
+void SparseSet::PushBack(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_assert(entities_.empty() || entities_.back() < entity, "Entities need to be pushed in ascending order");
+    Resize(entity);
+    indices_[entity] = entities_.size();
+    entities_.push_back(entity);
+}
+
+void SparseSet::Clear()
+{
+    for (const auto entity : entities_)
+    {
+        indices_[entity] = INVALID_INDEX;
+    }
+    entities_.clear();
+}
+
+void SparseSet::Resize(Entity entity)
+{
+    if (entity < indices_.size())
+        return;
+    auto newSize = std::max<std::size_t>(indices_.size(), 2);
+    while (entity >= newSize)
+    {
+        newSize = newSize + newSize / 2;
+    }
+    indices_.resize(newSize, INVALID_INDEX);
+}
+
+void SparseSet::UpdateIndices(std::size_t startIndex)
+{
+    for (std::size_t i = startIndex; i < entities_.size(); i++)
+    {
+        indices_[entities_[i]] = i;
+    }
+}
+} // namespace core
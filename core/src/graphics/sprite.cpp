@@ -5,44 +5,64 @@ namespace core
 {
 void SpriteManager::SetOrigin(Entity entity, sf::Vector2f origin)
 {
-    components_[entity].setOrigin(origin);
+    GetComponent(entity).setOrigin(origin);
 }
 
 void SpriteManager::SetTexture(Entity entity, const sf::Texture& texture)
 {
-    components_[entity].setTexture(texture);
+    GetComponent(entity).setTexture(texture);
 }
 
 void SpriteManager::Draw(sf::RenderTarget& window)
 {
-    for (Entity entity = 0; entity < components_.size(); entity++)
+    ForEach([this, &window](Entity entity, sf::Sprite& sprite)
     {
-        if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SPRITE)))
-        {
-            if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::POSITION)))
-            {
-                const auto position = transformManager_.GetPosition(entity);
-                components_[entity].setPosition(
-                    position.x * pixelPerMeter + center_.x,
-                    windowSize_.y - (position.y * pixelPerMeter + center_.y));
-            }
-            if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SCALE)))
-            {
-                const auto scale = transformManager_.GetScale(entity);
-                components_[entity].setScale(scale);
-            }
-            if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::ROTATION)))
-            {
-                const auto rotation = transformManager_.GetRotation(entity);
-                components_[entity].setRotation(rotation.value());
-            }
-            window.draw(components_[entity]);
-        }
+        PlaceSprite(entity, sprite);
+        window.draw(sprite);
+    });
+}
+
+void SpriteManager::Draw(sf::RenderTarget& window, const SpriteBuffer& sprites)
+{
+    for (const auto& sprite : sprites)
+    {
+        window.draw(sprite);
+    }
+}
+
+void SpriteManager::CopySprites(SpriteBuffer& sprites)
+{
+    sprites.clear();
+    ForEach([this, &sprites](Entity entity, sf::Sprite& sprite)
+    {
+        PlaceSprite(entity, sprite);
+        sprites.push_back(sprite);
+    });
+}
+
+void SpriteManager::PlaceSprite(Entity entity, sf::Sprite& sprite) const
+{
+    if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::POSITION)))
+    {
+        const sf::Vector2f position = transformManager_.GetPosition(entity);
+        sprite.setPosition(
+            position.x * pixelPerMeter + center_.x,
+            windowSize_.y - (position.y * pixelPerMeter + center_.y));
+    }
+    if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SCALE)))
+    {
+        const auto scale = transformManager_.GetScale(entity);
+        sprite.setScale(scale);
+    }
+    if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::ROTATION)))
+    {
+        const auto rotation = transformManager_.GetRotation(entity);
+        sprite.setRotation(ToFloat(rotation.value()));
     }
 }
 
 void SpriteManager::SetColor(Entity entity, sf::Color color)
 {
-    components_[entity].setColor(color);
+    GetComponent(entity).setColor(color);
 }
 } // namespace core
@@ -32,24 +32,50 @@ Vec2f& Vec2f::operator-=(Vec2f v)
     return *this;
 }
 
-Vec2f Vec2f::operator*(float f) const
+Vec2f Vec2f::operator*(Scalar f) const
 {
     return {x * f, y * f};
 }
 
-Vec2f Vec2f::operator/(float f) const
+Vec2f Vec2f::operator/(Scalar f) const
 {
     return {x / f, y / f};
 }
 
-Vec2f operator*(float f, Vec2f v)
+Vec2f operator*(Scalar f, Vec2f v)
 {
     return v*f;
 }
 
-float Vec2f::GetMagnitude() const
-{
+Scalar Vec2f::GetMagnitude() const
+{
+#ifdef GPR_FIXED_POINT
+    //Integer square root of the raw value shifted once more, to keep the result in the fixed-point format
+    const auto sqrMagnitude = static_cast<std::uint64_t>(GetSqrMagnitude().GetRaw()) << Fixed::fractionalBits;
+    std::uint64_t root = 0;
+    std::uint64_t bit = std::uint64_t{ 1 } << 62;
+    std::uint64_t remainder = sqrMagnitude;
+    while (bit > remainder)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (remainder >= root + bit)
+        {
+            remainder -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return Fixed::FromRaw(static_cast<Fixed::Raw>(root));
+#else
     return std::sqrt(GetSqrMagnitude());
+#endif
 }
 
 void Vec2f::Normalize()
@@ -65,7 +91,7 @@ Vec2f Vec2f::GetNormalized() const
     return (*this) / magnitude;
 }
 
-float Vec2f::GetSqrMagnitude() const
+Scalar Vec2f::GetSqrMagnitude() const
 {
     return x * x + y * y;
 }
@@ -82,12 +108,12 @@ Vec2f Vec2f::Rotate(Degree rotation) const
     return v;
 }
 
-float Vec2f::Dot(Vec2f a, Vec2f b)
+Scalar Vec2f::Dot(Vec2f a, Vec2f b)
 {
     return a.x * b.x + a.y * b.y;
 }
 
-Vec2f Vec2f::Lerp(Vec2f a, Vec2f b, float t)
+Vec2f Vec2f::Lerp(Vec2f a, Vec2f b, Scalar t)
 {
     return a + (b - a) * t;
 }
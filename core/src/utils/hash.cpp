@@ -0,0 +1,141 @@
+#include "utils/hash.h"
+
+#include <cstring>
+
+namespace core
+{
+namespace
+{
+constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+constexpr std::uint64_t RotateLeft(std::uint64_t value, int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+std::uint64_t Read64(const std::byte* data)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint32_t Read32(const std::byte* data)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+constexpr std::uint64_t Round(std::uint64_t lane, std::uint64_t input)
+{
+    lane += input * prime2;
+    lane = RotateLeft(lane, 31);
+    return lane * prime1;
+}
+
+constexpr std::uint64_t MergeRound(std::uint64_t hash, std::uint64_t lane)
+{
+    hash ^= Round(0, lane);
+    return hash * prime1 + prime4;
+}
+
+void ConsumeStripe(std::array<std::uint64_t, 4>& lanes, const std::byte* stripe)
+{
+    for (std::size_t lane = 0; lane < lanes.size(); lane++)
+    {
+        lanes[lane] = Round(lanes[lane], Read64(stripe + lane * sizeof(std::uint64_t)));
+    }
+}
+}
+
+Hasher::Hasher(std::uint64_t seed) : seed_(seed),
+    lanes_{ seed + prime1 + prime2, seed + prime2, seed, seed - prime1 }
+{
+}
+
+void Hasher::Update(const void* data, std::size_t size)
+{
+    const auto* input = static_cast<const std::byte*>(data);
+    totalSize_ += size;
+    if (bufferSize_ + size < stripeSize)
+    {
+        std::memcpy(buffer_.data() + bufferSize_, input, size);
+        bufferSize_ += size;
+        return;
+    }
+    if (bufferSize_ > 0)
+    {
+        const auto fillSize = stripeSize - bufferSize_;
+        std::memcpy(buffer_.data() + bufferSize_, input, fillSize);
+        ConsumeStripe(lanes_, buffer_.data());
+        input += fillSize;
+        size -= fillSize;
+        bufferSize_ = 0;
+    }
+    //Four independent lanes per stripe, such that the multiplications are not waiting on each other
+    auto lanes = lanes_;
+    while (size >= stripeSize)
+    {
+        ConsumeStripe(lanes, input);
+        input += stripeSize;
+        size -= stripeSize;
+    }
+    lanes_ = lanes;
+    std::memcpy(buffer_.data(), input, size);
+    bufferSize_ = size;
+}
+
+std::uint64_t Hasher::Digest() const
+{
+    std::uint64_t hash;
+    if (totalSize_ >= stripeSize)
+    {
+        hash = RotateLeft(lanes_[0], 1) + RotateLeft(lanes_[1], 7) + RotateLeft(lanes_[2], 12) + RotateLeft(lanes_[3], 18);
+        for (const auto lane : lanes_)
+        {
+            hash = MergeRound(hash, lane);
+        }
+    }
+    else
+    {
+        hash = seed_ + prime5;
+    }
+    hash += totalSize_;
+
+    const auto* input = buffer_.data();
+    auto size = bufferSize_;
+    while (size >= sizeof(std::uint64_t))
+    {
+        hash ^= Round(0, Read64(input));
+        hash = RotateLeft(hash, 27) * prime1 + prime4;
+        input += sizeof(std::uint64_t);
+        size -= sizeof(std::uint64_t);
+    }
+    if (size >= sizeof(std::uint32_t))
+    {
+        hash ^= static_cast<std::uint64_t>(Read32(input)) * prime1;
+        hash = RotateLeft(hash, 23) * prime2 + prime3;
+        input += sizeof(std::uint32_t);
+        size -= sizeof(std::uint32_t);
+    }
+    while (size > 0)
+    {
+        hash ^= static_cast<std::uint64_t>(*input) * prime5;
+        hash = RotateLeft(hash, 11) * prime1;
+        input++;
+        size--;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+} // namespace core
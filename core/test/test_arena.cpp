@@ -0,0 +1,107 @@
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "engine/arena.h"
+#include "engine/component.h"
+
+constexpr core::EntityMask arenaComponentType = 2u;
+
+class SimpleArenaComponentManager : public core::ArenaComponentManager<int, arenaComponentType>
+{
+    using ArenaComponentManager::ArenaComponentManager;
+};
+
+TEST(Arena, SparseSetSorted)
+{
+    core::ArenaLayout layout;
+    const core::ArenaComponentLayout<int> componentLayout(layout);
+    core::Arena arena(layout, 8);
+    const auto& sparseSet = componentLayout.sparseSet;
+    EXPECT_EQ(sparseSet.GetSize(arena), 0);
+    arena.Get<int>(componentLayout.components)[sparseSet.Insert(arena, 5)] = 50;
+    arena.Get<int>(componentLayout.components)[sparseSet.Insert(arena, 1)] = 10;
+    arena.Get<int>(componentLayout.components)[sparseSet.Insert(arena, 3)] = 30;
+    const std::vector<core::Entity> expectedEntities{ 1, 3, 5 };
+    const auto entities = sparseSet.GetEntities(arena);
+    EXPECT_EQ(std::vector<core::Entity>(entities.begin(), entities.end()), expectedEntities);
+    EXPECT_EQ(arena.Get<int>(componentLayout.components)[sparseSet.GetIndex(arena, 5)], 50);
+
+    sparseSet.Erase(arena, 1);
+    EXPECT_FALSE(sparseSet.Contains(arena, 1));
+    EXPECT_EQ(sparseSet.GetIndex(arena, 1), core::ArenaSparseSet::INVALID_INDEX);
+    EXPECT_EQ(sparseSet.GetIndex(arena, 3), 0);
+    EXPECT_EQ(arena.Get<int>(componentLayout.components)[0], 30);
+    EXPECT_EQ(arena.Get<int>(componentLayout.components)[1], 50);
+}
+
+TEST(Arena, CopyFrom)
+{
+    core::EntityManager entityManager;
+    core::ArenaLayout layout;
+    const core::ArenaComponentLayout<int> componentLayout(layout);
+    core::Arena arena(layout, 8);
+    core::Arena snapshot(layout, 8);
+    SimpleArenaComponentManager componentManager(entityManager, componentLayout, arena);
+
+    const auto entity = entityManager.CreateEntity();
+    componentManager.AddComponent(entity);
+    componentManager.SetComponent(entity, 1);
+    snapshot.CopyFrom(arena);
+
+    const auto otherEntity = entityManager.CreateEntity();
+    componentManager.AddComponent(otherEntity);
+    componentManager.SetComponent(entity, 2);
+    arena.CopyFrom(snapshot);
+    //The EntityManager is not part of the arena, only the stored components are restored
+    EXPECT_EQ(componentManager.GetComponent(entity), 1);
+    EXPECT_FALSE(componentLayout.sparseSet.Contains(arena, otherEntity));
+}
+
+TEST(Arena, CopyFromEqualLayout)
+{
+    core::ArenaLayout layout;
+    const core::ArenaComponentLayout<int> componentLayout(layout);
+    core::ArenaLayout otherLayout;
+    const core::ArenaComponentLayout<int> otherComponentLayout(otherLayout);
+    EXPECT_EQ(layout, otherLayout);
+    core::Arena arena(layout, 8);
+    core::Arena otherArena(otherLayout, 8);
+    otherArena.Get<int>(otherComponentLayout.components)[otherComponentLayout.sparseSet.Insert(otherArena, 3)] = 30;
+
+    arena.CopyFrom(otherArena);
+    EXPECT_TRUE(componentLayout.sparseSet.Contains(arena, 3));
+    EXPECT_EQ(arena.Get<int>(componentLayout.components)[componentLayout.sparseSet.GetIndex(arena, 3)], 30);
+
+    otherLayout.AddValue<int>();
+    EXPECT_NE(layout, otherLayout);
+}
+
+TEST(Arena, Reserve)
+{
+    core::EntityManager entityManager;
+    core::ArenaLayout layout;
+    const core::ArenaComponentLayout<int> componentLayout(layout);
+    const auto value = layout.AddValue<int>();
+    core::Arena arena(layout, 2);
+    SimpleArenaComponentManager componentManager(entityManager, componentLayout, arena);
+    *arena.Get<int>(value) = 7;
+    componentManager.AddComponent(1);
+    componentManager.SetComponent(1, 10);
+
+    constexpr core::Entity farEntity = 40;
+    arena.Reserve(farEntity + 1);
+    EXPECT_EQ(arena.GetCapacity(), farEntity + 1);
+    componentManager.AddComponent(farEntity);
+    componentManager.SetComponent(farEntity, 400);
+    EXPECT_EQ(*arena.Get<int>(value), 7);
+    EXPECT_EQ(componentManager.GetComponent(1), 10);
+    EXPECT_EQ(componentManager.GetComponent(farEntity), 400);
+
+    std::vector<core::Entity> iteratedEntities;
+    componentManager.ForEach([&iteratedEntities](core::Entity entity, int)
+    {
+        iteratedEntities.push_back(entity);
+    });
+    const std::vector<core::Entity> expectedEntities{ 1, farEntity };
+    EXPECT_EQ(iteratedEntities, expectedEntities);
+}
@@ -0,0 +1,79 @@
+#include <array>
+#include <gtest/gtest.h>
+
+#include "utils/byte_stream.h"
+
+namespace
+{
+enum class TestEnum : std::uint16_t
+{
+    VALUE = 0x1234
+};
+}
+
+TEST(ByteStream, LittleEndian)
+{
+    std::array<std::uint8_t, 7> buffer{};
+    core::ByteWriter writer(buffer);
+    writer.Write(std::uint32_t{ 0x01020304 });
+    writer.Write(TestEnum::VALUE);
+    writer.Write(true);
+    EXPECT_TRUE(writer.IsValid());
+    EXPECT_EQ(writer.GetSize(), buffer.size());
+    const std::array<std::uint8_t, 7> expected{ 0x04, 0x03, 0x02, 0x01, 0x34, 0x12, 0x01 };
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(ByteStream, RoundTrip)
+{
+    std::array<std::uint8_t, 32> buffer{};
+    core::ByteWriter writer(buffer);
+    writer.Write(std::int64_t{ -42 });
+    writer.Write(1.5f);
+    writer.Write(TestEnum::VALUE);
+    writer.Write(std::uint8_t{ 7 });
+
+    core::ByteReader reader(std::span<const std::uint8_t>(buffer.data(), writer.GetSize()));
+    std::int64_t integer = 0;
+    float scalar = 0.0f;
+    TestEnum testEnum{};
+    std::uint8_t byte = 0;
+    reader.Read(integer);
+    reader.Read(scalar);
+    reader.Read(testEnum);
+    reader.Read(byte);
+    EXPECT_TRUE(reader.IsValid());
+    EXPECT_EQ(reader.GetRemainingSize(), 0u);
+    EXPECT_EQ(integer, -42);
+    EXPECT_EQ(scalar, 1.5f);
+    EXPECT_EQ(testEnum, TestEnum::VALUE);
+    EXPECT_EQ(byte, 7);
+}
+
+TEST(ByteStream, Overflow)
+{
+    std::array<std::uint8_t, 3> buffer{};
+    core::ByteWriter writer(buffer);
+    writer.Write(std::uint16_t{ 1 });
+    writer.Write(std::uint16_t{ 2 });
+    EXPECT_FALSE(writer.IsValid());
+    EXPECT_EQ(writer.GetSize(), 2u);
+
+    core::ByteReader reader(buffer);
+    std::uint32_t value = 1;
+    reader.Read(value);
+    EXPECT_FALSE(reader.IsValid());
+    EXPECT_EQ(value, 0u);
+}
+
+TEST(ByteStream, Invalidate)
+{
+    const std::array<std::uint8_t, 2> buffer{ 0x01, 0x02 };
+    core::ByteReader reader(buffer);
+    std::uint8_t value = 0;
+    reader.Read(value);
+    EXPECT_TRUE(reader.IsValid());
+    reader.Invalidate();
+    EXPECT_FALSE(reader.IsValid());
+    EXPECT_EQ(reader.GetRemainingSize(), 1u);
+}
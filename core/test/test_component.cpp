@@ -1,4 +1,5 @@
 #include <cmath>
+#include <vector>
 #include <engine/entity.h>
 #include <gtest/gtest.h>
 
@@ -77,4 +78,89 @@ TEST(Component, InternalArrayOverflow)
     const auto entity = entityManager.CreateEntity();
     componentManager.AddComponent(entity);
     EXPECT_LT(core::entityInitNmb, componentManager.GetAllComponents().size());
-}
\ No newline at end of file
+}
+
+class SimpleSparseComponentManager : public core::SparseComponentManager<int, componentType>
+{
+    using SparseComponentManager::SparseComponentManager;
+};
+
+TEST(SparseComponent, AddRemoveComponent)
+{
+    constexpr int value = 45;
+    core::EntityManager entityManager;
+    SimpleSparseComponentManager componentManager(entityManager);
+
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    componentManager.AddComponent(entity2);
+    componentManager.SetComponent(entity2, value);
+    EXPECT_TRUE(entityManager.HasComponent(entity2, componentType));
+    EXPECT_FALSE(entityManager.HasComponent(entity1, componentType));
+    EXPECT_EQ(componentManager.GetAllComponents().size(), 1);
+
+    componentManager.AddComponent(entity1);
+    EXPECT_EQ(componentManager.GetComponent(entity2), value);
+    componentManager.RemoveComponent(entity1);
+    EXPECT_FALSE(entityManager.HasComponent(entity1, componentType));
+    EXPECT_EQ(componentManager.GetAllComponents().size(), 1);
+    EXPECT_EQ(componentManager.GetComponent(entity2), value);
+}
+
+TEST(SparseComponent, ForEachInEntityOrder)
+{
+    core::EntityManager entityManager;
+    SimpleSparseComponentManager componentManager(entityManager);
+
+    std::vector<core::Entity> entities;
+    for (int i = 0; i < 5; i++)
+    {
+        entities.push_back(entityManager.CreateEntity());
+    }
+    //Added in reverse order, and one entity without the component
+    for (auto it = entities.rbegin(); it != entities.rend(); ++it)
+    {
+        if (*it == entities[2])
+            continue;
+        componentManager.AddComponent(*it);
+        componentManager.SetComponent(*it, static_cast<int>(*it));
+    }
+    entityManager.DestroyEntity(entities[3]);
+
+    std::vector<core::Entity> visitedEntities;
+    componentManager.ForEach([&visitedEntities](core::Entity entity, int& value)
+        {
+            EXPECT_EQ(value, static_cast<int>(entity));
+            visitedEntities.push_back(entity);
+        });
+    const std::vector<core::Entity> expectedEntities{ entities[0], entities[1], entities[4] };
+    EXPECT_EQ(visitedEntities, expectedEntities);
+}
+
+TEST(SparseComponent, CopyAllComponents)
+{
+    constexpr int oldValue1 = 45;
+    constexpr int newValue1 = 43;
+    constexpr int newValue2 = 47;
+    core::EntityManager entityManager;
+    SimpleSparseComponentManager oldComponentManager(entityManager);
+    SimpleSparseComponentManager newComponentManager(entityManager);
+
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    const auto entity3 = entityManager.CreateEntity();
+    oldComponentManager.AddComponent(entity1);
+    oldComponentManager.SetComponent(entity1, oldValue1);
+    newComponentManager.AddComponent(entity1);
+    newComponentManager.SetComponent(entity1, newValue1);
+    newComponentManager.AddComponent(entity2);
+    newComponentManager.SetComponent(entity2, newValue2);
+    newComponentManager.AddComponent(entity3);
+    //Destroyed entities are not copied
+    entityManager.DestroyEntity(entity3);
+
+    oldComponentManager.CopyAllComponents(newComponentManager.GetAllComponents(), newComponentManager.GetAllEntities());
+    EXPECT_EQ(oldComponentManager.GetComponent(entity1), newValue1);
+    EXPECT_EQ(oldComponentManager.GetComponent(entity2), newValue2);
+    EXPECT_EQ(oldComponentManager.GetAllEntities().size(), 2);
+}
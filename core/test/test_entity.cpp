@@ -1,8 +1,10 @@
 #include <cmath>
+#include <vector>
 #include <engine/entity.h>
 #include <gtest/gtest.h>
 
 #include "engine/component.h"
+#include "engine/entity_view.h"
 
 TEST(Entity, CreateEntity)
 {
@@ -43,4 +45,152 @@ TEST(Entity, EntityComponent)
     entityManager.DestroyEntity(newEntity);
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent));
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent2));
-}
\ No newline at end of file
+}
+TEST(Entity, EntityView)
+{
+    static constexpr core::EntityMask includedComponent = 2u;
+    static constexpr core::EntityMask excludedComponent = 4u;
+    core::EntityManager entityManager;
+    const core::EntityView<includedComponent, excludedComponent> view(entityManager);
+    EXPECT_TRUE(view.GetEntities().empty());
+
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    const auto entity3 = entityManager.CreateEntity();
+    entityManager.AddComponent(entity3, includedComponent);
+    entityManager.AddComponent(entity1, includedComponent);
+    entityManager.AddComponent(entity2, includedComponent | excludedComponent);
+    const std::vector<core::Entity> expectedEntities{ entity1, entity3 };
+    EXPECT_EQ(view.GetEntities(), expectedEntities);
+
+    entityManager.RemoveComponent(entity2, excludedComponent);
+    entityManager.DestroyEntity(entity3);
+    const std::vector<core::Entity> newExpectedEntities{ entity1, entity2 };
+    EXPECT_EQ(view.GetEntities(), newExpectedEntities);
+}
+
+TEST(Entity, EntityViewChangedWhileIterating)
+{
+    static constexpr core::EntityMask includedComponent = 2u;
+    static constexpr core::EntityMask excludedComponent = 4u;
+    core::EntityManager entityManager;
+    std::vector<core::Entity> entities;
+    for (int i = 0; i < 4; i++)
+    {
+        entities.push_back(entityManager.CreateEntity());
+        entityManager.AddComponent(entities.back(), includedComponent);
+    }
+    const core::EntityView<includedComponent, excludedComponent> view(entityManager);
+
+    std::vector<core::Entity> visitedEntities;
+    view.ForEach([&](core::Entity entity)
+        {
+            visitedEntities.push_back(entity);
+            //Removing the visited entity and the next one from the view while iterating
+            if (entity == entities[0])
+            {
+                entityManager.AddComponent(entities[0], excludedComponent);
+                entityManager.AddComponent(entities[1], excludedComponent);
+            }
+        });
+    const std::vector<core::Entity> expectedEntities{ entities[0], entities[2], entities[3] };
+    EXPECT_EQ(visitedEntities, expectedEntities);
+}
+
+TEST(Entity, ReuseFirstFreeEntity)
+{
+    core::EntityManager entityManager;
+    std::vector<core::Entity> entities;
+    for (std::size_t i = 0; i < core::entityInitNmb + 1; i++)
+    {
+        entities.push_back(entityManager.CreateEntity());
+        EXPECT_EQ(entities.back(), static_cast<core::Entity>(i));
+    }
+    EXPECT_LT(core::entityInitNmb, entityManager.GetEntitiesSize());
+
+    entityManager.DestroyEntity(entities[100]);
+    entityManager.DestroyEntity(entities[3]);
+    EXPECT_EQ(entityManager.CreateEntity(), entities[3]);
+    EXPECT_EQ(entityManager.CreateEntity(), entities[100]);
+    EXPECT_EQ(entityManager.CreateEntity(), static_cast<core::Entity>(core::entityInitNmb + 1));
+}
+
+TEST(Entity, EntityGeneration)
+{
+    core::EntityManager entityManager;
+    const auto entity = entityManager.CreateEntity();
+    const auto generation = entityManager.GetGeneration(entity);
+
+    entityManager.DestroyEntity(entity);
+    const auto newEntity = entityManager.CreateEntity();
+    EXPECT_EQ(newEntity, entity);
+    EXPECT_NE(entityManager.GetGeneration(newEntity), generation);
+}
+
+TEST(Entity, FindEntities)
+{
+    static constexpr core::EntityMask includedComponent = 2u | 8u;
+    static constexpr core::EntityMask excludedComponent = 4u;
+    core::EntityManager entityManager;
+    std::vector<core::Entity> expectedEntities;
+    //Odd number of entities to also check the remaining masks after the SIMD scan
+    for (core::Entity i = 0; i < 203; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (i % 3 == 0)
+        {
+            entityManager.AddComponent(entity, includedComponent);
+        }
+        if (i % 5 == 0)
+        {
+            entityManager.AddComponent(entity, excludedComponent);
+        }
+        if (i % 7 == 0)
+        {
+            entityManager.AddComponent(entity, 2u);
+        }
+        if (i % 11 == 0)
+        {
+            entityManager.DestroyEntity(entity);
+        }
+        if (entityManager.HasComponent(entity, includedComponent) && !entityManager.HasComponent(entity, excludedComponent))
+        {
+            expectedEntities.push_back(entity);
+        }
+    }
+    std::vector<core::Entity> entities;
+    entityManager.FindEntities(includedComponent, excludedComponent, entities);
+    EXPECT_EQ(entities, expectedEntities);
+}
+
+TEST(Entity, CopyFrom)
+{
+    static constexpr core::Component newComponent = 2u;
+    core::EntityManager entityManager;
+    std::vector<core::Entity> entities;
+    for (int i = 0; i < 10; i++)
+    {
+        entities.push_back(entityManager.CreateEntity());
+    }
+    entityManager.AddComponent(entities[2], newComponent);
+    entityManager.AddComponent(entities[7], newComponent);
+    entityManager.DestroyEntity(entities[4]);
+
+    core::EntityManager copy;
+    //The queries registered on the copy are kept up to date
+    const auto& query = copy.GetQuery(newComponent, core::INVALID_ENTITY_MASK);
+    const auto version = query.version;
+    copy.CopyFrom(entityManager);
+    EXPECT_EQ(query.entities, (std::vector<core::Entity>{ entities[2], entities[7] }));
+    EXPECT_NE(query.version, version);
+    for (const auto entity : entities)
+    {
+        EXPECT_EQ(copy.EntityExists(entity), entityManager.EntityExists(entity));
+        EXPECT_EQ(copy.GetGeneration(entity), entityManager.GetGeneration(entity));
+    }
+    //The free entities are copied too
+    EXPECT_EQ(copy.CreateEntity(), entities[4]);
+    copy.RemoveComponent(entities[7], newComponent);
+    EXPECT_EQ(query.entities, (std::vector<core::Entity>{ entities[2] }));
+    EXPECT_TRUE(entityManager.HasComponent(entities[7], newComponent));
+}
@@ -0,0 +1,39 @@
+#include "maths/fixed.h"
+#include "maths/vec2.h"
+#include <gtest/gtest.h>
+
+TEST(Fixed, Conversion)
+{
+    constexpr core::Fixed integer{ 3 };
+    constexpr core::Fixed half{ 0.5f };
+    constexpr core::Fixed negative{ -0.75 };
+    EXPECT_EQ(integer.GetRaw(), 3 * core::Fixed::one);
+    EXPECT_EQ(half.GetRaw(), core::Fixed::one / 2);
+    EXPECT_FLOAT_EQ(static_cast<float>(negative), -0.75f);
+    //Rounded to the nearest fixed-point step
+    EXPECT_NEAR(static_cast<float>(core::Fixed(0.02f)), 0.02f, 1.0f / core::Fixed::one);
+}
+
+TEST(Fixed, Arithmetic)
+{
+    constexpr core::Fixed a{ 2.5f };
+    constexpr core::Fixed b{ -1.25f };
+    EXPECT_EQ(a + b, core::Fixed(1.25f));
+    EXPECT_EQ(a - b, core::Fixed(3.75f));
+    EXPECT_EQ(a * b, core::Fixed(-3.125f));
+    EXPECT_EQ(a / b, core::Fixed(-2));
+    EXPECT_EQ(-a, core::Fixed(-2.5f));
+    EXPECT_TRUE(b < a);
+    EXPECT_TRUE(a >= 2.5f);
+
+    auto c = a;
+    c += b;
+    c *= 2;
+    EXPECT_EQ(c, core::Fixed(2.5f));
+}
+
+TEST(Fixed, Vec2fMagnitude)
+{
+    const core::Vec2f v{ 3.0f, 4.0f };
+    EXPECT_FLOAT_EQ(core::ToFloat(v.GetMagnitude()), 5.0f);
+}
@@ -0,0 +1,54 @@
+#include <array>
+#include <string_view>
+#include <gtest/gtest.h>
+
+#include "utils/hash.h"
+
+namespace
+{
+std::uint64_t HashString(std::string_view text, std::uint64_t seed = 0)
+{
+    core::Hasher hasher(seed);
+    hasher.Update(text.data(), text.size());
+    return hasher.Digest();
+}
+}
+
+TEST(Hash, ReferenceValues)
+{
+    //Reference XXH64 values
+    EXPECT_EQ(HashString(""), 0xEF46DB3751D8E999ull);
+    EXPECT_EQ(HashString("a"), 0xD24EC4F1A98C6E5Bull);
+    EXPECT_EQ(HashString("abc"), 0x44BC2CF5AD770999ull);
+    EXPECT_EQ(HashString("Nobody inspects the spammish repetition"), 0xFBCEA83C8A378BF1ull);
+}
+
+TEST(Hash, SplitUpdates)
+{
+    constexpr std::string_view text = "The quick brown fox jumps over the lazy dog, several times in a row, to fill a few stripes";
+    const auto expectedHash = HashString(text, 42);
+    for (std::size_t split = 0; split <= text.size(); split += 7)
+    {
+        core::Hasher hasher(42);
+        hasher.Update(text.data(), split);
+        hasher.Update(text.data() + split, text.size() - split);
+        EXPECT_EQ(hasher.Digest(), expectedHash);
+    }
+}
+
+TEST(Hash, Values)
+{
+    constexpr std::array<std::uint32_t, 3> values{ 1, 2, 3 };
+    core::Hasher arrayHasher;
+    arrayHasher.UpdateArray(values.data(), values.size());
+    core::Hasher valueHasher;
+    for (const auto value : values)
+    {
+        valueHasher.Update(value);
+    }
+    EXPECT_EQ(arrayHasher.Digest(), valueHasher.Digest());
+
+    core::Hasher otherHasher;
+    otherHasher.Update(std::uint32_t{ 4 });
+    EXPECT_NE(otherHasher.Digest(), valueHasher.Digest());
+}
@@ -0,0 +1,37 @@
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "engine/sparse_set.h"
+
+TEST(SparseSet, InsertEraseSorted)
+{
+    core::SparseSet sparseSet;
+    EXPECT_EQ(sparseSet.Insert(3), 0);
+    EXPECT_EQ(sparseSet.Insert(1), 0);
+    EXPECT_EQ(sparseSet.Insert(2), 1);
+    const std::vector<core::Entity> expectedEntities{ 1, 2, 3 };
+    EXPECT_EQ(sparseSet.GetEntities(), expectedEntities);
+    EXPECT_EQ(sparseSet.GetIndex(3), 2);
+
+    EXPECT_EQ(sparseSet.Erase(1), 0);
+    EXPECT_FALSE(sparseSet.Contains(1));
+    EXPECT_EQ(sparseSet.GetIndex(1), core::SparseSet::INVALID_INDEX);
+    EXPECT_EQ(sparseSet.GetIndex(2), 0);
+    EXPECT_EQ(sparseSet.GetIndex(3), 1);
+}
+
+TEST(SparseSet, PushBackAndClear)
+{
+    core::SparseSet sparseSet;
+    //Far entities resize the index array
+    constexpr core::Entity farEntity = 1000;
+    sparseSet.PushBack(4);
+    sparseSet.PushBack(farEntity);
+    EXPECT_EQ(sparseSet.GetIndex(farEntity), 1);
+    EXPECT_EQ(sparseSet.GetSize(), 2);
+
+    sparseSet.Clear();
+    EXPECT_EQ(sparseSet.GetSize(), 0);
+    EXPECT_FALSE(sparseSet.Contains(4));
+    EXPECT_FALSE(sparseSet.Contains(farEntity));
+}
@@ -0,0 +1,79 @@
+#include <thread>
+#include <gtest/gtest.h>
+
+#include "utils/spsc_queue.h"
+
+TEST(SpscQueue, Order)
+{
+    core::SpscQueue<int, 4> queue;
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(queue.Front(), nullptr);
+
+    EXPECT_TRUE(queue.TryPush(1));
+    EXPECT_TRUE(queue.TryPush(2));
+    EXPECT_FALSE(queue.IsEmpty());
+    ASSERT_NE(queue.Front(), nullptr);
+    EXPECT_EQ(*queue.Front(), 1);
+    queue.Pop();
+    EXPECT_EQ(*queue.Front(), 2);
+    queue.Pop();
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(SpscQueue, Full)
+{
+    core::SpscQueue<int, 4> queue;
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(queue.TryPush(i));
+    }
+    //The pushed values are kept when the queue is full
+    EXPECT_FALSE(queue.TryPush(4));
+    EXPECT_EQ(*queue.Front(), 0);
+    queue.Pop();
+    EXPECT_TRUE(queue.TryPush(4));
+    //The values wrap around the ring buffer in order
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_NE(queue.Front(), nullptr);
+        EXPECT_EQ(*queue.Front(), i);
+        queue.Pop();
+    }
+    EXPECT_EQ(queue.Front(), nullptr);
+}
+
+TEST(SpscQueue, Threads)
+{
+    struct Value
+    {
+        int first = 0;
+        int second = 0;
+    };
+    constexpr int valueNmb = 100'000;
+    core::SpscQueue<Value, 64> queue;
+    std::thread producer([&queue]
+    {
+        for (int i = 1; i <= valueNmb; i++)
+        {
+            while (!queue.TryPush({ i, -i }))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int lastValue = 0;
+    while (lastValue != valueNmb)
+    {
+        const auto* value = queue.Front();
+        if (value == nullptr)
+        {
+            continue;
+        }
+        //Every value is received once, in order and never torn
+        ASSERT_EQ(value->first, lastValue + 1);
+        ASSERT_EQ(value->first, -value->second);
+        lastValue = value->first;
+        queue.Pop();
+    }
+    producer.join();
+}
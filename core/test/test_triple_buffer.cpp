@@ -0,0 +1,74 @@
+#include <thread>
+#include <gtest/gtest.h>
+
+#include "utils/triple_buffer.h"
+
+TEST(TripleBuffer, LatestValue)
+{
+    core::TripleBuffer<int> tripleBuffer;
+    EXPECT_FALSE(tripleBuffer.HasNewBuffer());
+    EXPECT_EQ(tripleBuffer.Acquire(), 0);
+
+    tripleBuffer.GetWriteBuffer() = 1;
+    tripleBuffer.Publish();
+    EXPECT_TRUE(tripleBuffer.HasNewBuffer());
+    EXPECT_EQ(tripleBuffer.Acquire(), 1);
+    EXPECT_FALSE(tripleBuffer.HasNewBuffer());
+    //Nothing new was published, the same value is kept
+    EXPECT_EQ(tripleBuffer.Acquire(), 1);
+
+    //Only the last published value is seen by the reader
+    tripleBuffer.GetWriteBuffer() = 2;
+    tripleBuffer.Publish();
+    tripleBuffer.GetWriteBuffer() = 3;
+    tripleBuffer.Publish();
+    EXPECT_EQ(tripleBuffer.Acquire(), 3);
+}
+
+TEST(TripleBuffer, WriteBufferIsNotRead)
+{
+    core::TripleBuffer<int> tripleBuffer;
+    tripleBuffer.GetWriteBuffer() = 1;
+    tripleBuffer.Publish();
+    const int& readValue = tripleBuffer.Acquire();
+    for (int i = 2; i < 10; i++)
+    {
+        auto& writeBuffer = tripleBuffer.GetWriteBuffer();
+        EXPECT_NE(&writeBuffer, &readValue);
+        writeBuffer = i;
+        tripleBuffer.Publish();
+    }
+    EXPECT_EQ(readValue, 1);
+    EXPECT_EQ(tripleBuffer.Acquire(), 9);
+}
+
+TEST(TripleBuffer, Threads)
+{
+    struct Value
+    {
+        int first = 0;
+        int second = 0;
+    };
+    constexpr int valueNmb = 100'000;
+    core::TripleBuffer<Value> tripleBuffer;
+    std::thread writer([&tripleBuffer]
+    {
+        for (int i = 1; i <= valueNmb; i++)
+        {
+            auto& value = tripleBuffer.GetWriteBuffer();
+            value.first = i;
+            value.second = -i;
+            tripleBuffer.Publish();
+        }
+    });
+    int lastValue = 0;
+    while (lastValue != valueNmb)
+    {
+        const auto& value = tripleBuffer.Acquire();
+        //Values are never torn and never go back in time
+        ASSERT_EQ(value.first, -value.second);
+        ASSERT_GE(value.first, lastValue);
+        lastValue = value.first;
+    }
+    writer.join();
+}
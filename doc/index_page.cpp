@@ -47,20 +47,43 @@
  * //... Do things with sprite
  * spriteMManager_.RemoveComponent(entity);
  * \endcode
+ *
+ * The core::SparseComponentManager has the same interface, but only stores the components of the entities that have them (a dense array sorted by core::Entity and an entity to index array, kept by a core::SparseSet). Its ForEach method only iterates over those entities, which avoids scanning the whole entity array for components that come and go. It is used for the sprites. Both component managers provide a ForEach method:
+ * \code
+ * spriteManager_.ForEach([](core::Entity entity, sf::Sprite& sprite)
+ * {
+ *     //... Do things with sprite
+ * });
+ * \endcode
+ *
+ * The core::ArenaComponentManager is a sparse component manager whose sorted arrays live in a core::Arena, one contiguous buffer of trivially copyable arrays described by a core::ArenaLayout. The manager does not own its data, so several arenas with the same layout can be copied into each other with a single memcpy. It is used for the rollback components of the game (bodies, boxes, player characters and attacks).
+ * \subsection entity_view Entity View
+ * The core::EntityView is a template class giving the entities that have all the components of an include mask and none of an exclude mask, with their components. The core::EntityManager keeps one sorted entity list per registered mask pair (core::EntityQuery) and updates it when an entity mask changes, so a view does not scan all the entities:
+ * \code
+ * const core::EntityView<colliderMask, destroyedMask> colliderView(entityManager_);
+ * colliderView.ForEach([](core::Entity entity, Body& body, Box& box)
+ * {
+ *     //... Do things with body and box
+ * }, bodyManager_, boxManager_);
+ * \endcode
  * \subsection sprite_manager Sprite Manager
- * The core::SpriteManager is a core::ComponentManager that owns the sprites in the game. Sprites are using sf::Sprite from SFML to draw on the window.
+ * The core::SpriteManager is a core::SparseComponentManager that owns the sprites in the game. Sprites are using sf::Sprite from SFML to draw on the window.
  * 
  * Sprite draw ordering works with core::Entity ordering. It means that the background should be the first entity to spawn because it will drawn first, therefore behind the next sprites.
  * 
  * Sprites are centered on the position of the core::PositionManager by default.
  * \subsection physics_manager Physics Manager
- * The game::PhysicsManager is a class that contains two core::ComponentManager:
- * - game::BodyManager owns the game::Body (or rigid bodies) of the physics engine.
- * - game::BoxManager owns the game::Box (or box colliders) of the physics engine.
+ * The game::PhysicsManager is a class that contains two component managers:
+ * - game::BodyManager owns the game::Body (or rigid bodies) of the physics engine. It stores each field of the bodies in its own array of the world arena (game::BodyArenaLayout), sorted by core::Entity with a core::ArenaSparseSet, and gives the bodies by value.
+ * - game::BoxManager is a core::ArenaComponentManager that owns the game::Box (or box colliders) of the physics engine.
  * 
  * The Physics Engine is a REALLY simple implementation of basic box triggering. 
+ *
+ * The bodies are moved by two branchless kernels that the compiler can vectorise: game::BodyManager::Integrate before the collisions, and game::BodyManager::ResolveGravityAndGround after them, as triggers read the moved positions and change the velocities. Both select their results instead of adding zeros, so they give the exact same floats as updating each body on its own.
+ *
+ * To avoid testing every pair of boxes, a game::BroadphaseInterface first gives the pairs of boxes that may overlap (game::SweepAndPruneBroadphase along the x axis by default, or game::UniformGridBroadphase, set with SetBroadphase). The pairs are then sorted by core::Entity before being tested, such that the triggers happen in the same order on the server and the clients.
  * 
- * When a trigger occurs, the game::PhysicsManager will call the OnTrigger method all its game::OnTriggerInterface. To register a game::OnTriggerInterface, you have to give it to the RegisterTriggerListener method.
+ * The boxes in contact are written as game::Contact in a buffer of the game::PhysicsManager reused from frame to frame, then given in one batch to the contact listener passed to game::PhysicsManager::FixedUpdate as a template argument, so no allocation nor type-erased call happens while resimulating. game::RollbackManager::OnContacts classifies both entities of each contact (player, attack or other) and finds the method to call in a compile-time dispatch table. A contact is skipped when one of its entities was destroyed by a previous contact of the batch.
  * \subsection transform_manager Transform Manager
  * The core::TransformManager is a class that contains three core::ComponentManager:
  * - core::PositionManager owns the positions in meter of all entities, both used in physics and graphics (converted to pixel with pixelToMeter).
@@ -79,7 +102,11 @@
  * \subsection start_game Starting the game
  * When all players are connected, the server automatically send a game::StartGamePacket to each player through the TCP channel. Each client will then wait about <a href="game__globals_8h.html">game::startDelay</a> milliseconds before starting their game session.
  * \subsection send_input Sending player inputs
- * Each frame, the game sends the current player inputs (game::PlayerInputPacket), as well as the last <a href="game__globals_8h.html">game::maxInputNmb</a> inputs in an UDP packet.
+ * Each frame, the game sends the current player input (game::PlayerInputPacket) in an UDP packet, with all the previous inputs that the server did not acknowledge yet.
+ * The server relays the inputs of a player from its own input history to all clients, from the last frame received by all the other clients, which each client acknowledges in its own input packets.
+ * The relayed packet ends on the last frame received from the player without any missing frame before it, which acknowledges its inputs. The server also validates the frames only until there.
+ * The inputs are always resent from the first frame not acknowledged. Their number is capped by two retransmission timeouts computed from srtt and rttvar, and by <a href="game__globals_8h.html">game::maxInputNmb</a>, the newest inputs waiting for the next packets.
+ * On the wire, the inputs are run-length encoded: each byte holds a 5-bit input and the length of its run, so an input packet is about ten bytes instead of one byte per input.
  * \subsection validate_frame Validating the frame
  * When the server finally receives all the player inputs for a specific frame, it will automatically validate the specific frame and will update its lastValidateFrame_ to the new specific frame. It will then sends a game::ValidateFramePacket to all clients.
  * 
@@ -88,6 +115,10 @@
  * It is always important to know the current round trip time between a client and a server. The ping system is pretty simple. The client sends a PING Packet (game::PingPacket) to the server containing the current time and the server sends the same Packet back. When the client gets the game::PingPacket back, it can calculate the time it took for the Packet to do the round trip (RTT).
  * 
  * We then use TCP Retransmission Timer to calculate srtt and rttvar to get an idea of the average and variability of the packet.
+ * \subsection time_sync Time Synchronisation
+ * The starting time is only computed once, so a client can run some frames ahead of the others, which would then always receive its inputs late and roll back deeper. Each new frame, the client estimates its frame advantage (game::TimeSync): its current frame minus the last frame received from the remote players plus the srtt in frames, as the remote inputs go through the server. The smoothed advantage slows down (when ahead) or speeds up (when behind) the fixed updates by at most <a href="game__globals_8h.html">game::maxTimeDilation</a>, such that the clients stay on the same frame without visible jumps.
+ *
+ * The client can also delay its local inputs by up to <a href="game__globals_8h.html">game::maxInputDelay</a> frames (game::ClientGameManager::SetInputDelay). The input sampled on frame F is written on frame F + delay of the input history and sent right away, so the remote players receive it delay frames before simulating its frame. An input delay close to the latency in frames lets them receive the inputs in time, so they do not need to roll back. The game::PlayerInputPacket carries the input delay of the player, which the remote clients subtract from its last received frame to estimate its current frame.
  * \subsection win_game Win game
  * When the server validates the frame where a win/lose condition occurs, it sends a game::WinGamePacket on a reliable channel to all the clients with the info on the winning player. This allows all clients to stop their game loop and show an ending message (You won! or The other player won!).
  * \subsection net_simulation Net Simulation
@@ -100,29 +131,49 @@
  * - Current Frame (except the server)
  * The server only stores the last validated frame's physics state.
  * \subsection current_frame Client Current Frame
- * To allow real time illusion, the client controls its player character in real time without waiting the validation of the server. For other clients, the rollback manager will simply repeat the last received inputs.
+ * To allow real time illusion, the client controls its player character in real time without waiting the validation of the server. For other clients, the rollback manager predicts the inputs after the last received one with a game::InputPredictorInterface: game::RepeatLastInputPredictor (the default) repeats the last received input, game::FrequencyInputPredictor keeps each button in its most frequent recent state and game::ButtonHoldInputPredictor releases a button pressed as long as the previous tap, for the dash double click. A misprediction only costs the resimulation of the frames after it, so the hit rate (game::PredictionStats) and the number of resimulated frames are shown in the client ImGui window, where the predictor can be changed.
  * 
- * After receiving other clients inputs, the rollback manager will run all the FixedUpdate methods between the last validated frame and the current frame before running the new current frame.
+ * The rollback manager keeps a snapshot of the world for each frame between the last validated frame and the current frame (a ring buffer of <a href="game__globals_8h.html">game::windowBufferSize</a> frames at first). The inputs of each player are stored the same way in a game::InputHistory, indexed by frame modulo its capacity and packed on 5 bits per input, so starting a new frame only writes the new frame. When a player lags behind and the validated frame is too far from the current frame, the inputs and snapshots ring buffers double their capacity instead of overwriting frames that are not validated yet, up to <a href="game__globals_8h.html">game::maxWindowBufferSize</a> frames. The inputs after the end of the window are rejected, and a player stalled for the whole window ends the game like a disconnection. After receiving other clients inputs, it goes back to the snapshot of the frame before the earliest changed input and only runs the FixedUpdate methods from there to the current frame. When no input changed, only the new frames are simulated.
+ *
+ * A late packet can force a rollback of dozens of frames. To avoid a hitch, the client simulates at most <a href="game__globals_8h.html">game::maxSimulatedFramesPerUpdate</a> frames or <a href="game__globals_8h.html">game::simulationTimeBudget</a> microseconds per render frame (game::SimulationBudget). The rest of the rollback is simulated in the next render frames, while the sprites keep the transforms of the last fully simulated frame. New mispredictions can revert this partial progress, so after <a href="game__globals_8h.html">game::maxIncompleteSimulationNmb</a> incomplete render frames the whole rollback is simulated at once.
+ *
+ * With <a href="game__globals_8h.html">game::speculativeBranchNmb</a> above 0, the client also simulates in advance the most likely alternatives of the next input of the most late remote player, while it waits for it. The branches are only loaded again once this input is received. Each game::SpeculativeBranch is a headless copy of the game loaded from the snapshot before that frame into the storage of its previous loads, simulated on its own worker thread with the predicted input where one button changed (the buttons the player changed the most first). When the received inputs match the inputs of a finished branch, its snapshots and world replace the mispredicted frames instead of simulating them again (game::SpeculationStats). A branch that created or destroyed an entity is never adopted, as its entities would differ from the ones of the client, and the speculation is dropped when the world before it changes (validation of a destroyed entity, rollback before it).
+ *
+ * All the rollback components of a world are stored in one core::Arena whose layout is given by game::WorldArenaLayout. The current world, the last validated world and each snapshot are arenas with the same capacity, so saving or restoring a frame is a single memcpy without any allocation. The arenas only grow (game::worldArenaInitCapacity doubling) when an entity index does not fit anymore, which happens when spawning. When an entity is truly destroyed, its components are removed from the current world and from the snapshots that can still be restored, as its index can be reused.
  * \subsection physics_checksum Validating a Frame
- * When validating a frame, the server calculates the new physics state and will then generate a checksum (a 16-bit number) per player of the player character positions, rotations and velocities (linear and angular). This number is sent in the game::ValidateStatePacket with the validated frame index.
+ * When validating a frame, the server calculates the new world state and will then generate a 64-bit checksum (core::Hasher, an xxHash) of the whole validated world arena: the bodies, the boxes, the player characters and the attacks. Each component array is hashed on its own, without the entities, as a client can give other entities than the server to the same attack. The checksum is sent in the game::ValidateFramePacket with the validated frame index and, when game::sendComponentChecksums is true, with the checksum of each component array.
  * 
- * The clients will then validate the frame by calculating the physics state up to the server validated frame and will then compare the checksums values. If the values differ, it is the end of the game, because the physics state of the client is in desync, meaning that the physics simulation was not determinist compare to the other process/host.
+ * The clients will then validate the frame by calculating the world state up to the server validated frame and will then compare the checksums values. If the values differ, it is the end of the game, because the world state of the client is in desync, meaning that the simulation was not determinist compare to the other process/host. The assertion message gives the component arrays in desync, when the server sent them.
+ * \subsection fixed_point Fixed-Point Simulation
+ * The checksums only catch a desync, they do not prevent it. With the ENABLE_FIXED_POINT CMake option, core::Scalar becomes core::Fixed (a 64-bit integer with 16 fractional bits) instead of float. core::Vec2f, core::Degree, the game constants of game_globals.h and the player and attack timers use core::Scalar, so the whole simulation only does integer operations and gives the same results with any compiler, instruction set or floating-point flags (for example -O3 -march=native). The graphics convert the values back to float with core::ToFloat, and the trigonometric functions stay in float, as they are not used by the simulation.
  * \subsection destroy_entity Create And Destroy Entities
  * On the client side, due to the delta time between the last validate frame from the server and the current frame on the client, we cannot be sure that an entity is actually created or destroyed when creating or destroying an entity. It means that we have to wait for the server to confirm the frame where an entitiy is created or destroyed, before actually create or destroy the entity.
  * 
- * For entity creation, it is a rather easy problem to solve. We just have to store when a entity is created (game::CreatedEntity struct). Before calculating a new current frame from the last validated frame or when validating a frame, we just check this frame time with the last validated frame and if it is younger, we simply destroy the entity (because it will be created again when simulating).
+ * For entity creation, it is a rather easy problem to solve. We just have to store when a entity is created (game::CreatedEntity struct). When going back to a frame snapshot, we just check this frame time with the snapshot frame and if it is younger, we simply destroy the entity (because it will be created again when simulating).
+ * 
+ * For entity destruction, the chosen solution do not actually destroy the entity. We simply add a DESTROY flag in the core::EntityManager (like an empty Component) when simulating a new frame and store when it happened (game::DestroyedEntity struct). When going back before this frame, the flag is removed. If we are validating the frame, we simply destroy the entity. This means that the FixedUpdate methods have to check both if an entity exists and that there is no DESTROY component. 
  * 
- * For entity destruction, the chosen solution do not actually destroy the entity. We simply add a DESTROY flag in the core::EntityManager (like an empty Component) when simulating a new frame. If we are validating a frame, we simply destroy the entity. This means that the FixedUpdate methods have to check both if an entity exists and that there is no DESTROY component. 
+ * Both records are kept in journals ordered by frame, as the frames are always simulated in increasing order. Going back to a frame only pops the records of the reverted frames from the back of the journals, and validating a frame only pops the records of the validated frames from the front, so the cost of a rollback or a validation only depends on the number of entities created or destroyed in these frames.
+ * \subsection rollback_bench Rollback Benchmark
+ * The rollback_bench executable (game/bench) runs the game::GameManager without any window with scripted player inputs, and reports the time spent per frame in game::RollbackManager::SimulateToCurrentFrame, game::RollbackManager::ValidateFrame and game::PhysicsManager::FixedUpdate for 2, 8, 64 and 1024 entities (the players and static platforms). The remote player inputs arrive with a configurable delay, which defines the rollback depth:
+ * \code
+ * rollback_bench <frame number> <rollback depth> <rollback depth> ...
+ * \endcode
+ * It then reports the hit rate and the number of resimulated frames of each input predictor with the same scripted inputs.
  * \section game_manager GameManager
  * The game is managed in the game::GameManager. However, depending if the application is client- or server-side, the requirements on the GameManager are completely different.
  * \subsection server_game_manager Server GameManager
- * Due to the nature of the server-side, the server game::GameManager does not need to care about the graphical part of the game (managed in the Update method), only the physical part (mostly managed in the FixedUpdate). It does not have an Update method, as the physics state validation is only done when receiving all the player inputs of a certain frame. The server only reacts to received packets to move forward in the game. Obviously, the server is always back in the game past compared to the clients, but it is authorative.
+ * Due to the nature of the server-side, the server game::GameManager does not need to care about the graphical part of the game (managed in the Update method), only the physical part (mostly managed in the FixedUpdate). It does not have an Update method, as the physics state validation is only done when all the player inputs of a certain frame are received. The received inputs are applied and relayed right away, and every <a href="game__globals_8h.html">game::serverTickPeriod</a> the game::Server validates all the frames received by every player at once and sends one ValidateFramePacket for them, so the cost of a tick does not depend on how many redundant input packets arrived. Obviously, the server is always back in the game past compared to the clients, but it is authorative.
  * 
  * For an event to only happen on the server side, one must implement it in the game::Server class (NOT in the game::GameManager, because it will be used in the game::ClientGameManager as well).
+ *
+ * The server game::GameManager is constructed with game::WorldMode::VALIDATED: its game::RollbackManager keeps a single authoritative world, which game::RollbackManager::ValidateFrame simulates forward from the last validated frame, as all the inputs until the new validated frame are received. It has no frame snapshot, no copy of the last validated world and no transforms, and the world checksum is computed on this world directly.
  * \subsection client_game_manager Client GameManager
  * The game::ClientGameManager inherits from the server game::GameManager and extends its features with graphical interface and real time client requirements. It means that like the server, it manages the receiving inputs, but at the same time, it also update the graphical part of the game in the Update method while updating the rollbacked phyiscal state in a continuous FixedUpdate way (it does not wait for other player inputs to move forward in time for a true real time illusion).
  * 
  * Event happening in the game::ClientGameManager only happens on the client-side, no need to implement them in the game::Client.
+ *
+ * When <a href="game__globals_8h.html">game::useSimulationThread</a> is true, the client app calls game::ClientGameManager::StartSimulationThread and the fixed updates and rollbacks run on a dedicated thread. This thread samples the local input right before each fixed update and publishes a game::ClientGameManager::RenderState (the sprites placed with their transforms, the camera and the texts) in a lock-free core::TripleBuffer. The render thread draws the last published state with core::SpriteManager::Draw, so a long rollback does not drop a rendered frame and a vsync stall does not delay the input sampling. The render thread never waits for the simulation: it pushes the received packets in a lock-free core::SpscQueue and the window size in another core::TripleBuffer, and the simulation thread applies them at the start of each of its updates.
  * \section sqlite SQLite
  * To debug efficiently the missbehavior of the netcode, the framework is providing a SQLite database allowing to review the last session. To use it, please enable ENABLE_SQLITE_STORE in your CMake options. You can use DB Browser for SQLite to open the databases created in the binaries folder. Each client will create its own database using its core::ClientId (for example Client85.db for a client who ClientId is 85).
  * \subsection input_dbg Input debugging
@@ -134,7 +185,7 @@
  * The SQLite database stores the physics state of all players when receiving a frame confirmation from the server. The database stores those data:
  * - local_frame, the current frame on the client side.
  * - validate_frame, the validate frame from the server.
- * - For each player: state_pN_local, state_pN_server (N being the player number) are the physics checksums.
+ * - checksum_local, checksum_server are the world checksums.
  * Those data allows to debug on all clients where the client desyncs from the server.
  * \section miscellaneous Miscellaneous
  * \subsection angle Angles
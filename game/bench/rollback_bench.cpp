@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "game/game_manager.h"
+
+namespace
+{
+/**
+ * \brief BenchGameManager is a headless game::GameManager exposing the rollback manager to the benchmark.
+ */
+class BenchGameManager final : public game::GameManager
+{
+public:
+    explicit BenchGameManager(game::WorldMode worldMode = game::WorldMode::ROLLBACK) : GameManager(worldMode)
+    {
+    }
+    game::RollbackManager& GetMutableRollbackManager() { return rollbackManager_; }
+    void StartNewFrame(game::Frame newFrame)
+    {
+        currentFrame_ = newFrame;
+        rollbackManager_.StartNewFrame(newFrame);
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+using InputScript = std::vector<std::array<game::PlayerInput, game::maxPlayerNmb>>;
+
+constexpr std::array<std::size_t, 4> entityNmbs{ 2, 8, 64, 1024 };
+constexpr std::uint32_t inputSeed = 42;
+constexpr float platformExtends = 0.1f;
+
+/**
+ * \brief CreateInputScript generates the same deterministic input streams for every run.
+ * Each player keeps its input for a few frames before changing it, like a human would do.
+ */
+InputScript CreateInputScript(game::Frame frameNmb)
+{
+    std::mt19937 generator(inputSeed);
+    std::uniform_int_distribution<int> inputDistribution(0, 31);
+    std::uniform_int_distribution<int> changeDistribution(0, 9);
+    InputScript script(frameNmb + 1);
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            script[frame][playerNumber] = changeDistribution(generator) == 0 ?
+                static_cast<game::PlayerInput>(inputDistribution(generator)) :
+                script[frame - 1][playerNumber];
+        }
+    }
+    return script;
+}
+
+/**
+ * \brief CreateSegmentScript generates deterministic input streams made of segments.
+ * appendSegment appends the next segment of inputs to a player stream, until the stream covers all the frames.
+ */
+template<typename AppendSegment>
+InputScript CreateSegmentScript(game::Frame frameNmb, AppendSegment appendSegment)
+{
+    std::mt19937 generator(inputSeed);
+    InputScript script(frameNmb + 1);
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+    {
+        std::vector<game::PlayerInput> playerInputs{ game::PlayerInputEnum::NONE };
+        while (playerInputs.size() <= frameNmb)
+        {
+            appendSegment(generator, playerInputs);
+        }
+        for (game::Frame frame = 0; frame <= frameNmb; frame++)
+        {
+            script[frame][playerNumber] = playerInputs[frame];
+        }
+    }
+    return script;
+}
+
+void AppendHold(std::vector<game::PlayerInput>& playerInputs, game::PlayerInput playerInput, int frameNmb)
+{
+    playerInputs.insert(playerInputs.end(), static_cast<std::size_t>(frameNmb), playerInput);
+}
+
+/**
+ * \brief CreateDashScript generates the double taps of a dash, separated by idle frames.
+ * The second tap is as long as the first one, what ButtonHoldInputPredictor expects.
+ */
+InputScript CreateDashScript(game::Frame frameNmb)
+{
+    return CreateSegmentScript(frameNmb, [](std::mt19937& generator, std::vector<game::PlayerInput>& playerInputs)
+    {
+        std::uniform_int_distribution<int> idleDistribution(10, 40);
+        std::uniform_int_distribution<int> tapDistribution(2, 6);
+        std::bernoulli_distribution directionDistribution;
+        const game::PlayerInput direction = directionDistribution(generator) ?
+            game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT;
+        const int tapFrameNmb = tapDistribution(generator);
+        AppendHold(playerInputs, game::PlayerInputEnum::NONE, idleDistribution(generator));
+        AppendHold(playerInputs, direction, tapFrameNmb);
+        AppendHold(playerInputs, game::PlayerInputEnum::NONE, tapDistribution(generator));
+        AppendHold(playerInputs, direction, tapFrameNmb);
+    });
+}
+
+/**
+ * \brief CreateMashScript generates a held direction while the attack is mashed, pressed on 3 frames out of 4 on average.
+ * The attack flickers at random, what FrequencyInputPredictor expects.
+ */
+InputScript CreateMashScript(game::Frame frameNmb)
+{
+    return CreateSegmentScript(frameNmb, [](std::mt19937& generator, std::vector<game::PlayerInput>& playerInputs)
+    {
+        constexpr std::array<game::PlayerInput, 3> directions{
+            game::PlayerInputEnum::NONE, game::PlayerInputEnum::LEFT, game::PlayerInputEnum::RIGHT };
+        std::uniform_int_distribution<std::size_t> directionDistribution(0, directions.size() - 1);
+        std::uniform_int_distribution<int> holdDistribution(30, 90);
+        std::bernoulli_distribution attackDistribution(0.75);
+        const auto direction = directions[directionDistribution(generator)];
+        const int holdFrameNmb = holdDistribution(generator);
+        for (int i = 0; i < holdFrameNmb; i++)
+        {
+            playerInputs.push_back(attackDistribution(generator) ? direction | game::PlayerInputEnum::ATTACK : direction);
+        }
+    });
+}
+
+/**
+ * \brief CreateHoldScript generates random inputs held for several seconds.
+ */
+InputScript CreateHoldScript(game::Frame frameNmb)
+{
+    return CreateSegmentScript(frameNmb, [](std::mt19937& generator, std::vector<game::PlayerInput>& playerInputs)
+    {
+        std::uniform_int_distribution<int> inputDistribution(0, 31);
+        std::uniform_int_distribution<int> holdDistribution(60, 240);
+        const auto playerInput = static_cast<game::PlayerInput>(inputDistribution(generator));
+        AppendHold(playerInputs, playerInput, holdDistribution(generator));
+    });
+}
+
+/**
+ * \brief InputWorkload is a named input script on which the input predictors are compared.
+ */
+struct InputWorkload
+{
+    const char* name;
+    InputScript script;
+};
+
+/**
+ * \brief SpawnWorld spawns the players and fills the rest of the world with static platforms
+ * until the world contains entityNmb entities.
+ */
+void SpawnWorld(BenchGameManager& gameManager, std::size_t entityNmb)
+{
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+    {
+        gameManager.SpawnPlayer(playerNumber, game::spawnPositions[playerNumber]);
+    }
+    constexpr std::size_t platformPerRow = 32;
+    for (std::size_t i = game::maxPlayerNmb; i < entityNmb; i++)
+    {
+        const auto column = static_cast<float>(i % platformPerRow);
+        const auto row = static_cast<float>(i / platformPerRow);
+        gameManager.SpawnPlatform(
+            core::Vec2f(-4.0f + column * 0.25f, row * 0.25f),
+            core::Vec2f::one() * platformExtends);
+    }
+}
+
+double ToNsPerFrame(Clock::duration duration, game::Frame frameNmb)
+{
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) /
+        static_cast<double>(frameNmb);
+}
+
+/**
+ * \brief BenchSimulateToCurrentFrame plays the client side: the local player inputs are known
+ * directly, while the remote player inputs arrive rollbackDepth frames late and force a rollback.
+ */
+double BenchSimulateToCurrentFrame(const InputScript& script, std::size_t entityNmb, game::Frame rollbackDepth)
+{
+    BenchGameManager gameManager;
+    SpawnWorld(gameManager, entityNmb);
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    const auto frameNmb = static_cast<game::Frame>(script.size() - 1);
+    Clock::duration total{};
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        gameManager.StartNewFrame(frame);
+        gameManager.SetPlayerInput(0, script[frame][0], frame);
+        if (frame > rollbackDepth)
+        {
+            const game::Frame remoteFrame = frame - rollbackDepth;
+            gameManager.SetPlayerInput(1, script[remoteFrame][1], remoteFrame);
+        }
+
+        const auto start = Clock::now();
+        rollbackManager.SimulateToCurrentFrame();
+        total += Clock::now() - start;
+
+        if (frame > rollbackDepth)
+        {
+            gameManager.Validate(frame - rollbackDepth);
+        }
+    }
+    return ToNsPerFrame(total, frameNmb);
+}
+
+/**
+ * \brief PredictionResult is the prediction statistics of the remote player at the end of a client run.
+ */
+struct PredictionResult
+{
+    float hitRate = 0.0f;
+    std::uint32_t resimulatedFrameNmb = 0;
+};
+
+/**
+ * \brief MeasurePrediction plays the client side like BenchSimulateToCurrentFrame with the given input predictor,
+ * and gives how well the remote player inputs were predicted.
+ */
+PredictionResult MeasurePrediction(const InputScript& script, game::InputPredictorType inputPredictorType, game::Frame rollbackDepth)
+{
+    BenchGameManager gameManager;
+    SpawnWorld(gameManager, game::maxPlayerNmb);
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    rollbackManager.SetInputPredictor(game::CreateInputPredictor(inputPredictorType));
+    const auto frameNmb = static_cast<game::Frame>(script.size() - 1);
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        gameManager.StartNewFrame(frame);
+        gameManager.SetPlayerInput(0, script[frame][0], frame);
+        if (frame > rollbackDepth)
+        {
+            const game::Frame remoteFrame = frame - rollbackDepth;
+            gameManager.SetPlayerInput(1, script[remoteFrame][1], remoteFrame);
+        }
+        rollbackManager.SimulateToCurrentFrame();
+        if (frame > rollbackDepth)
+        {
+            gameManager.Validate(frame - rollbackDepth);
+        }
+    }
+    return { rollbackManager.GetPredictionStats(1).GetHitRate(), rollbackManager.GetResimulatedFrameNmb() };
+}
+
+/**
+ * \brief BenchValidateFrame plays the validation side: all the inputs are received
+ * and validated in batches of rollbackDepth frames.
+ * WorldMode::ROLLBACK is the cost of the validation on a client, WorldMode::VALIDATED the cost on the server.
+ */
+double BenchValidateFrame(const InputScript& script, std::size_t entityNmb, game::Frame rollbackDepth, game::WorldMode worldMode)
+{
+    BenchGameManager gameManager(worldMode);
+    SpawnWorld(gameManager, entityNmb);
+    const auto frameNmb = static_cast<game::Frame>(script.size() - 1);
+    const game::Frame batchSize = std::max(rollbackDepth, 1u);
+    Clock::duration total{};
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            gameManager.SetPlayerInput(playerNumber, script[frame][playerNumber], frame);
+        }
+        if (frame % batchSize == 0 || frame == frameNmb)
+        {
+            const auto start = Clock::now();
+            gameManager.Validate(frame);
+            total += Clock::now() - start;
+        }
+    }
+    return ToNsPerFrame(total, frameNmb);
+}
+
+/**
+ * \brief BenchPhysics measures PhysicsManager::FixedUpdate alone on the current world.
+ */
+double BenchPhysics(std::size_t entityNmb, game::Frame frameNmb)
+{
+    BenchGameManager gameManager;
+    SpawnWorld(gameManager, entityNmb);
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    auto& physicsManager = rollbackManager.GetCurrentPhysicsManager();
+    const auto start = Clock::now();
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        physicsManager.FixedUpdate(sf::seconds(game::fixedPeriod), rollbackManager);
+    }
+    return ToNsPerFrame(Clock::now() - start, frameNmb);
+}
+}
+
+/**
+ * Usage: rollback_bench [frameNmb] [rollbackDepth...]
+ */
+int main(int argc, char** argv)
+{
+    spdlog::set_level(spdlog::level::warn);
+
+    game::Frame frameNmb = 300;
+    std::vector<game::Frame> rollbackDepths{ 1, 4, 16 };
+    if (argc >= 2)
+    {
+        frameNmb = static_cast<game::Frame>(std::stoul(argv[1]));
+    }
+    if (argc >= 3)
+    {
+        rollbackDepths.clear();
+        for (int i = 2; i < argc; i++)
+        {
+            rollbackDepths.push_back(static_cast<game::Frame>(std::stoul(argv[i])));
+        }
+    }
+    if (frameNmb == 0)
+    {
+        fmt::print(stderr, "Frame number needs to be positive\n");
+        return 1;
+    }
+
+    const auto script = CreateInputScript(frameNmb);
+    fmt::print("{:>8} {:>6} {:>22} {:>22} {:>22} {:>22}\n",
+        "entities", "depth", "simulate (ns/frame)", "validate (ns/frame)", "server (ns/frame)", "physics (ns/frame)");
+    for (const auto entityNmb : entityNmbs)
+    {
+        const double physicsTime = BenchPhysics(entityNmb, frameNmb);
+        for (const auto rollbackDepth : rollbackDepths)
+        {
+            fmt::print("{:>8} {:>6} {:>22.0f} {:>22.0f} {:>22.0f} {:>22.0f}\n",
+                entityNmb, rollbackDepth,
+                BenchSimulateToCurrentFrame(script, entityNmb, rollbackDepth),
+                BenchValidateFrame(script, entityNmb, rollbackDepth, game::WorldMode::ROLLBACK),
+                BenchValidateFrame(script, entityNmb, rollbackDepth, game::WorldMode::VALIDATED),
+                physicsTime);
+        }
+    }
+
+    const std::array<InputWorkload, 4> workloads{ {
+        { "random", script },
+        { "dash taps", CreateDashScript(frameNmb) },
+        { "attack mash", CreateMashScript(frameNmb) },
+        { "long holds", CreateHoldScript(frameNmb) } } };
+    fmt::print("\n{:>12} {:>12} {:>6} {:>10} {:>12}\n", "workload", "predictor", "depth", "hit rate", "resimulated");
+    for (const auto& workload : workloads)
+    {
+        for (std::size_t type = 0; type < game::inputPredictorTypeNmb; type++)
+        {
+            for (const auto rollbackDepth : rollbackDepths)
+            {
+                const auto result = MeasurePrediction(workload.script, static_cast<game::InputPredictorType>(type), rollbackDepth);
+                fmt::print("{:>12} {:>12} {:>6} {:>10.3f} {:>12}\n",
+                    workload.name, game::inputPredictorNames[type], rollbackDepth, result.hitRate, result.resimulatedFrameNmb);
+            }
+        }
+    }
+    return 0;
+}
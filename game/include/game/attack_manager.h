@@ -10,20 +10,21 @@ namespace game
  */
 struct Attack
 {
-    float remainingTime = 0.0f;
+    core::Scalar remainingTime = 0.0f;
     PlayerNumber playerNumber = INVALID_PLAYER;
 };
 
 class GameManager;
 
 /**
- * \brief BulletManager is a ComponentManager that holds all the Bullet in one place.
+ * \brief BulletManager is an ArenaComponentManager that holds all the Bullet in one place.
  * It will automatically destroy the Bullet when remainingTime is over.
  */
-class AttackManager : public core::ComponentManager<Attack, static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK)>
+class AttackManager : public core::ArenaComponentManager<Attack, static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK)>
 {
 public:
-    explicit AttackManager(core::EntityManager& entityManager, GameManager& gameManager);
+    AttackManager(core::EntityManager& entityManager, const core::ArenaComponentLayout<Attack>& layout, core::Arena& arena,
+        GameManager& gameManager);
     void FixedUpdate(sf::Time dt);
 private:
     GameManager& gameManager_;
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "maths/vec2.h"
+
+namespace game
+{
+/**
+ * \brief BroadphaseProxy is a struct that holds the axis-aligned bounds of a collider given to a BroadphaseInterface.
+ */
+struct BroadphaseProxy
+{
+    core::Vec2f min = core::Vec2f::zero();
+    core::Vec2f max = core::Vec2f::zero();
+};
+
+/**
+ * \brief ColliderPair is a pair of indices in the BroadphaseProxy array, the first one always lower than the second one.
+ */
+using ColliderPair = std::pair<std::size_t, std::size_t>;
+
+/**
+ * \brief BroadphaseInterface is an interface for the algorithms that find the pairs of colliders that may overlap,
+ * before the PhysicsManager tests them one by one.
+ * Pairs can be given in any order and with false positives, but every overlapping pair needs to be given once.
+ */
+class BroadphaseInterface
+{
+public:
+    virtual ~BroadphaseInterface() = default;
+    /**
+     * \brief FindPairs is a method that fills pairs with the pairs of proxies that may overlap.
+     * \param proxies are the bounds of all the colliders.
+     * \param pairs is cleared and filled with the candidate pairs.
+     */
+    virtual void FindPairs(const std::vector<BroadphaseProxy>& proxies, std::vector<ColliderPair>& pairs) = 0;
+};
+
+/**
+ * \brief SweepAndPruneBroadphase is a BroadphaseInterface that sorts the proxies along the x axis and sweeps them,
+ * only testing the proxies whose x ranges overlap. It suits the mostly horizontal arena.
+ */
+class SweepAndPruneBroadphase final : public BroadphaseInterface
+{
+public:
+    void FindPairs(const std::vector<BroadphaseProxy>& proxies, std::vector<ColliderPair>& pairs) override;
+private:
+    std::vector<std::size_t> sortedProxies_;
+    std::vector<std::size_t> activeProxies_;
+};
+
+/**
+ * \brief UniformGridBroadphase is a BroadphaseInterface that puts the proxies in the cells of a uniform grid they cover,
+ * and only tests the proxies sharing a cell.
+ */
+class UniformGridBroadphase final : public BroadphaseInterface
+{
+public:
+    explicit UniformGridBroadphase(core::Scalar cellSize = 1.0f);
+    void FindPairs(const std::vector<BroadphaseProxy>& proxies, std::vector<ColliderPair>& pairs) override;
+private:
+    /**
+     * \brief CellEntry is a struct that links a grid cell to a proxy covering it.
+     */
+    struct CellEntry
+    {
+        std::int64_t cell = 0;
+        std::size_t proxy = 0;
+    };
+    core::Scalar cellSize_;
+    std::vector<CellEntry> cellEntries_;
+};
+}
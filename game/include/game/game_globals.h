@@ -5,11 +5,13 @@
 #pragma once
 #include <SFML/Graphics/Color.hpp>
 #include <array>
+#include <chrono>
 
 #include "engine/component.h"
 #include "engine/entity.h"
 #include "graphics/color.h"
 #include "maths/angle.h"
+#include "maths/fixed.h"
 #include "maths/vec2.h"
 
 
@@ -31,34 +33,107 @@ constexpr auto INVALID_PLAYER = std::numeric_limits<PlayerNumber>::max();
 enum class ClientId : std::uint16_t {};
 constexpr auto INVALID_CLIENT_ID = ClientId{ 0 };
 using Frame = std::uint32_t;
+/**
+ * \brief INVALID_FRAME is a constant that defines an invalid or unset frame.
+ */
+constexpr auto INVALID_FRAME = std::numeric_limits<Frame>::max();
 /**
  * \brief maxPlayerNmb is a integer constant that defines the maximum number of player per game
  */
 constexpr std::uint32_t maxPlayerNmb = 2;
 constexpr short playerHealth = 5;
-constexpr float playerSpeed = 2.0f;
-constexpr float playerJumpSpeed = 3.0f;
-constexpr float playerJumpFlyTime = 0.4f;
-constexpr float playerDashTime = 0.2f;
-constexpr float playerDashSpeed = 10.0f;
-constexpr float playerStunLength = 2.0f;
+//The simulation constants are core::Scalar, fixed-point numbers when compiled with GPR_FIXED_POINT
+constexpr core::Scalar playerSpeed = 2.0f;
+constexpr core::Scalar playerJumpSpeed = 3.0f;
+constexpr core::Scalar playerJumpFlyTime = 0.4f;
+constexpr core::Scalar playerDashTime = 0.2f;
+constexpr core::Scalar playerDashSpeed = 10.0f;
+constexpr core::Scalar playerStunLength = 2.0f;
 constexpr core::Degree playerAngularSpeed = core::Degree(90.0f);
-constexpr float playerShootingPeriod = 0.3f;
-constexpr float attackScale = 0.2f;
-constexpr float attackPeriod = 0.75f;
-constexpr float playerInvincibilityPeriod = 1.5f;
+constexpr core::Scalar playerShootingPeriod = 0.3f;
+constexpr core::Scalar attackScale = 0.2f;
+constexpr core::Scalar attackPeriod = 0.75f;
+constexpr core::Scalar playerInvincibilityPeriod = 1.5f;
 constexpr float invincibilityFlashPeriod = 0.5f;
-constexpr float groundLevel = -2.0f;
-constexpr float timeToDoubleClick = 0.25f;
+constexpr core::Scalar groundLevel = -2.0f;
+constexpr core::Scalar timeToDoubleClick = 0.25f;
 constexpr core::Vec2f gravity{ 0.0f,-9.81f };
-constexpr float respawnDistance = 4.0f;
+constexpr core::Scalar respawnDistance = 4.0f;
 constexpr float animationPeriod = 1.0f;
     
 
 /**
- * \brief windowBufferSize is the size of input stored by a client. 5 seconds of frame at 50 fps
+ * \brief windowBufferSize is the initial number of frames of input and snapshots stored by the game::RollbackManager.
+ * 5 seconds of frame at 50 fps, the window grows when the validated frame lags further behind.
  */
 constexpr std::size_t windowBufferSize = 5u * 50u;
+/**
+ * \brief maxWindowBufferSize is the maximum number of frames of input and snapshots stored by the game::RollbackManager.
+ * 30 seconds of frame at 50 fps, the inputs after it are rejected and a player stalled for that long is treated as disconnected.
+ */
+constexpr std::size_t maxWindowBufferSize = 6u * windowBufferSize;
+/**
+ * \brief worldArenaInitCapacity is the number of entities the world arenas of the game::RollbackManager can hold before growing
+ */
+constexpr std::size_t worldArenaInitCapacity = 32u;
+/**
+ * \brief sendComponentChecksums tells if the server sends the checksum of each component array with the world checksum,
+ * such that the clients can tell which component array is in desync
+ */
+constexpr bool sendComponentChecksums = true;
+
+/**
+ * \brief frameAdvantageSmoothing is the weight of a new sample in the moving average of the frame advantage of a client.
+ */
+constexpr float frameAdvantageSmoothing = 0.1f;
+/**
+ * \brief frameAdvantageDeadZone is the frame advantage in frames under which a client does not correct its time.
+ */
+constexpr float frameAdvantageDeadZone = 1.0f;
+/**
+ * \brief timeDilationPerFrame is the ratio a client slows down (or speeds up) its fixed updates by per frame of advantage (or delay).
+ */
+constexpr float timeDilationPerFrame = 0.01f;
+/**
+ * \brief maxTimeDilation is the maximum ratio a client slows down or speeds up its fixed updates by, such that the correction stays unnoticed.
+ */
+constexpr float maxTimeDilation = 0.05f;
+/**
+ * \brief maxInputDelay is the maximum number of frames a client can delay its local inputs by to reduce the rollback depth.
+ */
+constexpr Frame maxInputDelay = 8u;
+
+/**
+ * \brief maxSimulatedFramesPerUpdate is the maximum number of frames a client simulates per render frame.
+ * A longer rollback is spread over the next render frames, which keep showing the last fully simulated frame.
+ */
+constexpr Frame maxSimulatedFramesPerUpdate = 8u;
+/**
+ * \brief simulationTimeBudget is the time after which a client stops simulating frames in a render frame.
+ */
+constexpr std::chrono::microseconds simulationTimeBudget{ 4000 };
+/**
+ * \brief maxIncompleteSimulationNmb is the number of consecutive render frames a rollback can be spread over.
+ * The next render frame simulates the whole rollback, such that new mispredictions cannot keep discarding the partial progress.
+ */
+constexpr std::uint32_t maxIncompleteSimulationNmb = 4u;
+/**
+ * \brief useSimulationThread runs the client fixed-step simulation and the rollbacks on a dedicated thread.
+ * The render thread then only draws the last published frame, so a long rollback or a vsync stall never delays the other one.
+ */
+constexpr bool useSimulationThread = false;
+/**
+ * \brief receivedPacketQueueSize is the number of received packets waiting for the simulation thread to apply them.
+ */
+constexpr std::size_t receivedPacketQueueSize = 256u;
+/**
+ * \brief speculativeBranchNmb is the number of alternative inputs of the next remote input simulated in advance by the client on worker threads, 0 to disable it.
+ */
+constexpr std::size_t speculativeBranchNmb = 0u;
+/**
+ * \brief speculationHistoryFrameNmb is the number of received frames looked at to rank the buttons a player changes the most.
+ */
+constexpr Frame speculationHistoryFrameNmb = 32u;
 
 /**
  * \brief startDelay is the delay to wait before starting a game in milliseconds
@@ -72,6 +147,11 @@ constexpr std::size_t maxInputNmb = 50;
  * \brief fixedPeriod is the period used in seconds to start a new FixedUpdate method in the game::GameManager
  */
 constexpr float fixedPeriod = 0.02f; //50fps
+/**
+ * \brief serverTickPeriod is the period in seconds between two validations of the server.
+ * The inputs received during a tick are all applied before validating, such that each tick sends at most one ValidateFramePacket.
+ */
+constexpr float serverTickPeriod = fixedPeriod;
 
 
 constexpr std::array<core::Color, std::max(4u, maxPlayerNmb)> playerColors
@@ -125,4 +205,10 @@ enum PlayerInput : std::uint8_t
     ATTACK = 1u << 4u,
 };
 }
+/**
+ * \brief playerInputBitNmb is the number of bits used by the PlayerInputEnum flags, the size of a packed input.
+ */
+constexpr std::uint8_t playerInputBitNmb = 5u;
+constexpr PlayerInput playerInputMask = (1u << playerInputBitNmb) - 1u;
+static_assert(PlayerInputEnum::ATTACK <= playerInputMask, "All the input flags need to fit in a packed input");
 }
@@ -1,4 +1,8 @@
 #pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/View.hpp>
@@ -10,12 +14,15 @@
 #include "game_globals.h"
 #include "rollback_manager.h"
 #include "star_background.h"
+#include "time_sync.h"
 #include "engine/entity.h"
 #include "graphics/graphics.h"
 #include "graphics/sprite.h"
 #include "engine/system.h"
 #include "engine/transform.h"
 #include "network/packet_type.h"
+#include "utils/spsc_queue.h"
+#include "utils/triple_buffer.h"
 
 namespace game
 {
@@ -27,11 +34,16 @@ class PacketSenderInterface;
 class GameManager
 {
 public:
-    GameManager();
+    /**
+     * \brief Constructor of the GameManager.
+     * \param worldMode is WorldMode::VALIDATED for the server, that only advances the validated world and has no transforms.
+     */
+    explicit GameManager(WorldMode worldMode = WorldMode::ROLLBACK);
     virtual ~GameManager() = default;
     virtual void SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position);
     virtual core::Entity SpawnAttack(PlayerNumber, core::Vec2f position);
     virtual void DestroyAttackBox(core::Entity entity);
+    core::Entity SpawnPlatform(core::Vec2f position, core::Vec2f extends);
     [[nodiscard]] core::Entity GetEntityFromPlayerNumber(PlayerNumber playerNumber) const;
     [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
     [[nodiscard]] Frame GetLastValidateFrame() const { return rollbackManager_.GetLastValidateFrame(); }
@@ -47,6 +59,10 @@ public:
 
 
 protected:
+    /**
+     * \brief HasTransforms is a method that returns false when the game is only validated, as nothing is drawn.
+     */
+    [[nodiscard]] bool HasTransforms() const { return rollbackManager_.GetWorldMode() == WorldMode::ROLLBACK; }
     core::EntityManager entityManager_;
     core::TransformManager transformManager_;
     RollbackManager rollbackManager_;
@@ -67,7 +83,24 @@ public:
         STARTED = 1u << 0u,
         FINISHED = 1u << 1u,
     };
+    /**
+     * \brief RenderState is everything needed to draw a frame of the game, copied from the simulation.
+     */
+    struct RenderState
+    {
+        core::SpriteBuffer sprites;
+        sf::View cameraView;
+        std::string healthText;
+        std::uint32_t state = 0;
+        /**
+         * \brief playerNumber is the client player, set by the packets applied on the simulation thread.
+         */
+        PlayerNumber playerNumber = INVALID_PLAYER;
+        PlayerNumber winner = INVALID_PLAYER;
+        unsigned long long startingTime = 0;
+    };
     explicit ClientGameManager(PacketSenderInterface& packetSenderInterface);
+    ~ClientGameManager() override;
     void StartGame(unsigned long long int startingTime);
     void Begin() override;
     void Update(sf::Time dt) override;
@@ -84,26 +117,126 @@ public:
     void SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position) override;
     core::Entity SpawnAttack(PlayerNumber playerNumber, core::Vec2f position) override;
     void FixedUpdate();
+    /**
+     * \brief SetPlayerInput is a method that sets the input of a player on a frame.
+     * The input of the client player is sampled on this frame and written on GetLocalInputFrame(inputFrame),
+     * it is ignored when that frame was already sent.
+     */
     void SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame) override;
     void DrawImGui() override;
-    void ConfirmValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& physicsStates);
+    /**
+     * \brief SetRoundTripTime is a method called by the client when it measures a new smoothed round trip time to the server.
+     * \param rtt is the round trip time in milliseconds
+     */
+    void SetRoundTripTime(float rtt) { rtt_ = rtt; }
+    /**
+     * \brief AcknowledgeInputs is a method called by the client when the server received all the local inputs until ackFrame.
+     * The next input packets start from the frame after the acknowledged frame.
+     */
+    void AcknowledgeInputs(Frame ackFrame) { inputAckFrame_ = std::max(inputAckFrame_, ackFrame); }
+    /**
+     * \brief SetInputRedundancy is a method that sets the maximum number of local inputs sent in a packet, between 1 and maxInputNmb.
+     * The inputs after it are only sent once the server acknowledged the first ones.
+     */
+    void SetInputRedundancy(Frame inputRedundancy);
+    /**
+     * \brief SetInputDelay is a method that delays the local inputs by a number of frames, up to maxInputDelay.
+     * The input sampled on a frame is sent inputDelay frames before the frame it is applied on,
+     * such that the remote players receive it earlier compared to that frame, which reduces their rollback depth.
+     */
+    void SetInputDelay(Frame inputDelay);
+    [[nodiscard]] Frame GetInputDelay() const { return inputDelay_; }
+    /**
+     * \brief GetLocalInputFrame is a method that gives the frame the local input sampled on sampledFrame is applied on.
+     */
+    [[nodiscard]] Frame GetLocalInputFrame(Frame sampledFrame) const { return sampledFrame + inputDelay_; }
+    /**
+     * \brief SetRemoteInputDelay is a method called by the client when receiving the inputs of a remote player,
+     * its last received frame is that many frames ahead of its current frame.
+     */
+    void SetRemoteInputDelay(PlayerNumber playerNumber, Frame inputDelay) { remoteInputDelays_[playerNumber] = inputDelay; }
+    [[nodiscard]] const TimeSync& GetTimeSync() const { return timeSync_; }
+    /**
+     * \brief SetInputPredictor is a method that changes the algorithm predicting the remote inputs not received yet.
+     */
+    void SetInputPredictor(InputPredictorType inputPredictorType);
+    void ConfirmValidateFrame(Frame newValidateFrame, const WorldChecksum& worldChecksum);
     [[nodiscard]] PlayerNumber GetPlayerNumber() const { return clientPlayer_; }
     void WinGame(PlayerNumber winner) override;
     [[nodiscard]] std::uint32_t GetState() const { return state_; }
     [[nodiscard]] const AnimationManager& GetAnimationManager() const { return animationManager_; }
+    /**
+     * \brief StartSimulationThread is a method that moves the fixed-step simulation and the rollbacks to a dedicated thread.
+     * The local input is sampled with inputSampler by the simulation thread, right before each fixed update,
+     * and Update and Draw only show the last render state published by the simulation thread.
+     * While the thread runs, the render thread only pushes the received packets with PushReceivedPacket
+     * and the window size with SetWindowSize, the simulation thread gives the packets to packetReceiver before each update.
+     */
+    void StartSimulationThread(std::function<PlayerInput()> inputSampler, std::function<void(const Packet&)> packetReceiver);
+    void StopSimulationThread();
+    [[nodiscard]] bool IsSimulationThreaded() const { return simulationThread_.joinable(); }
+    /**
+     * \brief PushReceivedPacket is a method called by the render thread to pass a received packet to the simulation thread.
+     * \return false when the queue is full, the packet needs to be pushed again later
+     */
+    bool PushReceivedPacket(const Packet& packet) { return receivedPackets_.TryPush(packet); }
 protected:
+    /**
+     * \brief UpdateSimulation is a method that simulates the rollbacks and the fixed updates elapsed during dt.
+     * \return false when the rollback is spread over the next updates because of the simulation budget
+     */
+    bool UpdateSimulation(sf::Time dt);
+    /**
+     * \brief RunSimulationThread is the loop of the simulation thread, sleeping until the next fixed update when caught up.
+     */
+    void RunSimulationThread();
+    void FillRenderState(RenderState& renderState);
+    /**
+     * \brief ApplyWindowSize is a method that gives the window size to the simulated world and its camera.
+     */
+    void ApplyWindowSize(sf::Vector2u windowSize);
 
     void UpdateCameraView();
+    /**
+     * \brief SetLocalInput is a method that sets the local input of a frame after lastLocalInputFrame_,
+     * the frames skipped since lastLocalInputFrame_ repeat its input.
+     */
+    void SetLocalInput(PlayerInput playerInput, Frame inputFrame);
+    /**
+     * \brief UpdateTimeSync is a method that adds a frame advantage sample on the remote players at the start of a new frame.
+     */
+    void UpdateTimeSync();
 
     PacketSenderInterface& packetSenderInterface_;
     sf::Vector2u windowSize_;
     sf::View originalView_;
+    /**
+     * \brief simulationView_ is the originalView_ of the simulation thread, the camera view is zoomed out from it.
+     */
+    sf::View simulationView_;
     sf::View cameraView_;
     PlayerNumber clientPlayer_ = INVALID_PLAYER;
     core::SpriteManager spriteManager_;
     AnimationManager animationManager_;
     StarBackground starBackground_;
     float fixedTimer_ = 0.0f;
+    /**
+     * \brief rtt_ is the last smoothed round trip time to the server in milliseconds.
+     */
+    float rtt_ = 0.0f;
+    TimeSync timeSync_;
+    Frame inputDelay_ = 0;
+    /**
+     * \brief lastLocalInputFrame_ is the last frame whose local input was sent, the local inputs until it cannot change anymore.
+     */
+    Frame lastLocalInputFrame_ = 0;
+    std::array<Frame, maxPlayerNmb> remoteInputDelays_{};
+    /**
+     * \brief inputAckFrame_ is the last frame until which the server acknowledged all the local inputs.
+     */
+    Frame inputAckFrame_ = 0;
+    Frame inputRedundancy_ = maxInputNmb;
+    InputPredictorType inputPredictorType_ = InputPredictorType::REPEAT_LAST;
     unsigned long long startingTime_ = 0;
     std::uint32_t state_ = 0;
 
@@ -113,5 +246,24 @@ protected:
 
     sf::Text textRenderer_;
     bool drawPhysics_ = false;
+
+    /**
+     * \brief renderStates_ passes the render states from the simulation to the render thread.
+     * Without simulation thread, it is filled and read by the render thread alone.
+     */
+    core::TripleBuffer<RenderState> renderStates_;
+    /**
+     * \brief windowSizes_ passes the window size from the render thread to the simulation thread.
+     */
+    core::TripleBuffer<sf::Vector2u> windowSizes_;
+    /**
+     * \brief receivedPackets_ passes the received packets from the render thread to the simulation thread.
+     */
+    core::SpscQueue<Packet, receivedPacketQueueSize> receivedPackets_;
+    std::thread simulationThread_;
+    std::mutex simulationMutex_;
+    std::atomic<bool> isSimulationRunning_ = false;
+    std::function<PlayerInput()> inputSampler_;
+    std::function<void(const Packet&)> packetReceiver_;
 };
 }
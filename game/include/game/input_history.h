@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "game/game_globals.h"
+
+namespace game
+{
+/**
+ * \brief InputHistory is a class that stores the inputs of one player in a ring buffer indexed by frame modulo its capacity.
+ * Each input is packed on playerInputBitNmb bits, with a separate bit telling if it was received or is still a prediction.
+ * Starting a new frame only writes the new frames, it does not move the stored ones.
+ */
+class InputHistory
+{
+public:
+    InputHistory() : InputHistory(windowBufferSize) {}
+    explicit InputHistory(std::size_t capacity);
+    [[nodiscard]] std::size_t GetCapacity() const { return capacity_; }
+    [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
+    /**
+     * \brief Contains is a method that tells if the input of the frame is still stored,
+     * between capacity - 1 frames before the current frame and the current frame.
+     */
+    [[nodiscard]] bool Contains(Frame frame) const;
+    [[nodiscard]] PlayerInput GetInput(Frame frame) const;
+    void SetInput(Frame frame, PlayerInput playerInput);
+    [[nodiscard]] bool IsReceived(Frame frame) const;
+    void SetReceived(Frame frame);
+    /**
+     * \brief StartNewFrame is a method that moves the current frame forward.
+     * The new frames repeat the input of the previous current frame and are not received.
+     * \param newFrame is the new current frame, nothing happens if it is not after the current frame
+     */
+    void StartNewFrame(Frame newFrame);
+    /**
+     * \brief Reserve is a method that grows the ring buffer, keeping the stored inputs of the last frames.
+     */
+    void Reserve(std::size_t capacity);
+private:
+    static constexpr std::size_t inputsPerWord = 64u / playerInputBitNmb;
+    [[nodiscard]] std::size_t GetSlot(Frame frame) const { return frame % capacity_; }
+    void WriteInput(std::size_t slot, PlayerInput playerInput);
+    void SetSlot(std::size_t slot, PlayerInput playerInput, bool received);
+
+    std::size_t capacity_ = 0;
+    Frame currentFrame_ = 0;
+    std::vector<std::uint64_t> inputs_;
+    std::vector<std::uint64_t> receivedInputs_;
+};
+}
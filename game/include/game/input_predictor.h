@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <memory>
+
+#include "game/game_globals.h"
+#include "game/input_history.h"
+
+namespace game
+{
+/**
+ * \brief InputPredictorInterface is an interface for the algorithms that guess the input of a player
+ * on the frames after its last received input, simulated by the RollbackManager before receiving them.
+ * A misprediction does not change the validated world, it only costs the resimulation of the frames after it.
+ */
+class InputPredictorInterface
+{
+public:
+    virtual ~InputPredictorInterface() = default;
+    /**
+     * \brief Predict is a method that gives the predicted input of a player on a frame.
+     * \param inputs is the input history of the player, only the frames until lastReceivedFrame are received
+     * \param lastReceivedFrame is the last frame whose input was received
+     * \param frame is the predicted frame, after lastReceivedFrame
+     */
+    [[nodiscard]] virtual PlayerInput Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame frame) = 0;
+};
+
+/**
+ * \brief RepeatLastInputPredictor is an InputPredictorInterface that repeats the last received input.
+ * It is the default choice: most inputs are held for several frames, so it is only wrong after an input change.
+ */
+class RepeatLastInputPredictor final : public InputPredictorInterface
+{
+public:
+    [[nodiscard]] PlayerInput Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame frame) override;
+};
+
+/**
+ * \brief FrequencyInputPredictor is an InputPredictorInterface that predicts each button in the state
+ * it was in for most of the last windowFrameNmb received frames.
+ * Pick it for a mashed button that flickers from frame to frame, where the last input is a coin toss but the majority is not.
+ * It lags windowFrameNmb / 2 frames behind every real change, so it loses to RepeatLastInputPredictor on held inputs.
+ */
+class FrequencyInputPredictor final : public InputPredictorInterface
+{
+public:
+    explicit FrequencyInputPredictor(Frame windowFrameNmb = 16u);
+    [[nodiscard]] PlayerInput Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame frame) override;
+private:
+    Frame windowFrameNmb_;
+};
+
+/**
+ * \brief ButtonHoldInputPredictor is an InputPredictorInterface that looks at how long each button is held.
+ * A released button stays released. A pressed button stays pressed, except when the previous press of the same button
+ * was a tap (shorter than timeToDoubleClick, like the first tap of a dash double click):
+ * the current press is then predicted to be released after the same number of frames.
+ * Pick it for the dash double taps, it predicts long holds like RepeatLastInputPredictor,
+ * but it mistakes a mashed button for a stream of taps.
+ */
+class ButtonHoldInputPredictor final : public InputPredictorInterface
+{
+public:
+    [[nodiscard]] PlayerInput Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame frame) override;
+};
+
+/**
+ * \brief InputPredictorType is the list of the available InputPredictorInterface implementations.
+ */
+enum class InputPredictorType : std::uint8_t
+{
+    REPEAT_LAST = 0u,
+    FREQUENCY,
+    BUTTON_HOLD,
+    LENGTH
+};
+constexpr std::size_t inputPredictorTypeNmb = static_cast<std::size_t>(InputPredictorType::LENGTH);
+constexpr std::array<const char*, inputPredictorTypeNmb> inputPredictorNames{ "repeat last", "frequency", "button hold" };
+
+/**
+ * \brief CreateInputPredictor is a function that creates a new InputPredictorInterface of the given type.
+ */
+std::unique_ptr<InputPredictorInterface> CreateInputPredictor(InputPredictorType type);
+}
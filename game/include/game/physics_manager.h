@@ -1,5 +1,11 @@
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "broadphase.h"
 #include "game_globals.h"
+#include "engine/arena.h"
 #include "engine/component.h"
 #include "engine/entity.h"
 #include "maths/angle.h"
@@ -8,7 +14,6 @@
 #include <SFML/System/Time.hpp>
 
 #include "graphics/graphics.h"
-#include "utils/action_utility.h"
 
 namespace core
 {
@@ -17,7 +22,7 @@ class TransformManager;
 
 namespace game
 {
-enum class BodyType
+enum class BodyType : std::uint8_t
 {
     DYNAMIC,
     KINEMATIC,
@@ -48,88 +53,162 @@ struct Box
 };
 
 /**
- * \brief OnTriggerInterface is an interface for classes that needs to be called when two boxes are in contact.
- * It needs to be registered in the PhysicsManager.
+ * \brief Contact is a struct that represents two boxes in contact found by the narrow-phase, entity1 being the smaller Entity.
  */
-class OnTriggerInterface
+struct Contact
 {
-public:
-    virtual ~OnTriggerInterface() = default;
-    virtual void OnTrigger(core::Entity entity1, core::Entity entity2) = 0;
+    core::Entity entity1 = core::INVALID_ENTITY;
+    core::Entity entity2 = core::INVALID_ENTITY;
+};
+
+/**
+ * \brief BodyArenaLayout is a struct that describes the bodies stored in an Arena, each field in a separate array (structure of arrays)
+ * sorted by Entity, such that the physics kernels stream each field contiguously and can be vectorised by the compiler.
+ */
+struct BodyArenaLayout
+{
+    explicit BodyArenaLayout(core::ArenaLayout& layout);
+    core::ArenaSparseSet sparseSet;
+    core::ArenaArray positions;
+    core::ArenaArray velocities;
+    core::ArenaArray angularVelocities;
+    core::ArenaArray rotations;
+    core::ArenaArray bodyTypes;
+    core::ArenaArray affectedByGravity;
 };
 
 /**
- * \brief BodyManager is a ComponentManager that holds all the Body in the world.
+ * \brief BodyManager is a class that holds all the Body of a world in the arrays of a BodyArenaLayout.
+ * Bodies are given by value as they are rebuilt from the separate arrays.
  */
-class BodyManager : public core::ComponentManager<Body, static_cast<core::EntityMask>(core::ComponentType::BODY2D)>
+class BodyManager
 {
 public:
-    using ComponentManager::ComponentManager;
+    static constexpr core::Component componentType = static_cast<core::EntityMask>(core::ComponentType::BODY2D);
+
+    BodyManager(core::EntityManager& entityManager, const BodyArenaLayout& layout, core::Arena& arena);
+    void AddComponent(core::Entity entity);
+    void RemoveComponent(core::Entity entity);
+    [[nodiscard]] Body GetComponent(core::Entity entity) const;
+    [[nodiscard]] core::Vec2f GetPosition(core::Entity entity) const;
+    void SetComponent(core::Entity entity, const Body& body);
+    /**
+     * \brief Integrate is a method that moves the dynamic and kinematic bodies from their velocity, and stops the static bodies.
+     * \param dt is the fixed delta time in seconds
+     */
+    void Integrate(core::Scalar dt);
+    /**
+     * \brief ResolveGravityAndGround is a method that adds the gravity to the bodies affected by it
+     * and keeps them above the ground in the same pass.
+     * \param dt is the fixed delta time in seconds
+     */
+    void ResolveGravityAndGround(core::Scalar dt);
+private:
+    [[nodiscard]] Body GetBody(std::size_t index) const;
+    void SetBody(std::size_t index, const Body& body);
+    /**
+     * \brief UpdateSimulatedBodies is a method that flags the stored bodies whose entity still has the Body component,
+     * the kernels select on those flags instead of branching.
+     */
+    void UpdateSimulatedBodies();
+
+    core::EntityManager& entityManager_;
+    const BodyArenaLayout& layout_;
+    core::Arena& arena_;
+    std::vector<std::uint8_t> simulatedBodies_;
 };
 
 /**
- * \brief BoxManager is a ComponentManager that holds all the Box in the world.
+ * \brief BoxManager is an ArenaComponentManager that holds all the Box in the world.
  */
-class BoxManager : public core::ComponentManager<Box, static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)>
+class BoxManager : public core::ArenaComponentManager<Box, static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)>
 {
 public:
-    using ComponentManager::ComponentManager;
+    using ArenaComponentManager::ArenaComponentManager;
+};
+
+/**
+ * \brief PhysicsArenaLayout is a struct that describes the bodies and the boxes stored in an Arena.
+ */
+struct PhysicsArenaLayout
+{
+    explicit PhysicsArenaLayout(core::ArenaLayout& layout) : bodies(layout), boxes(layout)
+    {
+    }
+    BodyArenaLayout bodies;
+    core::ArenaComponentLayout<Box> boxes;
 };
 
 /**
  * \brief PhysicsManager is a class that holds both BodyManager and BoxManager and manages the physics fixed update.
- * It allows to register OnTriggerInterface to be called when a trigger occcurs.
+ * The contacts of a fixed update are written in a buffer reused from frame to frame and given to a contact listener in one batch.
  */
 class PhysicsManager : public core::DrawInterface
 {
 public:
-    explicit PhysicsManager(core::EntityManager& entityManager);
-    void FixedUpdate(sf::Time dt);
-    [[nodiscard]] const Body& GetBody(core::Entity entity) const;
+    /**
+     * \brief Constructor of the PhysicsManager, whose bodies and boxes are stored in the given Arena.
+     * \param layout describes the physics arrays in the Arena, it needs to outlive the PhysicsManager.
+     * \param arena is the world Arena, it needs to be reserved for an Entity before adding its body or box.
+     */
+    PhysicsManager(core::EntityManager& entityManager, const PhysicsArenaLayout& layout, core::Arena& arena);
+    /**
+     * \brief FixedUpdate is a method that moves the bodies, finds the boxes in contact
+     * and gives them to contactListener.OnContacts(const std::vector<Contact>&) before applying the gravity.
+     * The listener is a template argument such that the contacts are dispatched without any type-erased call.
+     */
+    template<typename ContactListener>
+    void FixedUpdate(sf::Time dt, ContactListener& contactListener);
+    [[nodiscard]] Body GetBody(core::Entity entity) const;
     void SetBody(core::Entity entity, const Body& body);
     void AddBody(core::Entity entity);
+    void RemoveBody(core::Entity entity);
 
     void AddBox(core::Entity entity);
+    void RemoveBox(core::Entity entity);
     void SetBox(core::Entity entity, const Box& box);
     [[nodiscard]] const Box& GetBox(core::Entity entity) const;
     /**
-     * \brief RegisterTriggerListener is a method that stores an OnTriggerInterface in the PhysicsManager that will call the OnTrigger method in case of a trigger.
-     * \param onTriggerInterface is the OnTriggerInterface to be called when a trigger occurs.
+     * \brief IsInContact is a method that tests the boxes of two entities at the current positions of their bodies.
+     */
+    [[nodiscard]] bool IsInContact(core::Entity entity1, core::Entity entity2) const;
+    /**
+     * \brief SetBroadphase is a method that changes the algorithm finding the candidate pairs of colliders (SweepAndPruneBroadphase by default).
+     * The triggers order does not depend on the broadphase, it needs to be the same on the server and the clients.
      */
-    void RegisterTriggerListener(OnTriggerInterface& onTriggerInterface);
-    void CopyAllComponents(const PhysicsManager& physicsManager);
+    void SetBroadphase(std::unique_ptr<BroadphaseInterface> broadphase);
     void Draw(sf::RenderTarget& renderTarget) override;
     void SetCenter(sf::Vector2f center) { center_ = center; }
     void SetWindowSize(sf::Vector2f newWindowSize) { windowSize_ = newWindowSize; }
 private:
     /**
-     * \brief update position and rotation from the velocity of each entity of the PhysicsManager,
-     * and reset velocity to 0 for static object.
-     * \param dt is the delta time used for update correctly the translation
-     */
-    void UpdatePositionFromVelocity(sf::Time dt);
-    /**
-     * \brief Check if any collision occur, and resolve it
-     */
-    void ResolveCollision();
-    /**
-     * \brief check if all entity if they are affected by gravity, and adding the gravity to the entity affected
-     * \param dt is the delta time used for adding correctly the gravity
-     */
-    void ResolveGravity(sf::Time dt);
-    /**
-     * \brief check if any entity that is affected by gravity can't go underworld(below the map) and if tje entity
-     * is below, place the entity upward the ground and set is vertical velocity to 0.
+     * \brief FindContacts is a method that fills contacts_ with the boxes in contact.
+     * The broadphase gives the candidate pairs, that are tested with Box2Box and stored in ascending Entity order.
      */
-    void ResolveGround();
-
+    void FindContacts();
 
 	core::EntityManager& entityManager_;
     BodyManager bodyManager_;
     BoxManager boxManager_;
-    core::Action<core::Entity, core::Entity> onTriggerAction_;
+    std::unique_ptr<BroadphaseInterface> broadphase_;
+    //Reused between frames to avoid allocations
+    std::vector<core::Entity> colliderEntities_;
+    std::vector<BroadphaseProxy> colliderProxies_;
+    std::vector<ColliderPair> colliderPairs_;
+    std::vector<Contact> contacts_;
     //Used for debug
     sf::Vector2f center_{};
     sf::Vector2f windowSize_{};
 };
+
+template<typename ContactListener>
+void PhysicsManager::FixedUpdate(sf::Time dt, ContactListener& contactListener)
+{
+    //Contacts read the integrated positions and might change the velocities,
+    //so the integration and the gravity kernels are split around them
+    bodyManager_.Integrate(dt.asSeconds());
+    FindContacts();
+    contactListener.OnContacts(contacts_);
+    bodyManager_.ResolveGravityAndGround(dt.asSeconds());
+}
 }
@@ -26,13 +26,13 @@ class PhysicsManager;
  */
 struct PlayerCharacter
 {
-    float shootingTime = 0.0f;
+    core::Scalar shootingTime = 0.0f;
     PlayerInput input = 0u;
     PlayerNumber playerNumber = INVALID_PLAYER;
     short health = playerHealth;
-    float actualStateTime = 0.0f;
-    float doubleClickTimeRight = timeToDoubleClick + 1.0f;
-    float doubleClickTimeLeft = timeToDoubleClick + 1.0f;
+    core::Scalar actualStateTime = 0.0f;
+    core::Scalar doubleClickTimeRight = timeToDoubleClick + 1.0f;
+    core::Scalar doubleClickTimeLeft = timeToDoubleClick + 1.0f;
     PlayerState playerState = PlayerState::IDLE;
     
     /*
@@ -45,12 +45,13 @@ struct PlayerCharacter
 class GameManager;
 
 /**
- * \brief PlayerCharacterManager is a ComponentManager that holds all the PlayerCharacter in the game.
+ * \brief PlayerCharacterManager is an ArenaComponentManager that holds all the PlayerCharacter in the game.
  */
-class PlayerCharacterManager : public core::ComponentManager<PlayerCharacter, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)>
+class PlayerCharacterManager : public core::ArenaComponentManager<PlayerCharacter, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)>
 {
 public:
-    explicit PlayerCharacterManager(core::EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager);
+    PlayerCharacterManager(core::EntityManager& entityManager, const core::ArenaComponentLayout<PlayerCharacter>& layout,
+        core::Arena& arena, PhysicsManager& physicsManager, GameManager& gameManager);
     void FixedUpdate(sf::Time dt);
 
 	static void InitIdle(PlayerCharacter& playerCharacter);
@@ -1,17 +1,41 @@
 #pragma once
 #include "attack_manager.h"
 #include "game_globals.h"
+#include "input_history.h"
+#include "input_predictor.h"
 #include "physics_manager.h"
 #include "player_character.h"
 #include "engine/entity.h"
 #include "engine/transform.h"
 #include "network/packet_type.h"
 
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
 
 
 namespace game
 {
 class GameManager;
+class SpeculativeBranch;
+
+/**
+ * \brief WorldMode tells which copies of the world a RollbackManager keeps.
+ */
+enum class WorldMode : std::uint8_t
+{
+    /**
+     * \brief ROLLBACK keeps a predicted current world, the last validated world and a snapshot per frame of the window (clients).
+     */
+    ROLLBACK,
+    /**
+     * \brief VALIDATED only keeps the authoritative world, advanced forward by ValidateFrame when all inputs are received (server).
+     * It has no snapshot, no last validated copy and no transforms.
+     */
+    VALIDATED
+};
 
 /**
  * \brief CreatedEntity is a struct that contains information on the newly created entities.
@@ -20,72 +44,332 @@ class GameManager;
 struct CreatedEntity
 {
     core::Entity entity = core::INVALID_ENTITY;
+    /**
+     * \brief generation is the generation of the entity index at creation, used to detect an outdated record.
+     */
+    core::EntityGeneration generation = 0;
     Frame createdFrame = 0;
 };
 
+/**
+ * \brief DestroyedEntity is a struct that contains information on the entities flagged as destroyed.
+ * It is used by the RollbackManager to bring them back when going back before their destruction frame.
+ */
+struct DestroyedEntity
+{
+    core::Entity entity = core::INVALID_ENTITY;
+    Frame destroyedFrame = 0;
+};
+
+/**
+ * \brief PredictionStats is a struct that counts how many predicted inputs of a player were confirmed or mispredicted
+ * when receiving the real inputs of already simulated frames.
+ */
+struct PredictionStats
+{
+    std::uint32_t confirmationNmb = 0;
+    std::uint32_t mispredictionNmb = 0;
+    /**
+     * \brief GetHitRate is a method that gives the ratio of confirmed predictions, 1 when nothing was predicted yet.
+     */
+    [[nodiscard]] float GetHitRate() const
+    {
+        const auto predictionNmb = confirmationNmb + mispredictionNmb;
+        return predictionNmb == 0 ? 1.0f : static_cast<float>(confirmationNmb) / static_cast<float>(predictionNmb);
+    }
+};
+
+/**
+ * \brief SpeculationStats is a struct that counts the speculative branches simulated on worker threads
+ * and how many of them were adopted instead of simulating their frames again.
+ */
+struct SpeculationStats
+{
+    std::uint32_t branchNmb = 0;
+    std::uint32_t adoptionNmb = 0;
+    std::uint32_t adoptedFrameNmb = 0;
+};
+
+/**
+ * \brief SimulationBudget is a struct that limits the work of one RollbackManager::SimulateToCurrentFrame call.
+ * A zero value means no limit.
+ */
+struct SimulationBudget
+{
+    Frame maxFrameNmb = 0;
+    std::chrono::microseconds maxDuration{ 0 };
+};
+
+/**
+ * \brief WorldArenaLayout is a struct that describes the rollback component arrays of a world stored in one Arena.
+ * The current world, the last validated world and the frame snapshots are Arenas with this layout,
+ * such that saving or restoring a frame is a single copy without any allocation.
+ */
+struct WorldArenaLayout
+{
+    WorldArenaLayout() : physics(layout), playerCharacters(layout), attacks(layout)
+    {
+    }
+    /**
+     * \brief RemoveEntity is a method that removes all the rollback components of an Entity from a world Arena.
+     * It does not change the EntityManager, as the snapshots share it with the current world.
+     */
+    void RemoveEntity(core::Arena& arena, core::Entity entity) const;
+    /**
+     * \brief ComputeChecksum is a method that hashes the stored components of a world Arena, each component array on its own.
+     * Only the used part of the arrays is hashed and the entities are left out, such that the checksum depends neither
+     * on the capacity of the Arena nor on the entities the server and the clients gave to the same components.
+     * The components of the players are hashed with their PlayerNumber instead, such that swapping them changes the checksum.
+     */
+    [[nodiscard]] WorldChecksum ComputeChecksum(const core::Arena& arena) const;
+    core::ArenaLayout layout;
+    PhysicsArenaLayout physics;
+    core::ArenaComponentLayout<PlayerCharacter> playerCharacters;
+    core::ArenaComponentLayout<Attack> attacks;
+};
+
 /**
  * \brief RollbackManager is a class that manages all the rollback mechanisms of the game.
- * It contains two copies of the world (PhysicsManager, TransformManager, etc...), the current one and the validated one.
- * When receiving new information, it can reupdate the current copy of the world.
+ * It contains two copies of the world (PhysicsManager, TransformManager, etc...), the current one and the validated one,
+ * whose rollback components are stored in a world Arena each.
+ * It also keeps a snapshot Arena of the world for each frame of the window between the validated frame and the current frame,
+ * such that when receiving new information, it only reupdates the current copy of the world from the earliest changed frame.
+ * In WorldMode::VALIDATED, the current world is the validated world and the other copies are left empty.
  */
-class RollbackManager final : public OnTriggerInterface
+class RollbackManager final
 {
+    friend class SpeculativeBranch;
 public:
-    explicit RollbackManager(GameManager& gameManager, core::EntityManager& entityManager);
     /**
-     * \brief SimulateToCurrentFrame is a method that simulates all players with new inputs, method call only by the clients to update the current state of the visuals
+     * \brief Constructor of the RollbackManager.
+     * \param windowCapacity is the initial number of frames of inputs and snapshots stored,
+     * the window grows up to maxWindowBufferSize frames when the validated frame lags further behind the current frame.
+     * \param worldMode tells if the world can be rollbacked (clients) or only validated (server).
      */
-    void SimulateToCurrentFrame();
+    explicit RollbackManager(GameManager& gameManager, core::EntityManager& entityManager,
+        std::size_t windowCapacity = windowBufferSize, WorldMode worldMode = WorldMode::ROLLBACK);
+    ~RollbackManager();
+    /**
+     * \brief SimulateToCurrentFrame is a method that simulates all players with new inputs, method call only by the clients to update the current state of the visuals.
+     * It goes back to the snapshot before the earliest changed input frame and only simulates the frames after it.
+     * When no input changed, only the new frames are simulated.
+     * When the simulation budget is exceeded, the remaining frames are simulated by the next calls
+     * and the transforms keep the last fully simulated frame.
+     * After maxIncompleteSimulationNmb consecutive incomplete calls, the budget is ignored until the current frame is reached.
+     * It needs to be called only in WorldMode::ROLLBACK.
+     * \return true when the current frame is reached
+     */
+    bool SimulateToCurrentFrame();
+    /**
+     * \brief SetSimulationBudget is a method that limits the frames simulated by each SimulateToCurrentFrame call (no limit by default).
+     * A new misprediction can revert the frames simulated by the previous calls, so the budget is lifted
+     * after maxIncompleteSimulationNmb consecutive incomplete calls, such that the simulation always catches up.
+     */
+    void SetSimulationBudget(const SimulationBudget& simulationBudget) { simulationBudget_ = simulationBudget; }
+    [[nodiscard]] const SimulationBudget& GetSimulationBudget() const { return simulationBudget_; }
+    /**
+     * \brief GetSimulatedFrame is a method that gives the last frame simulated in the current world,
+     * behind the current frame while a rollback is spread over several calls.
+     */
+    [[nodiscard]] Frame GetSimulatedFrame() const { return simulatedFrame_; }
     /**
      * \brief SetPlayerInput is a method that set the input of a certain player on a certain game frame.
      * It can change an input between the last validated frame and the current frame.
      * It is called by the GameManager when receiving new inputs from packets.
+     * Only an input different from the stored (predicted) one marks the frame to be simulated again.
+     * An input after GetWindowEndFrame is rejected, such that a wrong frame number cannot grow the window.
+     * An input after the current frame only moves the input history of its player forward,
+     * a delayed local input or a remote input ahead of the game does not start the frames to simulate.
      * \param playerNumber is the player number whose input will change
      * \param playerInput is the new input
      * \param inputFrame is the game frame of the new input
      */
     void SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, Frame inputFrame);
+    /**
+     * \brief StartNewFrame is a method that moves the current frame forward, growing the window if needed.
+     * \param newFrame is the new current frame, it cannot be after GetWindowEndFrame
+     */
     void StartNewFrame(Frame newFrame);
     /**
      * \brief ValidateFrame is a method that validates all the frames from lastValidateFrame_ to newValidateFrame.
      * It changes lastValidateFrame_ to be newValidateFrame.
+     * In WorldMode::VALIDATED, the validated world is simulated forward from lastValidateFrame_ without any copy.
      * \param newValidateFrame is the new value of lastValidateFrame_
      */
     void ValidateFrame(Frame newValidateFrame);
     /**
-     * \brief ConfirmFrame is a method that confirms the new validate frame by checking the Physics State checksums
+     * \brief ConfirmFrame is a method that confirms the new validate frame by checking the world checksums
      * It is called by the clients when receiving Confirm Frame packet
      * \param newValidatedFrame is the new frame that is validated
-     * \param serverPhysicsState is the physics state given by the server through a packet
+     * \param serverChecksum is the world checksum given by the server through a packet,
+     * its component checksums tell which component arrays are in desync
      */
-    void ConfirmFrame(Frame newValidatedFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState);
-    [[nodiscard]] PhysicsState GetValidatePhysicsState(PlayerNumber playerNumber) const;
+    void ConfirmFrame(Frame newValidatedFrame, const WorldChecksum& serverChecksum);
+    /**
+     * \brief GetValidateChecksum is a method that gives the checksum of the last validated world, with its component breakdown.
+     * It is computed once per validated frame.
+     */
+    [[nodiscard]] const WorldChecksum& GetValidateChecksum() const { return lastValidateChecksum_; }
     [[nodiscard]] Frame GetLastValidateFrame() const { return lastValidateFrame_; }
     [[nodiscard]] Frame GetLastReceivedFrame(PlayerNumber playerNumber) const { return lastReceivedFrame_[playerNumber]; }
+    /**
+     * \brief GetLastContiguousFrame is a method that gives the last frame until which all the inputs of a player were received,
+     * the frames between it and the last received frame have at least one predicted input.
+     */
+    [[nodiscard]] Frame GetLastContiguousFrame(PlayerNumber playerNumber) const { return lastContiguousFrame_[playerNumber]; }
     [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
+    [[nodiscard]] const PredictionStats& GetPredictionStats(PlayerNumber playerNumber) const { return predictionStats_[playerNumber]; }
+    /**
+     * \brief GetDirtyFrame is a method that gives the earliest frame to simulate again on the next simulation, INVALID_FRAME if none.
+     */
+    [[nodiscard]] Frame GetDirtyFrame() const { return dirtyFrame_; }
+    /**
+     * \brief GetResimulatedFrameNmb is a method that gives the number of already simulated frames that were simulated again
+     * after a misprediction, since the construction or the last change of input predictor.
+     */
+    [[nodiscard]] std::uint32_t GetResimulatedFrameNmb() const { return resimulatedFrameNmb_; }
+    /**
+     * \brief SetSpeculativeBranchNmb is a method that sets how many alternatives of the next input of the most late remote player
+     * are simulated in advance, each one on its own worker thread (0 by default, to disable it).
+     * The alternatives are the predicted input with one button changed, the buttons this player changed the most first.
+     * When the received inputs match a branch, its frames are adopted instead of being simulated again.
+     */
+    void SetSpeculativeBranchNmb(std::size_t branchNmb);
+    [[nodiscard]] std::size_t GetSpeculativeBranchNmb() const { return branches_.size(); }
+    /**
+     * \brief IsSpeculating is a method that returns true while a speculative branch is simulated by its worker thread.
+     */
+    [[nodiscard]] bool IsSpeculating() const;
+    [[nodiscard]] const SpeculationStats& GetSpeculationStats() const { return speculationStats_; }
+    /**
+     * \brief SetInputPredictor is a method that changes the algorithm predicting the inputs not received yet (RepeatLastInputPredictor by default).
+     * The prediction statistics are reset, such that they only measure the new predictor.
+     */
+    void SetInputPredictor(std::unique_ptr<InputPredictorInterface> inputPredictor);
     [[nodiscard]] const core::TransformManager& GetTransformManager() const { return currentTransformManager_; }
     [[nodiscard]] const PlayerCharacterManager& GetPlayerCharacterManager() const { return currentPlayerManager_; }
     void SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position);
     void SpawnAttack(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position);
+    /**
+     * \brief SpawnPlatform is a method that adds a static box to both the current and the last validated worlds.
+     * Like the players, platforms needs to be spawned before the game starts.
+     */
+    void SpawnPlatform(core::Entity entity, core::Vec2f position, core::Vec2f extends);
     /**
      * \brief DestroyEntity is a method that does not destroy the entity definitely, but puts the DESTROY flag on.
-     * An entity is truly destroyed when the destroy frame is validated.
+     * An entity is truly destroyed when the destroy frame is validated, and the flag is removed when going back before the destroy frame.
      * \param entity is the entity to be "destroyed"
      */
     void DestroyEntity(core::Entity entity);
 
-    void OnTrigger(core::Entity entity1, core::Entity entity2) override;
-        [[nodiscard]] const std::array<PlayerInput, windowBufferSize>& GetInputs(PlayerNumber playerNumber) const
+    /**
+     * \brief OnContacts is a method called by the PhysicsManager with the boxes in contact during a simulated frame.
+     * Each contact is dispatched from the components of both entities, in the order given by the PhysicsManager.
+     * A contact whose entities were destroyed or pushed apart by a previous contact of the batch is skipped.
+     */
+    void OnContacts(const std::vector<Contact>& contacts);
+    [[nodiscard]] const InputHistory& GetInputs(PlayerNumber playerNumber) const
     {
         return inputs_[playerNumber];
     }
+    [[nodiscard]] std::size_t GetWindowCapacity() const { return inputs_.front().GetCapacity(); }
+    /**
+     * \brief GetWindowEndFrame is a method that gives the last frame that can be stored before validating more frames,
+     * maxWindowBufferSize - 1 frames after the last validated frame.
+     */
+    [[nodiscard]] Frame GetWindowEndFrame() const { return lastValidateFrame_ + static_cast<Frame>(maxWindowBufferSize) - 1; }
+    [[nodiscard]] WorldMode GetWorldMode() const { return worldMode_; }
 
     PhysicsManager& GetCurrentPhysicsManager() { return currentPhysicsManager_; }
 private:
 
     [[nodiscard]] PlayerInput GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const;
+    /**
+     * \brief UpdatePredictions is a method that predicts again the inputs after the last received input of each player
+     * whose inputs changed since the last prediction, and marks the frames whose prediction changed to be simulated again.
+     */
+    void UpdatePredictions();
+    /**
+     * \brief SimulateFrame is a method that simulates one frame of the current world with the stored inputs and saves its snapshot.
+     * \param frame is the frame to simulate, it needs to be the one after simulatedFrame_
+     */
+    void SimulateFrame(Frame frame);
+    /**
+     * \brief RevertToDirtyFrame is a method that restores the current world to the frame before the earliest changed input.
+     * It does nothing if no input changed on an already simulated frame.
+     */
+    void RevertToDirtyFrame();
+    /**
+     * \brief RevertToFrame is a method that restores the current world to the given frame using the frame snapshots.
+     * Entities created after the frame are destroyed and entities destroyed after the frame are brought back.
+     * \param frame is the frame to go back to, between lastValidateFrame_ and simulatedFrame_
+     */
+    void RevertToFrame(Frame frame);
+    /**
+     * \brief RevertEntities is a method that destroys the entities created after the frame and brings back the entities destroyed after it.
+     */
+    void RevertEntities(Frame frame);
+    /**
+     * \brief AdvanceValidatedWorld is the ValidateFrame of WorldMode::VALIDATED, that simulates the validated world
+     * from lastValidateFrame_ to newValidateFrame and truly destroys the entities destroyed on these frames.
+     */
+    void AdvanceValidatedWorld(Frame newValidateFrame);
+    /**
+     * \brief LaunchSpeculation is a method that starts the speculative branches on the next input of the most late remote player,
+     * when the branches are idle and the current frame is simulated.
+     * A launched speculation is kept until this input is received, such that the branches are only loaded again
+     * when the last received frame of the speculated player changes.
+     */
+    void LaunchSpeculation();
+    /**
+     * \brief AdoptSpeculation is a method that replaces the frames of the launched speculation by the ones of a finished branch
+     * whose inputs match the received and predicted inputs, once the speculated input is received. The speculation is dropped otherwise.
+     */
+    void AdoptSpeculation();
+    /**
+     * \brief LoadBranch is a method called on the RollbackManager of a SpeculativeBranch to copy the world of source at the frame before startFrame,
+     * with startInput as the input of playerNumber on startFrame.
+     * The entities, Arenas, journals and inputs are copied into the storage of the previous loads, which avoids any allocation once it is large enough.
+     */
+    void LoadBranch(RollbackManager& source, PlayerNumber playerNumber, Frame startFrame, PlayerInput startInput);
+    /**
+     * \brief SimulateBranch is a method called by the worker thread of a SpeculativeBranch to simulate the loaded frames.
+     */
+    void SimulateBranch();
+    void SaveSnapshot(Frame frame);
+    [[nodiscard]] const core::Arena& GetSnapshot(Frame frame) const;
+    /**
+     * \brief RemoveRollbackComponents is a method that removes the components of a truly destroyed entity from the current world
+     * and from the snapshots that can still be restored, such that they are not iterated anymore.
+     * \param entity is the truly destroyed entity
+     * \param validateFrame is the new validated frame, the earliest snapshot that can be restored
+     */
+    void RemoveRollbackComponents(core::Entity entity, Frame validateFrame);
+    /**
+     * \brief ReserveEntity is a method that grows all the world Arenas such that they can hold the components of entity.
+     * It is the only allocation of the world Arenas after the construction.
+     */
+    void ReserveEntity(core::Entity entity);
+    /**
+     * \brief ReserveWindow is a method that grows the input histories and the snapshot ring buffer
+     * such that they can hold frameNmb frames, keeping the frames after the validated frame.
+     * The capacity doubles until maxWindowBufferSize.
+     */
+    void ReserveWindow(std::size_t frameNmb);
+    /**
+     * \brief StartNewInputFrame is a method that moves the input history of one player forward to newFrame,
+     * growing the window if needed, without changing the current frame.
+     */
+    void StartNewInputFrame(PlayerNumber playerNumber, Frame newFrame);
     GameManager& gameManager_;
     core::EntityManager& entityManager_;
+    WorldMode worldMode_;
+    /**
+     * \brief The world Arenas need to be constructed before the component managers working on them.
+     */
+    WorldArenaLayout worldLayout_;
+    core::Arena currentWorld_;
+    core::Arena lastValidateWorld_;
     /**
      * \brief Used for rendering
      */
@@ -112,15 +396,70 @@ private:
      * \brief testedFrame_ is the current simulated frame used mainly for entity creation and collision.
      */
     Frame testedFrame_ = 0; 
+    /**
+     * \brief simulatedFrame_ is the last frame simulated in the current world.
+     */
+    Frame simulatedFrame_ = 0;
+    /**
+     * \brief dirtyFrame_ is the earliest frame whose inputs changed since the last simulation, INVALID_FRAME if none.
+     */
+    Frame dirtyFrame_ = INVALID_FRAME;
+    /**
+     * \brief lastValidateChecksum_ is the checksum of the last validated world, computed when validating a frame.
+     */
+    WorldChecksum lastValidateChecksum_{};
 
     std::array<std::uint32_t, maxPlayerNmb> lastReceivedFrame_{};
-    std::array<std::array<PlayerInput, windowBufferSize>, maxPlayerNmb> inputs_{};
+    std::array<Frame, maxPlayerNmb> lastContiguousFrame_{};
     /**
-     * \brief Array containing all the created entities in the window between the confirm frame and the current frame
-     * to destroy them when rollbacking.
+     * \brief inputs_ are the received or predicted inputs of each player, indexed by frame.
      */
-    std::vector<CreatedEntity> createdEntities_;
+    std::array<InputHistory, maxPlayerNmb> inputs_{};
+    std::array<PredictionStats, maxPlayerNmb> predictionStats_{};
+    std::unique_ptr<InputPredictorInterface> inputPredictor_;
+    /**
+     * \brief predictionFrames_ is the earliest frame of each player to predict again, INVALID_FRAME if the predictions are up to date.
+     */
+    std::array<Frame, maxPlayerNmb> predictionFrames_{};
+    std::uint32_t resimulatedFrameNmb_ = 0;
+    SimulationBudget simulationBudget_{};
+    /**
+     * \brief incompleteSimulationNmb_ is the number of consecutive SimulateToCurrentFrame calls that stopped before the current frame.
+     */
+    std::uint32_t incompleteSimulationNmb_ = 0;
+    std::vector<std::unique_ptr<SpeculativeBranch>> branches_;
+    /**
+     * \brief speculationFrame_ is the first frame simulated by the speculative branches, INVALID_FRAME when none is launched.
+     * The speculation is dropped when the world before this frame changes.
+     */
+    Frame speculationFrame_ = INVALID_FRAME;
+    /**
+     * \brief speculatedPlayer_ is the player whose input on speculationFrame_ is changed by the speculative branches.
+     */
+    PlayerNumber speculatedPlayer_ = INVALID_PLAYER;
+    SpeculationStats speculationStats_{};
+    /**
+     * \brief Journal of the created entities in the window between the confirm frame and the current frame
+     * to destroy them when rollbacking. The records are in frame order: rollback pops the reverted frames from the back
+     * and validation pops the validated frames from the front.
+     */
+    std::deque<CreatedEntity> createdEntities_;
+    /**
+     * \brief Journal of the entities flagged as destroyed in the window between the confirm frame and the current frame
+     * to bring them back when rollbacking, in frame order like createdEntities_.
+     */
+    std::deque<DestroyedEntity> destroyedEntities_;
+    /**
+     * \brief Ring buffer of the world snapshot Arenas indexed by frame modulo the window capacity.
+     */
+    std::vector<core::Arena> snapshots_;
 
+    /**
+     * \brief GetContactCategory is a method that gives the index of the ContactCategory of entity in the contact dispatch table.
+     */
+    [[nodiscard]] std::size_t GetContactCategory(core::Entity entity) const;
+    void ManageCollisionAttack(core::Entity playerEntity, core::Entity attackEntity);
+    void ManageCollisionPlayer(core::Entity firstPlayerEntity, core::Entity secondPlayerEntity);
     void ResolveCollisionBoxToBox(Body& firstPlayerBody,const Box& firstPlayerBox, Body& secondPlayerBody,const Box& secondPlayerBox);
 };
 }
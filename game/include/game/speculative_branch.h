@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "game/game_manager.h"
+
+namespace game
+{
+/**
+ * \brief SpeculativeBranch is a class that simulates an alternative of the current world on its own worker thread.
+ * It owns a headless copy of the game (entities, world Arenas and inputs), loaded by the RollbackManager
+ * from a snapshot of its window with another input for one remote player.
+ * The RollbackManager adopts the simulated frames when the real inputs match the inputs of the branch.
+ */
+class SpeculativeBranch
+{
+public:
+    SpeculativeBranch();
+    ~SpeculativeBranch();
+    SpeculativeBranch(const SpeculativeBranch&) = delete;
+    SpeculativeBranch& operator=(const SpeculativeBranch&) = delete;
+    /**
+     * \brief Load is a method that copies the world of rollbackManager at the frame before startFrame,
+     * with startInput as the input of playerNumber on startFrame and its predictions on the next frames.
+     * It needs to be called when the branch is not running.
+     */
+    void Load(RollbackManager& rollbackManager, PlayerNumber playerNumber, Frame startFrame, PlayerInput startInput);
+    /**
+     * \brief Start is a method that wakes up the worker thread to simulate the loaded branch until the current frame of its source.
+     */
+    void Start();
+    /**
+     * \brief IsRunning is a method that returns true while the worker thread simulates the branch.
+     * Once it returns false, the simulated branch can be read by the thread that started it.
+     */
+    [[nodiscard]] bool IsRunning() const { return isRunning_.load(std::memory_order_acquire); }
+    /**
+     * \brief IsAdoptable is a method that returns true when the simulation of the branch did not create nor destroy any entity,
+     * such that its world can replace the world of its source without changing its entities.
+     */
+    [[nodiscard]] bool IsAdoptable() const;
+    [[nodiscard]] const RollbackManager& GetRollbackManager() const { return gameManager_.GetRollbackManager(); }
+private:
+    /**
+     * \brief BranchGameManager is a headless GameManager whose entities and players are copied from another one.
+     */
+    class BranchGameManager final : public GameManager
+    {
+    public:
+        RollbackManager& GetMutableRollbackManager() { return rollbackManager_; }
+        void CopyPlayers(const GameManager& gameManager);
+    };
+    void Run();
+
+    BranchGameManager gameManager_;
+    std::size_t createdEntityNmb_ = 0;
+    std::size_t destroyedEntityNmb_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool hasJob_ = false;
+    bool isStopping_ = false;
+    std::atomic<bool> isRunning_ = false;
+    /**
+     * \brief thread_ is declared last, such that the worker thread starts once the other members are constructed.
+     */
+    std::thread thread_;
+};
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "game/game_globals.h"
+
+namespace game
+{
+/**
+ * \brief TimeSync is a class that estimates the frame advantage of a client on the other players,
+ * how many frames ahead of them it is, and gives the time scale of its fixed updates to correct it.
+ * Both clients slowing down when ahead and speeding up when behind keep them on the same frame,
+ * such that the received inputs are not older than the network latency and the rollbacks stay short.
+ */
+class TimeSync
+{
+public:
+    /**
+     * \brief AddSample is a method that adds a frame advantage sample to the moving average.
+     * \param currentFrame is the current frame of the client
+     * \param remoteFrame is the last frame received from the furthest behind remote player
+     * \param rtt is the smoothed round trip time to the server in milliseconds.
+     * The remote inputs go through the server, so they are a round trip time old when received.
+     */
+    void AddSample(Frame currentFrame, Frame remoteFrame, float rtt);
+    /**
+     * \brief GetFrameAdvantage is a method that gives the smoothed number of frames the client is ahead of the remote players,
+     * negative when it is behind.
+     */
+    [[nodiscard]] float GetFrameAdvantage() const { return frameAdvantage_; }
+    /**
+     * \brief GetTimeScale is a method that gives the ratio to apply to the elapsed time before running fixed updates,
+     * lower than 1 to slow down when ahead and higher than 1 to speed up when behind.
+     */
+    [[nodiscard]] float GetTimeScale() const;
+private:
+    float frameAdvantage_ = 0.0f;
+    bool hasSample_ = false;
+};
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <deque>
+
 #include "packet_type.h"
 #include "game/game_manager.h"
 #include "graphics/graphics.h"
@@ -20,18 +22,51 @@ public:
     {
         gameManager_.SetWindowSize(windowSize);
     }
+    /**
+     * \brief StartSimulationThread is a method that runs the game simulation on a dedicated thread, see ClientGameManager::StartSimulationThread.
+     * The received packets are then applied by the simulation thread.
+     */
+    void StartSimulationThread(std::function<PlayerInput()> inputSampler)
+    {
+        gameManager_.StartSimulationThread(std::move(inputSampler), [this](const Packet& packet) { ApplyPacket(packet); });
+    }
+    [[nodiscard]] bool IsSimulationThreaded() const { return gameManager_.IsSimulationThreaded(); }
 
     /**
      * \brief ReceiveNetPacket is a method called by an app owning a client when receiving a packet.
      * It is the same one for simulated and network client
-     * \param packet A non-owning pointer to a packet (you don't need to care about deleting it
+     * With the simulation thread, the packet is queued and applied by the simulation thread before its next update.
+     * \param packet is the received packet, it is not kept after the call
      */
-    virtual void ReceivePacket(const Packet* packet);
+    void ReceivePacket(const Packet& packet);
 
     void Update(sf::Time dt) override;
 protected:
+    /**
+     * \brief ApplyPacket is a method that updates the game with a received packet, on the thread running the simulation.
+     */
+    virtual void ApplyPacket(const Packet& packet);
+    /**
+     * \brief PushPendingPackets is a method that queues the packets kept while the queue of the simulation thread was full.
+     */
+    void PushPendingPackets();
+    void ReceiveTypedPacket(const SpawnPlayerPacket& spawnPlayerPacket);
+    void ReceiveTypedPacket(const StartGamePacket& startGamePacket);
+    void ReceiveTypedPacket(const PlayerInputPacket& playerInputPacket);
+    void ReceiveTypedPacket(const ValidateFramePacket& validateFramePacket);
+    void ReceiveTypedPacket(const WinGamePacket& winGamePacket);
+    void ReceiveTypedPacket(const PingPacket& pingPacket);
+    /**
+     * \brief ReceiveTypedPacket ignores the packets that are not managed by every client.
+     */
+    template<typename T>
+    void ReceiveTypedPacket(const T&) {}
 
     ClientGameManager gameManager_;
+    /**
+     * \brief pendingPackets_ are the received packets not queued yet for the simulation thread, in reception order.
+     */
+    std::deque<Packet> pendingPackets_;
     ClientId clientId_ = INVALID_CLIENT_ID;
     float pingTimer_ = -1.0f;
     float currentPing_ = 0.0f;
@@ -16,8 +16,8 @@ namespace game
 
 struct DbPhysicsState
 {
-    std::array<PhysicsState, maxPlayerNmb> serverStates{};
-    std::array<PhysicsState, maxPlayerNmb> localStates{};
+    Checksum serverChecksum{};
+    Checksum localChecksum{};
     Frame lastLocalValidateFrame{};
     Frame validateFrame{};
 };
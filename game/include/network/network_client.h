@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
+
 #include "client.h"
+#include <SFML/Network/Packet.hpp>
 #include <SFML/Network/TcpSocket.hpp>
 #include <SFML/Network/UdpSocket.hpp>
 
@@ -39,23 +42,34 @@ public:
 
 	void Draw(sf::RenderTarget& renderTarget) override;
 
-	void SendReliablePacket(std::unique_ptr<Packet> packet) override;
+	void SendReliablePacket(const Packet& packet) override;
 
-	void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
+	void SendUnreliablePacket(const Packet& packet) override;
 	void SetPlayerInput(PlayerInput playerInput);
 
-	void ReceivePacket(const Packet* packet) override;
+protected:
+	void ApplyPacket(const Packet& packet) override;
 private:
-	void ReceiveNetPacket(sf::Packet& packet, PacketSource source);
+	void ReceiveNetPacket(std::span<const std::uint8_t> data, PacketSource source);
 	sf::UdpSocket udpSocket_;
 	sf::TcpSocket tcpSocket_;
+	PacketBuffer receiveBuffer_{};
+	/**
+	 * \brief tcpSendPacket_ and tcpReceivePacket_ only add the length framing of the TCP stream, they are reused to keep their capacity.
+	 * The reliable packets are only sent by the main thread.
+	 */
+	sf::Packet tcpSendPacket_;
+	sf::Packet tcpReceivePacket_;
 
 	std::string serverAddress_ = "localhost";
 	unsigned short serverTcpPort_ = 12345;
 	unsigned short serverUdpPort_ = 0;
 
 
-	State currentState_ = State::NONE;
+	/**
+	 * \brief currentState_ is also read by the simulation thread when it sends the inputs.
+	 */
+	std::atomic<State> currentState_ = State::NONE;
 
 #ifdef ENABLE_SQLITE
 	DebugDatabase debugDb_;
@@ -31,9 +31,9 @@ public:
         UDP
     };
 
-    void SendReliablePacket(std::unique_ptr<Packet> packet) override;
+    void SendReliablePacket(const Packet& packet) override;
 
-    void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
+    void SendUnreliablePacket(const Packet& packet) override;
 
     void Begin() override;
 
@@ -49,11 +49,11 @@ protected:
     void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) override;
 
 private:
-    void ProcessReceivePacket(std::unique_ptr<Packet> packet,
+    void ProcessReceivePacket(const Packet& packet,
         PacketSocketSource packetSource,
         sf::IpAddress address = "localhost",
         unsigned short port = 0);
-    void ReceiveNetPacket(sf::Packet& packet, PacketSocketSource packetSource,
+    void ReceiveNetPacket(std::span<const std::uint8_t> data, PacketSocketSource packetSource,
                           sf::IpAddress address = "localhost",
                           unsigned short port = 0);
 
@@ -66,6 +66,16 @@ private:
     sf::UdpSocket udpSocket_;
     sf::TcpListener tcpListener_;
     std::array<sf::TcpSocket, maxPlayerNmb> tcpSockets_;
+    /**
+     * \brief sendBuffer_ is written once per sent packet and reused by all the sends, such that sending does not allocate.
+     */
+    PacketBuffer sendBuffer_{};
+    PacketBuffer receiveBuffer_{};
+    /**
+     * \brief tcpSendPacket_ and tcpReceivePacket_ only add the length framing of the TCP stream, they are reused to keep their capacity.
+     */
+    sf::Packet tcpSendPacket_;
+    sf::Packet tcpReceivePacket_;
 
     std::array<ClientInfo, maxPlayerNmb> clientInfoMap_{};
 
@@ -3,11 +3,16 @@
  */
 #pragma once
 
-#include <SFML/Network/Packet.hpp>
-
 #include "game/game_globals.h"
-#include <memory>
-#include <chrono>
+#include "maths/angle.h"
+#include "maths/vec2.h"
+#include "utils/byte_stream.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+#include <span>
+#include <variant>
 
 namespace game
 {
@@ -26,334 +31,459 @@ enum class PacketType : std::uint8_t
 };
 
 /**
- * \brief PhysicsState is the type of the physics state checksum
+ * \brief Checksum is the type of the world state checksums
  */
-using PhysicsState = std::uint16_t;
+using Checksum = std::uint64_t;
 
 /**
- * \brief Packet is a interface that defines what a packet with a PacketType.
+ * \brief ChecksumComponent is the index of each rollback component array in the breakdown of a WorldChecksum.
  */
-struct Packet
+enum class ChecksumComponent : std::uint8_t
 {
-    virtual ~Packet() = default;
-    PacketType packetType = PacketType::NONE;
+    BODY = 0u,
+    BOX,
+    PLAYER_CHARACTER,
+    ATTACK,
+    LENGTH
 };
-
-inline sf::Packet& operator<<(sf::Packet& packetReceived, Packet& packet)
-{
-    const auto packetType = static_cast<std::uint8_t>(packet.packetType);
-    packetReceived << packetType;
-    return packetReceived;
-}
-
-inline sf::Packet& operator>>(sf::Packet& packetReceived, Packet& packet)
-{
-    std::uint8_t packetType;
-    packetReceived >> packetType;
-    packet.packetType = static_cast<PacketType>(packetType);
-    return packetReceived;
-}
+constexpr std::size_t checksumComponentNmb = static_cast<std::size_t>(ChecksumComponent::LENGTH);
+constexpr std::array<const char*, checksumComponentNmb> checksumComponentNames{ "body", "box", "player character", "attack" };
 
 /**
- * \brief TypedPacket is a template class that sets the packetType of Packet automatically at construction with the given type.
- * \tparam type is the PacketType of the packet
+ * \brief WorldChecksum is a struct that holds the checksum of the whole validated world,
+ * and optionally the checksum of each component array to find which one is in desync.
  */
-template<PacketType type>
-struct TypedPacket : Packet
+struct WorldChecksum
 {
-    TypedPacket() { packetType = type; }
+    Checksum value = 0;
+    std::optional<std::array<Checksum, checksumComponentNmb>> components;
 };
 
-template<typename T, size_t N>
-sf::Packet& operator<<(sf::Packet& packet, const std::array<T, N>& t)
+/**
+ * \brief scalarWireSize is the number of bytes of a core::Scalar in a packet,
+ * a float or the raw integer of a core::Fixed when compiled with GPR_FIXED_POINT.
+ */
+constexpr std::size_t scalarWireSize = sizeof(core::Scalar);
+
+inline void SerializeScalar(core::ByteWriter& writer, core::Scalar value)
 {
-    for (auto& tmp : t)
-    {
-        packet << tmp;
-    }
-    return packet;
+#ifdef GPR_FIXED_POINT
+    writer.Write(value.GetRaw());
+#else
+    writer.Write(value);
+#endif
 }
 
-template <typename T, size_t N>
-sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
+inline void DeserializeScalar(core::ByteReader& reader, core::Scalar& value)
 {
-    for (auto& tmp : t)
-    {
-        packet >> tmp;
-    }
-    return packet;
+#ifdef GPR_FIXED_POINT
+    core::Fixed::Raw raw = 0;
+    reader.Read(raw);
+    value = core::Fixed::FromRaw(raw);
+#else
+    reader.Read(value);
+#endif
 }
 
 /**
  * \brief JoinPacket is a TCP Packet that is sent by a client to the server to join a game.
  */
-struct JoinPacket : TypedPacket<PacketType::JOIN>
-{
-    std::array<std::uint8_t, sizeof(ClientId)> clientId{};
-    std::array<std::uint8_t, sizeof(unsigned long)> startTime{};
+struct JoinPacket
+{
+    static constexpr PacketType packetType = PacketType::JOIN;
+    static constexpr std::size_t wireSize = sizeof(ClientId) + sizeof(std::uint64_t);
+    ClientId clientId = INVALID_CLIENT_ID;
+    /**
+     * \brief startTime is the time of the client in milliseconds since the epoch.
+     */
+    std::uint64_t startTime = 0;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const JoinPacket& joinPacket)
+inline void Serialize(core::ByteWriter& writer, const JoinPacket& joinPacket)
 {
-    return packet << joinPacket.clientId << joinPacket.startTime;
+    writer.Write(joinPacket.clientId);
+    writer.Write(joinPacket.startTime);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, JoinPacket& joinPacket)
+inline void Deserialize(core::ByteReader& reader, JoinPacket& joinPacket)
 {
-    return packet >> joinPacket.clientId >> joinPacket.startTime;
+    reader.Read(joinPacket.clientId);
+    reader.Read(joinPacket.startTime);
 }
 
 /**
  * \brief JoinAckPacket is a TCP Packet that is sent by the server to the client to answer a join packet
  */
-struct JoinAckPacket : TypedPacket<PacketType::JOIN_ACK>
+struct JoinAckPacket
 {
-    std::array<std::uint8_t, sizeof(ClientId)> clientId{};
-    std::array<std::uint8_t, sizeof(unsigned short)> udpPort{};
+    static constexpr PacketType packetType = PacketType::JOIN_ACK;
+    static constexpr std::size_t wireSize = sizeof(ClientId) + sizeof(std::uint16_t);
+    ClientId clientId = INVALID_CLIENT_ID;
+    std::uint16_t udpPort = 0;
 };
 
-
-inline sf::Packet& operator<<(sf::Packet& packet, const JoinAckPacket& spawnPlayerPacket)
+inline void Serialize(core::ByteWriter& writer, const JoinAckPacket& joinAckPacket)
 {
-    return packet << spawnPlayerPacket.clientId << spawnPlayerPacket.udpPort;
+    writer.Write(joinAckPacket.clientId);
+    writer.Write(joinAckPacket.udpPort);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, JoinAckPacket& joinPacket)
+inline void Deserialize(core::ByteReader& reader, JoinAckPacket& joinAckPacket)
 {
-    return packet >> joinPacket.clientId >> joinPacket.udpPort;
+    reader.Read(joinAckPacket.clientId);
+    reader.Read(joinAckPacket.udpPort);
 }
 
 /**
  * \brief SpawnPlayerPacket is a TCP Packet sent by the server to all clients to notify of the spawn of a new player
  */
-struct SpawnPlayerPacket : TypedPacket<PacketType::SPAWN_PLAYER>
+struct SpawnPlayerPacket
 {
-    std::array<std::uint8_t, sizeof(ClientId)> clientId{};
+    static constexpr PacketType packetType = PacketType::SPAWN_PLAYER;
+    static constexpr std::size_t wireSize = sizeof(ClientId) + sizeof(PlayerNumber) + 3 * scalarWireSize;
+    ClientId clientId = INVALID_CLIENT_ID;
     PlayerNumber playerNumber = INVALID_PLAYER;
-    std::array<std::uint8_t, sizeof(core::Vec2f)> pos{};
-    std::array<std::uint8_t, sizeof(core::Degree)> angle{};
+    core::Vec2f pos{};
+    core::Degree angle{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const SpawnPlayerPacket& spawnPlayerPacket)
+inline void Serialize(core::ByteWriter& writer, const SpawnPlayerPacket& spawnPlayerPacket)
 {
-    return packet << spawnPlayerPacket.clientId << spawnPlayerPacket.playerNumber <<
-        spawnPlayerPacket.pos << spawnPlayerPacket.angle;
+    writer.Write(spawnPlayerPacket.clientId);
+    writer.Write(spawnPlayerPacket.playerNumber);
+    SerializeScalar(writer, spawnPlayerPacket.pos.x);
+    SerializeScalar(writer, spawnPlayerPacket.pos.y);
+    SerializeScalar(writer, spawnPlayerPacket.angle.value());
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, SpawnPlayerPacket& spawnPlayerPacket)
+inline void Deserialize(core::ByteReader& reader, SpawnPlayerPacket& spawnPlayerPacket)
 {
-    return packet >> spawnPlayerPacket.clientId >> spawnPlayerPacket.playerNumber >>
-        spawnPlayerPacket.pos >> spawnPlayerPacket.angle;
+    reader.Read(spawnPlayerPacket.clientId);
+    reader.Read(spawnPlayerPacket.playerNumber);
+    DeserializeScalar(reader, spawnPlayerPacket.pos.x);
+    DeserializeScalar(reader, spawnPlayerPacket.pos.y);
+    core::Scalar angle{};
+    DeserializeScalar(reader, angle);
+    spawnPlayerPacket.angle = core::Degree(angle);
 }
 
-    
 /**
- * \brief PlayerInputPacket is a UDP Packet sent by the player client and then replicated by the server to all clients to share the currentFrame
- * and all the previous ones player inputs.
+ * \brief inputRunLengthBitNmb is the number of bits next to a packed input in a byte of a PlayerInputPacket,
+ * they store the length of the run of the same input minus one.
+ */
+constexpr std::uint8_t inputRunLengthBitNmb = 8u - playerInputBitNmb;
+constexpr std::size_t maxInputRunLength = std::size_t{ 1 } << inputRunLengthBitNmb;
+/**
+ * \brief noAckDelta is the ack distance of a PlayerInputPacket whose ack frame is too old to be sent.
+ */
+constexpr std::uint8_t noAckDelta = std::numeric_limits<std::uint8_t>::max();
+static_assert(maxInputNmb <= std::numeric_limits<std::uint8_t>::max(), "The number of inputs of a packet is sent on a byte");
+
+/**
+ * \brief PlayerInputPacket is a UDP Packet sent by the player client with its inputs not acknowledged by the server yet.
+ * The server relays the inputs of the player from its own input history to all clients,
+ * from the last frame received by all the other clients until the last frame it received without any missing frame before it.
  */
-struct PlayerInputPacket : TypedPacket<PacketType::INPUT>
+struct PlayerInputPacket
 {
+    static constexpr PacketType packetType = PacketType::INPUT;
+    static constexpr std::size_t wireSize = sizeof(PlayerNumber) + sizeof(Frame) + 3 * sizeof(std::uint8_t) + maxInputNmb;
     PlayerNumber playerNumber = INVALID_PLAYER;
-    std::array<std::uint8_t, sizeof(Frame)> currentFrame{};
-    std::array<std::uint8_t, maxInputNmb> inputs{};
+    Frame currentFrame = 0;
+    /**
+     * \brief ackFrame is the last frame until which the sending client received all the inputs of all the other players,
+     * or in a relayed packet, until which the server received all the inputs of the player. 0 if unknown.
+     */
+    Frame ackFrame = 0;
+    /**
+     * \brief inputDelay is the number of frames the last sent input of the player is ahead of its current frame, at most maxInputDelay.
+     */
+    std::uint8_t inputDelay = 0;
+    /**
+     * \brief inputNmb is the number of sent inputs, inputs[i] is the input of currentFrame - i.
+     */
+    std::uint8_t inputNmb = 0;
+    std::array<PlayerInput, maxInputNmb> inputs{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const PlayerInputPacket& playerInputPacket)
+inline void Serialize(core::ByteWriter& writer, const PlayerInputPacket& playerInputPacket)
 {
-    return packet << playerInputPacket.playerNumber <<
-        playerInputPacket.currentFrame << playerInputPacket.inputs;
+    writer.Write(playerInputPacket.playerNumber);
+    writer.Write(playerInputPacket.currentFrame);
+    //The ack frame is sent as its distance to the current frame, an ack after the current frame is sent as the current frame
+    //and a distance too large is not sent, such that the server never believes the client received more inputs
+    std::uint8_t ackDelta = 0;
+    if (playerInputPacket.ackFrame < playerInputPacket.currentFrame)
+    {
+        ackDelta = static_cast<std::uint8_t>(std::min<Frame>(playerInputPacket.currentFrame - playerInputPacket.ackFrame, noAckDelta));
+    }
+    writer.Write(ackDelta);
+    writer.Write(playerInputPacket.inputDelay);
+    writer.Write(playerInputPacket.inputNmb);
+    //The inputs are run-length encoded, each byte holds a packed input and the length of its run
+    std::size_t i = 0;
+    while (i < playerInputPacket.inputNmb)
+    {
+        const auto input = static_cast<PlayerInput>(playerInputPacket.inputs[i] & playerInputMask);
+        std::size_t runLength = 1;
+        while (runLength < maxInputRunLength && i + runLength < playerInputPacket.inputNmb &&
+            (playerInputPacket.inputs[i + runLength] & playerInputMask) == input)
+        {
+            runLength++;
+        }
+        writer.Write(static_cast<std::uint8_t>(input | (runLength - 1) << playerInputBitNmb));
+        i += runLength;
+    }
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, PlayerInputPacket& playerInputPacket)
-{
-    return packet >> playerInputPacket.playerNumber >>
-        playerInputPacket.currentFrame >> playerInputPacket.inputs;
+inline void Deserialize(core::ByteReader& reader, PlayerInputPacket& playerInputPacket)
+{
+    reader.Read(playerInputPacket.playerNumber);
+    reader.Read(playerInputPacket.currentFrame);
+    std::uint8_t ackDelta = 0;
+    reader.Read(ackDelta);
+    playerInputPacket.ackFrame = ackDelta != noAckDelta && ackDelta <= playerInputPacket.currentFrame ?
+        playerInputPacket.currentFrame - ackDelta : 0;
+    reader.Read(playerInputPacket.inputDelay);
+    reader.Read(playerInputPacket.inputNmb);
+    if (playerInputPacket.inputNmb > maxInputNmb || playerInputPacket.inputDelay > maxInputDelay)
+    {
+        reader.Invalidate();
+        return;
+    }
+    std::size_t i = 0;
+    while (i < playerInputPacket.inputNmb && reader.IsValid())
+    {
+        std::uint8_t run = 0;
+        reader.Read(run);
+        const std::size_t runLength = (run >> playerInputBitNmb) + 1u;
+        if (i + runLength > playerInputPacket.inputNmb)
+        {
+            reader.Invalidate();
+            return;
+        }
+        std::fill_n(playerInputPacket.inputs.begin() + static_cast<std::ptrdiff_t>(i), runLength,
+            static_cast<PlayerInput>(run & playerInputMask));
+        i += runLength;
+    }
 }
 
 /**
  * \brief StartGamePacket is a TCP Packet send by the server to start a game at a given time.
  */
-struct StartGamePacket : TypedPacket<PacketType::START_GAME>
+struct StartGamePacket
 {
+    static constexpr PacketType packetType = PacketType::START_GAME;
+    static constexpr std::size_t wireSize = 0;
 };
 
+inline void Serialize(core::ByteWriter&, const StartGamePacket&)
+{
+}
+
+inline void Deserialize(core::ByteReader&, StartGamePacket&)
+{
+}
+
 /**
  * \brief ValidateFramePacket is an UDP packet that is sent by the server to validate the last physics state of the world.
  */
-struct ValidateFramePacket : TypedPacket<PacketType::VALIDATE_STATE>
-{
-    std::array<std::uint8_t, sizeof(Frame)> newValidateFrame{};
-    std::array<std::uint8_t, sizeof(PhysicsState) * maxPlayerNmb> physicsState{};
+struct ValidateFramePacket
+{
+    static constexpr PacketType packetType = PacketType::VALIDATE_STATE;
+    static constexpr std::size_t wireSize = sizeof(Frame) + sizeof(Checksum) + sizeof(std::uint8_t) +
+        sizeof(Checksum) * checksumComponentNmb;
+    Frame newValidateFrame = 0;
+    Checksum checksum = 0;
+    /**
+     * \brief hasComponentChecksums tells if the componentChecksums breakdown is sent after the checksum.
+     */
+    bool hasComponentChecksums = false;
+    std::array<Checksum, checksumComponentNmb> componentChecksums{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const ValidateFramePacket& validateFramePacket)
+inline void Serialize(core::ByteWriter& writer, const ValidateFramePacket& validateFramePacket)
+{
+    writer.Write(validateFramePacket.newValidateFrame);
+    writer.Write(validateFramePacket.checksum);
+    writer.Write(validateFramePacket.hasComponentChecksums);
+    if (validateFramePacket.hasComponentChecksums)
+    {
+        for (const auto componentChecksum : validateFramePacket.componentChecksums)
+        {
+            writer.Write(componentChecksum);
+        }
+    }
+}
+
+inline void Deserialize(core::ByteReader& reader, ValidateFramePacket& validateFramePacket)
+{
+    reader.Read(validateFramePacket.newValidateFrame);
+    reader.Read(validateFramePacket.checksum);
+    reader.Read(validateFramePacket.hasComponentChecksums);
+    if (validateFramePacket.hasComponentChecksums)
+    {
+        for (auto& componentChecksum : validateFramePacket.componentChecksums)
+        {
+            reader.Read(componentChecksum);
+        }
+    }
+}
+
+/**
+ * \brief WriteWorldChecksum is a function that fills the checksum fields of a ValidateFramePacket.
+ */
+inline void WriteWorldChecksum(ValidateFramePacket& validateFramePacket, const WorldChecksum& worldChecksum)
 {
-    return packet << validateFramePacket.newValidateFrame << validateFramePacket.physicsState;
+    validateFramePacket.checksum = worldChecksum.value;
+    validateFramePacket.hasComponentChecksums = worldChecksum.components.has_value();
+    if (worldChecksum.components.has_value())
+    {
+        validateFramePacket.componentChecksums = worldChecksum.components.value();
+    }
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, ValidateFramePacket& ValidateFramePacket)
+/**
+ * \brief ReadWorldChecksum is a function that gives the WorldChecksum sent in a ValidateFramePacket.
+ */
+inline WorldChecksum ReadWorldChecksum(const ValidateFramePacket& validateFramePacket)
 {
-    return packet >> ValidateFramePacket.newValidateFrame >> ValidateFramePacket.physicsState;
+    WorldChecksum worldChecksum;
+    worldChecksum.value = validateFramePacket.checksum;
+    if (validateFramePacket.hasComponentChecksums)
+    {
+        worldChecksum.components = validateFramePacket.componentChecksums;
+    }
+    return worldChecksum;
 }
 
 /**
  * \brief WinGamePacket is a TCP Packet sent by the server to notify the clients that a certain player has won.
  */
-struct WinGamePacket : TypedPacket<PacketType::WIN_GAME>
+struct WinGamePacket
 {
+    static constexpr PacketType packetType = PacketType::WIN_GAME;
+    static constexpr std::size_t wireSize = sizeof(PlayerNumber);
     PlayerNumber winner = INVALID_PLAYER;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const WinGamePacket& winGamePacket)
+inline void Serialize(core::ByteWriter& writer, const WinGamePacket& winGamePacket)
 {
-    return packet << winGamePacket.winner;
+    writer.Write(winGamePacket.winner);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, WinGamePacket& winGamePacket)
+inline void Deserialize(core::ByteReader& reader, WinGamePacket& winGamePacket)
 {
-    return packet >> winGamePacket.winner;
+    reader.Read(winGamePacket.winner);
 }
 
 /**
  * \brief PingPacket is an UDP Packet sent by the client to the server and resend by the server to measure the RTT between the client and the server.
  */
-struct PingPacket : TypedPacket<PacketType::PING>
-{
-    std::array<std::uint8_t, sizeof(unsigned long long)> time{};
-    std::array<std::uint8_t, sizeof(ClientId)> clientId{};
+struct PingPacket
+{
+    static constexpr PacketType packetType = PacketType::PING;
+    static constexpr std::size_t wireSize = sizeof(std::uint64_t) + sizeof(ClientId);
+    /**
+     * \brief time is the time of the client in milliseconds when sending the ping.
+     */
+    std::uint64_t time = 0;
+    ClientId clientId = INVALID_CLIENT_ID;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const PingPacket& pingPacket)
+inline void Serialize(core::ByteWriter& writer, const PingPacket& pingPacket)
 {
-    return packet << pingPacket.time << pingPacket.clientId;
+    writer.Write(pingPacket.time);
+    writer.Write(pingPacket.clientId);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, PingPacket& pingPacket)
+inline void Deserialize(core::ByteReader& reader, PingPacket& pingPacket)
 {
-    return packet >> pingPacket.time >> pingPacket.clientId;
+    reader.Read(pingPacket.time);
+    reader.Read(pingPacket.clientId);
 }
 
-inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
-{
-    packet << sendingPacket;
-    switch (sendingPacket.packetType)
-    {
-    case PacketType::JOIN:
-    {
-        const auto& packetTmp = static_cast<JoinPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::SPAWN_PLAYER:
-    {
-        const auto& packetTmp = static_cast<SpawnPlayerPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::INPUT:
-    {
-        const auto& packetTmp = static_cast<PlayerInputPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::VALIDATE_STATE:
-    {
-        const auto& packetTmp = static_cast<ValidateFramePacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::START_GAME:
-    {
-        break;
-    }
-    case PacketType::JOIN_ACK:
-    {
-        const auto& packetTmp = static_cast<JoinAckPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::WIN_GAME:
-    {
-        const auto& packetTmp = static_cast<WinGamePacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::PING:
-    {
-        const auto& packetTmp = static_cast<PingPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
+/**
+ * \brief Packet is a value holding any of the packets, it is copied and sent without any allocation.
+ * The packets are dispatched with std::visit on their type.
+ */
+using Packet = std::variant<JoinPacket, SpawnPlayerPacket, PlayerInputPacket, ValidateFramePacket, StartGamePacket,
+    JoinAckPacket, WinGamePacket, PingPacket>;
 
-    default:
-        break;
-    }
+/**
+ * \brief GetPacketType is a function that gives the PacketType of the packet held by packet.
+ */
+inline PacketType GetPacketType(const Packet& packet)
+{
+    return std::visit([](const auto& typedPacket) { return typedPacket.packetType; }, packet);
 }
 
-inline std::unique_ptr<Packet> GenerateReceivedPacket(sf::Packet& packet)
+/**
+ * \brief maxPacketSize is the number of bytes of the largest packet on the wire, its PacketType included.
+ */
+constexpr std::size_t maxPacketSize = sizeof(PacketType) + std::max({
+    JoinPacket::wireSize, JoinAckPacket::wireSize, SpawnPlayerPacket::wireSize, PlayerInputPacket::wireSize,
+    StartGamePacket::wireSize, ValidateFramePacket::wireSize, WinGamePacket::wireSize, PingPacket::wireSize });
+
+/**
+ * \brief PacketBuffer is a fixed-size buffer that can hold any packet on the wire, reused from one packet to the next.
+ */
+using PacketBuffer = std::array<std::uint8_t, maxPacketSize>;
+
+/**
+ * \brief WritePacket is a function that writes a packet into buffer with its fixed little-endian layout.
+ * \return the number of bytes written
+ */
+inline std::size_t WritePacket(PacketBuffer& buffer, const Packet& sendingPacket)
 {
-    Packet packetTmp;
-    packet >> packetTmp;
-    switch (packetTmp.packetType)
-    {
-    case PacketType::JOIN:
-    {
-        auto joinPacket = std::make_unique<JoinPacket>();
-        joinPacket->packetType = packetTmp.packetType;
-        packet >> *joinPacket;
-        return joinPacket;
-    }
-    case PacketType::SPAWN_PLAYER:
-    {
-        auto spawnPlayerPacket = std::make_unique<SpawnPlayerPacket>();
-        spawnPlayerPacket->packetType = packetTmp.packetType;
-        packet >> *spawnPlayerPacket;
-        return spawnPlayerPacket;
-    }
-    case PacketType::INPUT:
-    {
-        auto playerInputPacket = std::make_unique<PlayerInputPacket>();
-        playerInputPacket->packetType = packetTmp.packetType;
-        packet >> *playerInputPacket;
-        return playerInputPacket;
-    }
-    case PacketType::VALIDATE_STATE:
-    {
-        auto validateFramePacket = std::make_unique<ValidateFramePacket>();
-        validateFramePacket->packetType = packetTmp.packetType;
-        packet >> *validateFramePacket;
-        return validateFramePacket;
-    }
-    case PacketType::START_GAME:
-    {
-        auto startGamePacket = std::make_unique<StartGamePacket>();
-        startGamePacket->packetType = packetTmp.packetType;
-        return startGamePacket;
-    }
-    case PacketType::JOIN_ACK:
+    core::ByteWriter writer(buffer);
+    std::visit([&writer](const auto& typedPacket)
     {
-        auto joinAckPacket = std::make_unique<JoinAckPacket>();
-        joinAckPacket->packetType = packetTmp.packetType;
-        packet >> *joinAckPacket;
-        return joinAckPacket;
-    }
-    case PacketType::WIN_GAME:
+        writer.Write(typedPacket.packetType);
+        Serialize(writer, typedPacket);
+    }, sendingPacket);
+    return writer.GetSize();
+}
+
+/**
+ * \brief ReadTypedPacket is a function that reads the fields of a T packet after its PacketType.
+ * \return the read packet, nothing if the data is too short
+ */
+template<typename T>
+std::optional<Packet> ReadTypedPacket(core::ByteReader& reader)
+{
+    T packet;
+    Deserialize(reader, packet);
+    if (!reader.IsValid())
     {
-        auto winGamePacket = std::make_unique<WinGamePacket>();
-        winGamePacket->packetType = packetTmp.packetType;
-        packet >> *winGamePacket;
-        return winGamePacket;
+        return std::nullopt;
     }
-    case PacketType::PING:
+    return packet;
+}
+
+/**
+ * \brief ReadPacket is a function that reads in place a packet written by WritePacket.
+ * \param data is the received bytes, they are not kept after the call
+ * \return the read packet, nothing if the data is not a valid packet
+ */
+inline std::optional<Packet> ReadPacket(std::span<const std::uint8_t> data)
+{
+    core::ByteReader reader(data);
+    auto packetType = PacketType::NONE;
+    reader.Read(packetType);
+    switch (packetType)
     {
-        auto pingPacket = std::make_unique<PingPacket>();
-        pingPacket->packetType = packetTmp.packetType;
-        packet >> *pingPacket;
-        return pingPacket;
-    }
+    case PacketType::JOIN: return ReadTypedPacket<JoinPacket>(reader);
+    case PacketType::SPAWN_PLAYER: return ReadTypedPacket<SpawnPlayerPacket>(reader);
+    case PacketType::INPUT: return ReadTypedPacket<PlayerInputPacket>(reader);
+    case PacketType::VALIDATE_STATE: return ReadTypedPacket<ValidateFramePacket>(reader);
+    case PacketType::START_GAME: return ReadTypedPacket<StartGamePacket>(reader);
+    case PacketType::JOIN_ACK: return ReadTypedPacket<JoinAckPacket>(reader);
+    case PacketType::WIN_GAME: return ReadTypedPacket<WinGamePacket>(reader);
+    case PacketType::PING: return ReadTypedPacket<PingPacket>(reader);
     default:;
     }
-    return nullptr;
+    return std::nullopt;
 }
 
 /**
@@ -363,7 +493,7 @@ class PacketSenderInterface
 {
 public:
     virtual ~PacketSenderInterface() = default;
-    virtual void SendReliablePacket(std::unique_ptr<Packet> packet) = 0;
-    virtual void SendUnreliablePacket(std::unique_ptr<Packet> packet) = 0;
+    virtual void SendReliablePacket(const Packet& packet) = 0;
+    virtual void SendUnreliablePacket(const Packet& packet) = 0;
 };
 }
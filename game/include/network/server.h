@@ -1,6 +1,4 @@
 #pragma once
-#include <memory>
-
 #include "packet_type.h"
 #include "engine/system.h"
 #include "game/game_globals.h"
@@ -20,12 +18,53 @@ protected:
      * \brief ReceiveNetPacket is a method that is called when the Server receives a Packet from a Client.
      * \param packet is the received Packet.
      */
-    virtual void ReceivePacket(std::unique_ptr<Packet> packet);
+    virtual void ReceivePacket(const Packet& packet);
+    /**
+     * \brief UpdateTick is a method called by each Update of the Server implementations, after receiving the packets.
+     * Every serverTickPeriod, it validates the frames whose inputs are received by all players.
+     * \param dt is the time elapsed since the last call
+     */
+    void UpdateTick(sf::Time dt);
+    /**
+     * \brief ValidateReceivedFrames is a method that validates the frames until which all the inputs of all players are received,
+     * and sends one ValidateFramePacket for them.
+     */
+    void ValidateReceivedFrames();
+    /**
+     * \brief CheckStalledPlayers is a method that ends the game like on a disconnection when the inputs of a player fill the whole window,
+     * as the player the validation waits for stalled for maxWindowBufferSize frames.
+     */
+    void CheckStalledPlayers();
+    /**
+     * \brief RelayInputs is a method that sends the inputs of a player to all clients from the input history of the server,
+     * after the last frame received by all the other clients and until the last frame received without any missing frame before it.
+     * Its ack frame acknowledges the inputs received from the player.
+     */
+    void RelayInputs(PlayerNumber playerNumber);
+
+    void ReceiveTypedPacket(const JoinPacket& joinPacket);
+    void ReceiveTypedPacket(const PlayerInputPacket& playerInputPacket);
+    void ReceiveTypedPacket(const PingPacket& pingPacket);
+    /**
+     * \brief ReceiveTypedPacket ignores the packets that are only sent by the server.
+     */
+    template<typename T>
+    void ReceiveTypedPacket(const T&) {}
 
-    //Server game manager
-    GameManager gameManager_;
+    //Server game manager, it only keeps the validated world
+    GameManager gameManager_{ WorldMode::VALIDATED };
     PlayerNumber lastPlayerNumber_ = 0;
     std::array<ClientId, maxPlayerNmb> clientMap_{};
+    /**
+     * \brief remoteAckFrames_ is the last frame until which each client acknowledged all the inputs of the other players.
+     */
+    std::array<Frame, maxPlayerNmb> remoteAckFrames_{};
+    /**
+     * \brief inputDelays_ is the last input delay sent by each client, relayed with its inputs.
+     */
+    std::array<std::uint8_t, maxPlayerNmb> inputDelays_{};
+    float tickTime_ = 0.0f;
+    bool hasStalledPlayer_ = false;
 
 };
 }
@@ -24,14 +24,14 @@ public:
     void Draw(sf::RenderTarget& window) override;
 
 
-    void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
-    void SendReliablePacket(std::unique_ptr<Packet> packet) override;
+    void SendUnreliablePacket(const Packet& packet) override;
+    void SendReliablePacket(const Packet& packet) override;
 
-    void ReceivePacket(const Packet* packet) override;
-    
     void DrawImGui() override;
     void SetPlayerInput(PlayerInput input);
-    
+
+protected:
+    void ApplyPacket(const Packet& packet) override;
 private:
     SimulationServer& server_;
 #ifdef ENABLE_SQLITE
@@ -1,13 +1,15 @@
 #include "game/attack_manager.h"
 #include "game/game_manager.h"
+#include "engine/entity_view.h"
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
 namespace game
 {
-AttackManager::AttackManager(core::EntityManager& entityManager, GameManager& gameManager) :
-    ComponentManager(entityManager), gameManager_(gameManager)
+AttackManager::AttackManager(core::EntityManager& entityManager, const core::ArenaComponentLayout<Attack>& layout,
+    core::Arena& arena, GameManager& gameManager) :
+    ArenaComponentManager(entityManager, layout, arena), gameManager_(gameManager)
 {
 }
 
@@ -17,27 +19,18 @@ void AttackManager::FixedUpdate(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    const core::EntityView<
+        static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK),
+        static_cast<core::EntityMask>(ComponentType::DESTROYED)> attackView(entityManager_);
+    attackView.ForEach([this, dt](core::Entity entity, Attack& attack)
     {
-        if(entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        if (attack.remainingTime <= 0)
         {
-            continue;
-        }
-
-        
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK)))
+            gameManager_.DestroyAttackBox(entity);
+        }else
         {
-            Attack attack = GetComponent(entity);
-            if (attack.remainingTime <= 0)
-            {
-                gameManager_.DestroyAttackBox(entity);
-            }else
-            {
-                attack.remainingTime -= dt.asSeconds();
-                SetComponent(entity, attack);
-            }
+            attack.remainingTime -= dt.asSeconds();
         }
-        
-    }
+    }, *this);
 }
 }
@@ -0,0 +1,118 @@
+#include "game/broadphase.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+constexpr bool OverlapY(const BroadphaseProxy& proxy1, const BroadphaseProxy& proxy2)
+{
+    return proxy1.min.y <= proxy2.max.y && proxy1.max.y >= proxy2.min.y;
+}
+
+constexpr ColliderPair MakePair(std::size_t proxy1, std::size_t proxy2)
+{
+    return proxy1 < proxy2 ? ColliderPair{ proxy1, proxy2 } : ColliderPair{ proxy2, proxy1 };
+}
+}
+
+void SweepAndPruneBroadphase::FindPairs(const std::vector<BroadphaseProxy>& proxies, std::vector<ColliderPair>& pairs)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    pairs.clear();
+    sortedProxies_.resize(proxies.size());
+    for (std::size_t i = 0; i < proxies.size(); i++)
+    {
+        sortedProxies_[i] = i;
+    }
+    std::sort(sortedProxies_.begin(), sortedProxies_.end(), [&proxies](std::size_t proxy1, std::size_t proxy2)
+        {
+            if (proxies[proxy1].min.x != proxies[proxy2].min.x)
+                return proxies[proxy1].min.x < proxies[proxy2].min.x;
+            return proxy1 < proxy2;
+        });
+
+    activeProxies_.clear();
+    for (const auto proxy : sortedProxies_)
+    {
+        const auto& bounds = proxies[proxy];
+        //The active proxies that end before this one starts cannot overlap any of the next ones
+        std::erase_if(activeProxies_, [&proxies, &bounds](std::size_t activeProxy)
+            {
+                return proxies[activeProxy].max.x < bounds.min.x;
+            });
+        for (const auto activeProxy : activeProxies_)
+        {
+            if (OverlapY(proxies[activeProxy], bounds))
+            {
+                pairs.push_back(MakePair(activeProxy, proxy));
+            }
+        }
+        activeProxies_.push_back(proxy);
+    }
+}
+
+UniformGridBroadphase::UniformGridBroadphase(core::Scalar cellSize) : cellSize_(cellSize)
+{
+}
+
+void UniformGridBroadphase::FindPairs(const std::vector<BroadphaseProxy>& proxies, std::vector<ColliderPair>& pairs)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    pairs.clear();
+    cellEntries_.clear();
+    const auto toCell = [this](core::Scalar position)
+    {
+        return static_cast<std::int64_t>(std::floor(core::ToFloat(position / cellSize_)));
+    };
+    constexpr std::int64_t rowShift = 32;
+    for (std::size_t proxy = 0; proxy < proxies.size(); proxy++)
+    {
+        const auto& bounds = proxies[proxy];
+        for (auto y = toCell(bounds.min.y); y <= toCell(bounds.max.y); y++)
+        {
+            for (auto x = toCell(bounds.min.x); x <= toCell(bounds.max.x); x++)
+            {
+                cellEntries_.push_back({ y * (std::int64_t{ 1 } << rowShift) + x, proxy });
+            }
+        }
+    }
+    //Sorting the entries by cell gathers the proxies of each cell without any hash map
+    std::sort(cellEntries_.begin(), cellEntries_.end(), [](const CellEntry& entry1, const CellEntry& entry2)
+        {
+            if (entry1.cell != entry2.cell)
+                return entry1.cell < entry2.cell;
+            return entry1.proxy < entry2.proxy;
+        });
+    std::size_t cellBegin = 0;
+    while (cellBegin < cellEntries_.size())
+    {
+        auto cellEnd = cellBegin + 1;
+        while (cellEnd < cellEntries_.size() && cellEntries_[cellEnd].cell == cellEntries_[cellBegin].cell)
+        {
+            cellEnd++;
+        }
+        for (auto i = cellBegin; i < cellEnd; i++)
+        {
+            for (auto j = i + 1; j < cellEnd; j++)
+            {
+                pairs.push_back(MakePair(cellEntries_[i].proxy, cellEntries_[j].proxy));
+            }
+        }
+        cellBegin = cellEnd;
+    }
+    //Proxies sharing several cells give the same pair several times
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
+}
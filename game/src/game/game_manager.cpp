@@ -1,10 +1,10 @@
 
 #include "game/game_manager.h"
+#include "engine/entity_view.h"
 
 #include "utils/log.h"
 
 #include "maths/basic.h"
-#include "utils/conversion.h"
 
 #include <fmt/format.h>
 #include <imgui.h>
@@ -18,9 +18,9 @@
 namespace game
 {
 
-GameManager::GameManager() :
+GameManager::GameManager(WorldMode worldMode) :
     transformManager_(entityManager_),
-    rollbackManager_(*this, entityManager_)
+    rollbackManager_(*this, entityManager_, windowBufferSize, worldMode)
 {
     playerEntityMap_.fill(core::INVALID_ENTITY);
 }
@@ -33,8 +33,11 @@ void GameManager::SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position)
     const auto entity = entityManager_.CreateEntity();
     playerEntityMap_[playerNumber] = entity;
 
-    transformManager_.AddComponent(entity);
-    transformManager_.SetPosition(entity, position);
+    if (HasTransforms())
+    {
+        transformManager_.AddComponent(entity);
+        transformManager_.SetPosition(entity, position);
+    }
     rollbackManager_.SpawnPlayer(playerNumber, entity, position);
 }
 
@@ -69,9 +72,12 @@ core::Entity GameManager::SpawnAttack(PlayerNumber playerNumber, core::Vec2f pos
 {
     const core::Entity entity = entityManager_.CreateEntity();
 
-    transformManager_.AddComponent(entity);
-    transformManager_.SetPosition(entity, position);
-    transformManager_.SetScale(entity, core::Vec2f::one() * attackScale);
+    if (HasTransforms())
+    {
+        transformManager_.AddComponent(entity);
+        transformManager_.SetPosition(entity, position);
+        transformManager_.SetScale(entity, core::Vec2f::one() * attackScale);
+    }
     rollbackManager_.SpawnAttack(playerNumber, entity, position);
     return entity;
 }
@@ -81,22 +87,34 @@ void GameManager::DestroyAttackBox(core::Entity entity)
     rollbackManager_.DestroyEntity(entity);
 }
 
+core::Entity GameManager::SpawnPlatform(core::Vec2f position, core::Vec2f extends)
+{
+    const core::Entity entity = entityManager_.CreateEntity();
+
+    if (HasTransforms())
+    {
+        transformManager_.AddComponent(entity);
+        transformManager_.SetPosition(entity, position);
+        transformManager_.SetScale(entity, extends * 2.0f);
+    }
+    rollbackManager_.SpawnPlatform(entity, position, extends);
+    return entity;
+}
+
 PlayerNumber GameManager::CheckWinner() const
 {
     int alivePlayer = 0;
     PlayerNumber winner = INVALID_PLAYER;
 	const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    const core::EntityView<static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)> playerView(entityManager_);
+    playerView.ForEach([&alivePlayer, &winner](core::Entity, const PlayerCharacter& player)
     {
-        if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
-            continue;
-        const auto& player = playerManager.GetComponent(entity);
         if (player.health > 0)
         {
             alivePlayer++;
             winner = player.playerNumber;
         }
-    }
+    }, playerManager);
 
     return alivePlayer == 1 ? winner : INVALID_PLAYER;
 }
@@ -112,6 +130,13 @@ ClientGameManager::ClientGameManager(PacketSenderInterface& packetSenderInterfac
     spriteManager_(entityManager_, transformManager_),
     animationManager_(entityManager_,spriteManager_,*this)
 {
+    rollbackManager_.SetSimulationBudget({ maxSimulatedFramesPerUpdate, simulationTimeBudget });
+    rollbackManager_.SetSpeculativeBranchNmb(speculativeBranchNmb);
+}
+
+ClientGameManager::~ClientGameManager()
+{
+    StopSimulationThread();
 }
 
 void ClientGameManager::Begin()
@@ -144,65 +169,161 @@ void ClientGameManager::Update(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    if (state_ & STARTED)
+    //The simulation thread updates the game on its own
+    if (IsSimulationThreaded())
     {
-        rollbackManager_.SimulateToCurrentFrame();
-        //Copy rollback transform position to our own
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-        {
-            if (entityManager_.HasComponent(entity,
-                static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
-                static_cast<core::EntityMask>(core::ComponentType::SPRITE)))
-            {
-                const auto& player = rollbackManager_.GetPlayerCharacterManager().GetComponent(entity);
-
-
-            	animationManager_.UpdateAnimation(dt, entity);
-                
-            }
+        return;
+    }
+    UpdateSimulation(dt);
+}
 
+bool ClientGameManager::UpdateSimulation(sf::Time dt)
+{
 
-            if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    bool caughtUp = true;
+    if (state_ & STARTED)
+    {
+        caughtUp = rollbackManager_.SimulateToCurrentFrame();
+        const core::EntityView<
+            static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
+            static_cast<core::EntityMask>(core::ComponentType::SPRITE)> playerSpriteView(entityManager_);
+        playerSpriteView.ForEach([this, dt](core::Entity entity)
+        {
+            animationManager_.UpdateAnimation(dt, entity);
+        });
+        //While a long rollback is spread over several render frames, the last consistent frame stays on screen
+        if (caughtUp)
+        {
+            //Copy rollback transform position to our own
+            const core::EntityView<static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)> transformView(entityManager_);
+            transformView.ForEach([this](core::Entity entity)
             {
                 transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
                 transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
-            	transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
-            }
-            if (entityManager_.HasComponent(entity,
+                transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
+            });
+            const core::EntityView<
                 static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
-                static_cast<core::EntityMask>(core::ComponentType::SPRITE)|
-				static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
+                static_cast<core::EntityMask>(core::ComponentType::SPRITE) |
+                static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)> playerTransformView(entityManager_);
+            playerTransformView.ForEach([this](core::Entity entity, const PlayerCharacter& player)
             {
-                transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
-                if (GetRollbackManager().GetPlayerCharacterManager().GetComponent(entity).playerFaceRight)
-                {
-                    transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
-                }
-                else
+                //Players sprites are flipped when facing left
+                if (!player.playerFaceRight)
                 {
                     core::Vec2f scale = rollbackManager_.GetTransformManager().GetScale(entity);
                     scale = core::Vec2f{ scale.x * -1,scale.y };//inverse the x
                     transformManager_.SetScale(entity, scale);
                 }
-            }
-
-
+            }, rollbackManager_.GetPlayerCharacterManager());
         }
     }
-    fixedTimer_ += dt.asSeconds();
+    //Gently slow down or speed up the frames to stay on the same frame as the other players
+    fixedTimer_ += dt.asSeconds() * timeSync_.GetTimeScale();
     while (fixedTimer_ > fixedPeriod)
     {
         FixedUpdate();
         fixedTimer_ -= fixedPeriod;
 
     }
+    return caughtUp;
+}
 
+void ClientGameManager::End()
+{
+    StopSimulationThread();
+}
 
+void ClientGameManager::StartSimulationThread(std::function<PlayerInput()> inputSampler, std::function<void(const Packet&)> packetReceiver)
+{
+    if (IsSimulationThreaded())
+    {
+        return;
+    }
+    inputSampler_ = std::move(inputSampler);
+    packetReceiver_ = std::move(packetReceiver);
+    isSimulationRunning_.store(true, std::memory_order_release);
+    simulationThread_ = std::thread(&ClientGameManager::RunSimulationThread, this);
+}
 
+void ClientGameManager::StopSimulationThread()
+{
+    if (!IsSimulationThreaded())
+    {
+        return;
+    }
+    isSimulationRunning_.store(false, std::memory_order_release);
+    simulationThread_.join();
 }
 
-void ClientGameManager::End()
+void ClientGameManager::RunSimulationThread()
+{
+    using Clock = std::chrono::steady_clock;
+    auto previousTime = Clock::now();
+    while (isSimulationRunning_.load(std::memory_order_acquire))
+    {
+        const auto currentTime = Clock::now();
+        const auto dt = sf::microseconds(
+            std::chrono::duration_cast<std::chrono::microseconds>(currentTime - previousTime).count());
+        previousTime = currentTime;
+
+        float sleepTime = 0.0f;
+        {
+            std::scoped_lock lock(simulationMutex_);
+            //The packets and the window size received by the render thread are applied between two updates
+            while (const auto* packet = receivedPackets_.Front())
+            {
+                packetReceiver_(*packet);
+                receivedPackets_.Pop();
+            }
+            if (windowSizes_.HasNewBuffer())
+            {
+                ApplyWindowSize(windowSizes_.Acquire());
+            }
+            //The input is sampled right before the fixed update sending it, whatever the render thread is doing
+            SetPlayerInput(clientPlayer_, inputSampler_(), currentFrame_);
+            if (UpdateSimulation(dt))
+            {
+                sleepTime = (fixedPeriod - fixedTimer_) / timeSync_.GetTimeScale();
+            }
+            FillRenderState(renderStates_.GetWriteBuffer());
+        }
+        renderStates_.Publish();
+        //A rollback spread over several updates continues without waiting
+        std::this_thread::sleep_for(std::chrono::duration<float>(std::max(sleepTime, 0.0f)));
+    }
+}
+
+void ClientGameManager::FillRenderState(RenderState& renderState)
 {
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    UpdateCameraView();
+    renderState.cameraView = cameraView_;
+    spriteManager_.CopySprites(renderState.sprites);
+    renderState.state = state_;
+    renderState.playerNumber = clientPlayer_;
+    renderState.winner = winner_;
+    renderState.startingTime = startingTime_;
+    renderState.healthText.clear();
+    if (state_ & STARTED)
+    {
+        const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
+        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            const auto playerEntity = GetEntityFromPlayerNumber(playerNumber);
+            if (playerEntity == core::INVALID_ENTITY)
+            {
+                continue;
+            }
+            renderState.healthText += fmt::format("P{} health: {} ", playerNumber + 1, playerManager.GetComponent(playerEntity).health);
+        }
+    }
 }
 
 void ClientGameManager::SetWindowSize(sf::Vector2u windowsSize)
@@ -212,11 +333,25 @@ void ClientGameManager::SetWindowSize(sf::Vector2u windowsSize)
         static_cast<float>(windowSize_.x),
         static_cast<float>(windowSize_.y));
     originalView_ = sf::View(visibleArea);
-    spriteManager_.SetWindowSize(sf::Vector2f(windowsSize));
-    spriteManager_.SetCenter(sf::Vector2f(windowsSize) / 2.0f);
+    if (IsSimulationThreaded())
+    {
+        windowSizes_.GetWriteBuffer() = windowsSize;
+        windowSizes_.Publish();
+        return;
+    }
+    ApplyWindowSize(windowsSize);
+}
+
+void ClientGameManager::ApplyWindowSize(sf::Vector2u windowSize)
+{
+    simulationView_ = sf::View(sf::FloatRect(0.0f, 0.0f,
+        static_cast<float>(windowSize.x),
+        static_cast<float>(windowSize.y)));
+    spriteManager_.SetWindowSize(sf::Vector2f(windowSize));
+    spriteManager_.SetCenter(sf::Vector2f(windowSize) / 2.0f);
     auto& currentPhysicsManager = rollbackManager_.GetCurrentPhysicsManager();
-    currentPhysicsManager.SetCenter(sf::Vector2f(windowsSize) / 2.0f);
-    currentPhysicsManager.SetWindowSize(sf::Vector2f(windowsSize));
+    currentPhysicsManager.SetCenter(sf::Vector2f(windowSize) / 2.0f);
+    currentPhysicsManager.SetWindowSize(sf::Vector2f(windowSize));
 }
 
 void ClientGameManager::Draw(sf::RenderTarget& target)
@@ -225,13 +360,19 @@ void ClientGameManager::Draw(sf::RenderTarget& target)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    UpdateCameraView();
-    target.setView(cameraView_);
+    if (!IsSimulationThreaded())
+    {
+        FillRenderState(renderStates_.GetWriteBuffer());
+        renderStates_.Publish();
+    }
+    //With the simulation thread, the last published frame is drawn without waiting for the simulation
+    const auto& renderState = renderStates_.Acquire();
+    target.setView(renderState.cameraView);
 
     starBackground_.Draw(target);
-    spriteManager_.Draw(target);
+    core::SpriteManager::Draw(target, renderState.sprites);
 
-    if(drawPhysics_)
+    if(drawPhysics_ && !IsSimulationThreaded())
     {
         auto& currentPhysicsManager = rollbackManager_.GetCurrentPhysicsManager();
         currentPhysicsManager.Draw(target);
@@ -239,9 +380,9 @@ void ClientGameManager::Draw(sf::RenderTarget& target)
 
     // Draw texts on screen
     target.setView(originalView_);
-    if (state_ & FINISHED)
+    if (renderState.state & FINISHED)
     {
-        if (winner_ == GetPlayerNumber())
+        if (renderState.winner == renderState.playerNumber)
         {
             const std::string winnerText = fmt::format("You won!");
             textRenderer_.setFillColor(sf::Color::White);
@@ -252,9 +393,9 @@ void ClientGameManager::Draw(sf::RenderTarget& target)
                 static_cast<float>(windowSize_.y) / 2.0f - textBounds.height / 2.0f);
             target.draw(textRenderer_);
         }
-        else if (winner_ != INVALID_PLAYER)
+        else if (renderState.winner != INVALID_PLAYER)
         {
-            const std::string winnerText = fmt::format("P{} won!", winner_ + 1);
+            const std::string winnerText = fmt::format("P{} won!", renderState.winner + 1);
             textRenderer_.setFillColor(sf::Color::White);
             textRenderer_.setString(winnerText);
             textRenderer_.setCharacterSize(32);
@@ -275,17 +416,17 @@ void ClientGameManager::Draw(sf::RenderTarget& target)
             target.draw(textRenderer_);
         }
     }
-    if (!(state_ & STARTED))
+    if (!(renderState.state & STARTED))
     {
-        if (startingTime_ != 0)
+        if (renderState.startingTime != 0)
         {
             using namespace std::chrono;
             unsigned long long ms = duration_cast<milliseconds>(
                 system_clock::now().time_since_epoch()
                 ).count();
-            if (ms < startingTime_)
+            if (ms < renderState.startingTime)
             {
-                const std::string countDownText = fmt::format("Starts in {}", ((startingTime_ - ms) / 1000 + 1));
+                const std::string countDownText = fmt::format("Starts in {}", ((renderState.startingTime - ms) / 1000 + 1));
                 textRenderer_.setFillColor(sf::Color::White);
                 textRenderer_.setString(countDownText);
                 textRenderer_.setCharacterSize(32);
@@ -298,19 +439,8 @@ void ClientGameManager::Draw(sf::RenderTarget& target)
     }
     else
     {
-        std::string health;
-        const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-        {
-            const auto playerEntity = GetEntityFromPlayerNumber(playerNumber);
-            if (playerEntity == core::INVALID_ENTITY)
-            {
-                continue;
-            }
-            health += fmt::format("P{} health: {} ", playerNumber + 1, playerManager.GetComponent(playerEntity).health);
-        }
         textRenderer_.setFillColor(sf::Color::White);
-        textRenderer_.setString(health);
+        textRenderer_.setString(renderState.healthText);
         textRenderer_.setPosition(10, 10);
         textRenderer_.setCharacterSize(20);
         target.draw(textRenderer_);
@@ -391,24 +521,56 @@ void ClientGameManager::FixedUpdate()
         core::LogWarning(fmt::format("Invalid Player Entity in {}:line {}", __FILE__, __LINE__));
         return;
     }
+    //The local input sampled on the current frame is final once sent, even when no input was sampled and it repeats the last sent one
     const auto& inputs = rollbackManager_.GetInputs(playerNumber);
-    auto playerInputPacket = std::make_unique<PlayerInputPacket>();
-    playerInputPacket->playerNumber = playerNumber;
-    playerInputPacket->currentFrame = core::ConvertToBinary(currentFrame_);
-    for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+    const auto localInputFrame = std::min(GetLocalInputFrame(currentFrame_), rollbackManager_.GetWindowEndFrame());
+    if (localInputFrame > lastLocalInputFrame_)
+    {
+        if (!inputs.Contains(localInputFrame) || !inputs.IsReceived(localInputFrame))
+        {
+            SetLocalInput(inputs.GetInput(lastLocalInputFrame_), localInputFrame);
+        }
+        lastLocalInputFrame_ = localInputFrame;
+    }
+    PlayerInputPacket playerInputPacket;
+    playerInputPacket.playerNumber = playerNumber;
+    playerInputPacket.ackFrame = INVALID_FRAME;
+    for (PlayerNumber remotePlayerNumber = 0; remotePlayerNumber < maxPlayerNmb; remotePlayerNumber++)
     {
-        if (i > currentFrame_)
+        if (remotePlayerNumber == playerNumber)
+            continue;
+        playerInputPacket.ackFrame = std::min(playerInputPacket.ackFrame, rollbackManager_.GetLastContiguousFrame(remotePlayerNumber));
+    }
+    //Only the inputs not acknowledged by the server are sent, always from the first one such that the server never misses a frame.
+    //Above the redundancy tuned on the round trip time, the newest inputs wait for the next packets.
+    //The server validated a frame only after receiving all its inputs.
+    //With an input delay, the inputs are sent until the frame they are applied on, ahead of the current frame
+    const Frame firstFrame = std::min(std::max(inputAckFrame_, rollbackManager_.GetLastValidateFrame()) + 1, lastLocalInputFrame_);
+    const Frame lastFrame = std::min(lastLocalInputFrame_, firstFrame + inputRedundancy_ - 1);
+    playerInputPacket.currentFrame = lastFrame;
+    playerInputPacket.inputDelay = static_cast<std::uint8_t>(lastLocalInputFrame_ - currentFrame_);
+    for (Frame i = 0; i <= lastFrame - firstFrame; i++)
+    {
+        if (!inputs.Contains(lastFrame - i))
         {
             break;
         }
 
-        playerInputPacket->inputs[i] = inputs[i];
+        playerInputPacket.inputs[i] = inputs.GetInput(lastFrame - i);
+        playerInputPacket.inputNmb++;
     }
-    packetSenderInterface_.SendUnreliablePacket(std::move(playerInputPacket));
-
+    packetSenderInterface_.SendUnreliablePacket(playerInputPacket);
 
+    //Nothing was validated for the whole window, a player is stalled and the game ends like on a disconnection
+    if (GetLocalInputFrame(currentFrame_ + 1) > rollbackManager_.GetWindowEndFrame())
+    {
+        core::LogWarning(fmt::format("No frame validated since frame {}, stopping the game", rollbackManager_.GetLastValidateFrame()));
+        WinGame(INVALID_PLAYER);
+        return;
+    }
     currentFrame_++;
     rollbackManager_.StartNewFrame(currentFrame_);
+    UpdateTimeSync();
 }
 
 
@@ -416,9 +578,62 @@ void ClientGameManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput pl
 {
     if (playerNumber == INVALID_PLAYER)
         return;
+    if (playerNumber == clientPlayer_)
+    {
+        //The input is applied inputDelay_ frames later, an input of an already sent frame is dropped when the delay decreases
+        const auto localInputFrame = GetLocalInputFrame(inputFrame);
+        if (localInputFrame <= lastLocalInputFrame_ || localInputFrame > rollbackManager_.GetWindowEndFrame())
+            return;
+        SetLocalInput(playerInput, localInputFrame);
+        return;
+    }
     GameManager::SetPlayerInput(playerNumber, playerInput, inputFrame);
 }
 
+void ClientGameManager::SetLocalInput(PlayerInput playerInput, Frame inputFrame)
+{
+    //The frames skipped when the delay increases are sent with the last sent input, like frames without any sampled input
+    const auto repeatedInput = rollbackManager_.GetInputs(clientPlayer_).GetInput(lastLocalInputFrame_);
+    for (Frame frame = lastLocalInputFrame_ + 1; frame < inputFrame; frame++)
+    {
+        GameManager::SetPlayerInput(clientPlayer_, repeatedInput, frame);
+    }
+    GameManager::SetPlayerInput(clientPlayer_, playerInput, inputFrame);
+}
+
+void ClientGameManager::SetInputPredictor(InputPredictorType inputPredictorType)
+{
+    inputPredictorType_ = inputPredictorType;
+    rollbackManager_.SetInputPredictor(CreateInputPredictor(inputPredictorType));
+}
+
+void ClientGameManager::SetInputRedundancy(Frame inputRedundancy)
+{
+    inputRedundancy_ = std::clamp<Frame>(inputRedundancy, 1, maxInputNmb);
+}
+
+void ClientGameManager::SetInputDelay(Frame inputDelay)
+{
+    inputDelay_ = std::min(inputDelay, maxInputDelay);
+}
+
+void ClientGameManager::UpdateTimeSync()
+{
+    auto remoteFrame = INVALID_FRAME;
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        if (playerNumber == GetPlayerNumber())
+            continue;
+        //The remote inputs are received ahead of the remote frame by the remote input delay
+        const auto lastReceivedFrame = rollbackManager_.GetLastReceivedFrame(playerNumber);
+        remoteFrame = std::min(remoteFrame, lastReceivedFrame - std::min(lastReceivedFrame, remoteInputDelays_[playerNumber]));
+    }
+    //No remote input received yet
+    if (remoteFrame == INVALID_FRAME || remoteFrame == 0)
+        return;
+    timeSync_.AddSample(currentFrame_, remoteFrame, rtt_);
+}
+
 void ClientGameManager::StartGame(unsigned long long int startingTime)
 {
     core::LogDebug(fmt::format("Start game at starting time: {}", startingTime));
@@ -429,6 +644,14 @@ void ClientGameManager::StartGame(unsigned long long int startingTime)
 
 void ClientGameManager::DrawImGui()
 {
+    //The render thread never waits for a long rollback of the simulation thread.
+    //The simulation state, the client player set by the received packets included, is only read under the lock
+    std::unique_lock lock(simulationMutex_, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        ImGui::Text("Simulation thread is busy");
+        return;
+    }
     ImGui::Text(state_ & STARTED ? "Game has started" : "Game has not started");
     if (startingTime_ != 0)
     {
@@ -440,10 +663,53 @@ void ClientGameManager::DrawImGui()
         ImGui::Text("Current Time: %llu", ms);
     }
     ImGui::Checkbox("Draw Physics", &drawPhysics_);
+    ImGui::Text("Frame advantage: %.2f time scale: %.3f", timeSync_.GetFrameAdvantage(), timeSync_.GetTimeScale());
+    int inputDelay = static_cast<int>(inputDelay_);
+    if (ImGui::SliderInt("Input Delay", &inputDelay, 0, static_cast<int>(maxInputDelay)))
+    {
+        SetInputDelay(static_cast<Frame>(inputDelay));
+    }
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        if (playerNumber == GetPlayerNumber())
+            continue;
+        const auto& predictionStats = rollbackManager_.GetPredictionStats(playerNumber);
+        ImGui::Text("P%u predictions confirmed: %u mispredicted: %u hit rate: %.2f",
+            playerNumber + 1,
+            predictionStats.confirmationNmb,
+            predictionStats.mispredictionNmb,
+            predictionStats.GetHitRate());
+    }
+    ImGui::Text("Resimulated frames: %u", rollbackManager_.GetResimulatedFrameNmb());
+    ImGui::Text("Simulated frame: %u current frame: %u", rollbackManager_.GetSimulatedFrame(), currentFrame_);
+    auto simulationBudget = rollbackManager_.GetSimulationBudget();
+    int maxSimulatedFrameNmb = static_cast<int>(simulationBudget.maxFrameNmb);
+    if (ImGui::SliderInt("Max Simulated Frames Per Update", &maxSimulatedFrameNmb, 0, 64))
+    {
+        simulationBudget.maxFrameNmb = static_cast<Frame>(maxSimulatedFrameNmb);
+        rollbackManager_.SetSimulationBudget(simulationBudget);
+    }
+    int branchNmb = static_cast<int>(rollbackManager_.GetSpeculativeBranchNmb());
+    if (ImGui::SliderInt("Speculative Branches", &branchNmb, 0, playerInputBitNmb))
+    {
+        rollbackManager_.SetSpeculativeBranchNmb(static_cast<std::size_t>(branchNmb));
+    }
+    const auto& speculationStats = rollbackManager_.GetSpeculationStats();
+    ImGui::Text("Speculative branches: %u adopted: %u adopted frames: %u",
+        speculationStats.branchNmb,
+        speculationStats.adoptionNmb,
+        speculationStats.adoptedFrameNmb);
+    for (std::size_t type = 0; type < inputPredictorTypeNmb; type++)
+    {
+        const auto inputPredictorType = static_cast<InputPredictorType>(type);
+        if (ImGui::RadioButton(inputPredictorNames[type], inputPredictorType_ == inputPredictorType))
+        {
+            SetInputPredictor(inputPredictorType);
+        }
+    }
 }
 
-void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
-    const std::array<PhysicsState, maxPlayerNmb>& physicsStates)
+void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame, const WorldChecksum& worldChecksum)
 {
     if (newValidateFrame < rollbackManager_.GetLastValidateFrame())
     {
@@ -452,20 +718,20 @@ void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
     }
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
-        if (rollbackManager_.GetLastReceivedFrame(playerNumber) < newValidateFrame)
+        if (rollbackManager_.GetLastContiguousFrame(playerNumber) < newValidateFrame)
         {
             
             core::LogWarning(fmt::format("Trying to validate frame {} while playerNumber {} is at input frame {}, client player {}",
                 newValidateFrame,
                 playerNumber + 1,
-                rollbackManager_.GetLastReceivedFrame(playerNumber),
+                rollbackManager_.GetLastContiguousFrame(playerNumber),
                 GetPlayerNumber()+1));
             
 
             return;
         }
     }
-    rollbackManager_.ConfirmFrame(newValidateFrame, physicsStates);
+    rollbackManager_.ConfirmFrame(newValidateFrame, worldChecksum);
 }
 
 void ClientGameManager::WinGame(PlayerNumber winner)
@@ -478,11 +744,11 @@ void ClientGameManager::UpdateCameraView()
 {
     if ((state_ & STARTED) != STARTED)
     {
-        cameraView_ = originalView_;
+        cameraView_ = simulationView_;
         return;
     }
 
-    cameraView_ = originalView_;
+    cameraView_ = simulationView_;
     const sf::Vector2f extends{ cameraView_.getSize() / 2.0f / core::pixelPerMeter };
     float currentZoom = 1.0f;
     constexpr float margin = 1.0f;
@@ -495,7 +761,7 @@ void ClientGameManager::UpdateCameraView()
         }
         if (entityManager_.HasComponent(playerEntity, static_cast<core::EntityMask>(core::ComponentType::POSITION)))
         {
-            const auto position = transformManager_.GetPosition(playerEntity);
+            const sf::Vector2f position = transformManager_.GetPosition(playerEntity);
             if (core::Abs(position.x) + margin > extends.x)
             {
                 const auto ratio = (std::abs(position.x) + margin) / extends.x;
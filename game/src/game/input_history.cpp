@@ -0,0 +1,93 @@
+#include "game/input_history.h"
+
+#include <algorithm>
+
+#include "utils/assert.h"
+
+namespace game
+{
+
+InputHistory::InputHistory(std::size_t capacity) :
+    capacity_(capacity),
+    inputs_((capacity + inputsPerWord - 1) / inputsPerWord, 0u),
+    receivedInputs_((capacity + 63u) / 64u, 0u)
+{
+    gpr_assert(capacity > 0, "Input history needs to store at least the current frame");
+}
+
+bool InputHistory::Contains(Frame frame) const
+{
+    return frame <= currentFrame_ && currentFrame_ - frame < capacity_;
+}
+
+PlayerInput InputHistory::GetInput(Frame frame) const
+{
+    gpr_assert(Contains(frame), "Trying to get input too far in the past");
+    const auto slot = GetSlot(frame);
+    const auto shift = slot % inputsPerWord * playerInputBitNmb;
+    return static_cast<PlayerInput>(inputs_[slot / inputsPerWord] >> shift & playerInputMask);
+}
+
+void InputHistory::SetInput(Frame frame, PlayerInput playerInput)
+{
+    gpr_assert(Contains(frame), "Trying to set input too far in the past");
+    WriteInput(GetSlot(frame), static_cast<PlayerInput>(playerInput & playerInputMask));
+}
+
+bool InputHistory::IsReceived(Frame frame) const
+{
+    gpr_assert(Contains(frame), "Trying to get input too far in the past");
+    const auto slot = GetSlot(frame);
+    return (receivedInputs_[slot / 64u] >> (slot % 64u) & 1u) != 0;
+}
+
+void InputHistory::SetReceived(Frame frame)
+{
+    gpr_assert(Contains(frame), "Trying to set input too far in the past");
+    const auto slot = GetSlot(frame);
+    receivedInputs_[slot / 64u] |= std::uint64_t{ 1u } << (slot % 64u);
+}
+
+void InputHistory::StartNewFrame(Frame newFrame)
+{
+    if (newFrame <= currentFrame_)
+        return;
+    const auto repeatedInput = GetInput(currentFrame_);
+    //Only the last capacity frames are stored, a big jump overwrites the whole buffer once
+    const auto newFrameNmb = static_cast<Frame>(std::min<std::size_t>(newFrame - currentFrame_, capacity_));
+    for (Frame frame = newFrame - newFrameNmb + 1; frame <= newFrame; frame++)
+    {
+        SetSlot(GetSlot(frame), repeatedInput, false);
+    }
+    currentFrame_ = newFrame;
+}
+
+void InputHistory::Reserve(std::size_t capacity)
+{
+    if (capacity <= capacity_)
+        return;
+    InputHistory newHistory(capacity);
+    newHistory.currentFrame_ = currentFrame_;
+    const auto storedFrameNmb = std::min<std::size_t>(capacity_, std::size_t{ currentFrame_ } + 1);
+    for (Frame frame = currentFrame_ + 1 - static_cast<Frame>(storedFrameNmb); frame <= currentFrame_; frame++)
+    {
+        newHistory.SetSlot(newHistory.GetSlot(frame), GetInput(frame), IsReceived(frame));
+    }
+    *this = std::move(newHistory);
+}
+
+void InputHistory::WriteInput(std::size_t slot, PlayerInput playerInput)
+{
+    const auto shift = slot % inputsPerWord * playerInputBitNmb;
+    auto& word = inputs_[slot / inputsPerWord];
+    word = (word & ~(std::uint64_t{ playerInputMask } << shift)) | std::uint64_t{ playerInput } << shift;
+}
+
+void InputHistory::SetSlot(std::size_t slot, PlayerInput playerInput, bool received)
+{
+    WriteInput(slot, playerInput);
+    auto& receivedWord = receivedInputs_[slot / 64u];
+    const auto receivedBit = std::uint64_t{ 1u } << (slot % 64u);
+    receivedWord = received ? receivedWord | receivedBit : receivedWord & ~receivedBit;
+}
+}
@@ -0,0 +1,127 @@
+#include "game/input_predictor.h"
+
+#include "utils/assert.h"
+
+namespace game
+{
+namespace
+{
+/**
+ * \brief maxTapFrameNmb is the longest press, in frames, still considered as a tap of a double click.
+ */
+constexpr Frame maxTapFrameNmb = static_cast<Frame>(static_cast<float>(timeToDoubleClick) / fixedPeriod);
+
+constexpr std::array<PlayerInput, playerInputBitNmb> buttons
+{
+    PlayerInputEnum::UP,
+    PlayerInputEnum::DOWN,
+    PlayerInputEnum::LEFT,
+    PlayerInputEnum::RIGHT,
+    PlayerInputEnum::ATTACK
+};
+
+bool IsPressed(const InputHistory& inputs, Frame frame, PlayerInput button)
+{
+    return (inputs.GetInput(frame) & button) != 0;
+}
+
+/**
+ * \brief CountFramesInState counts the consecutive frames with the button in the given state, going back from the frame.
+ * It stops counting after maxTapFrameNmb + 1 frames, a longer press is not a tap anyway.
+ */
+Frame CountFramesInState(const InputHistory& inputs, Frame frame, PlayerInput button, bool pressed)
+{
+    Frame frameNmb = 0;
+    while (frameNmb <= maxTapFrameNmb && frameNmb <= frame && inputs.Contains(frame - frameNmb) && IsPressed(inputs, frame - frameNmb, button) == pressed)
+    {
+        frameNmb++;
+    }
+    return frameNmb;
+}
+}
+
+PlayerInput RepeatLastInputPredictor::Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame)
+{
+    if (!inputs.Contains(lastReceivedFrame))
+        return PlayerInputEnum::NONE;
+    return inputs.GetInput(lastReceivedFrame);
+}
+
+FrequencyInputPredictor::FrequencyInputPredictor(Frame windowFrameNmb) : windowFrameNmb_(windowFrameNmb)
+{
+    gpr_assert(windowFrameNmb > 0, "Frequency predictor needs at least one frame");
+}
+
+PlayerInput FrequencyInputPredictor::Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame)
+{
+    std::array<Frame, playerInputBitNmb> pressedFrameNmbs{};
+    Frame windowFrameNmb = 0;
+    for (; windowFrameNmb < windowFrameNmb_ && windowFrameNmb <= lastReceivedFrame; windowFrameNmb++)
+    {
+        const auto frame = lastReceivedFrame - windowFrameNmb;
+        if (!inputs.Contains(frame))
+            break;
+        for (std::size_t button = 0; button < buttons.size(); button++)
+        {
+            if (IsPressed(inputs, frame, buttons[button]))
+            {
+                pressedFrameNmbs[button]++;
+            }
+        }
+    }
+    PlayerInput prediction = PlayerInputEnum::NONE;
+    for (std::size_t button = 0; button < buttons.size(); button++)
+    {
+        if (pressedFrameNmbs[button] * 2 > windowFrameNmb)
+        {
+            prediction |= buttons[button];
+        }
+    }
+    return prediction;
+}
+
+PlayerInput ButtonHoldInputPredictor::Predict(const InputHistory& inputs, Frame lastReceivedFrame, Frame frame)
+{
+    if (!inputs.Contains(lastReceivedFrame))
+        return PlayerInputEnum::NONE;
+    PlayerInput prediction = PlayerInputEnum::NONE;
+    for (const auto button : buttons)
+    {
+        if (!IsPressed(inputs, lastReceivedFrame, button))
+            continue;
+        const auto heldFrameNmb = CountFramesInState(inputs, lastReceivedFrame, button, true);
+        bool released = false;
+        if (heldFrameNmb <= maxTapFrameNmb && heldFrameNmb <= lastReceivedFrame)
+        {
+            //Look for the previous press of the button, before the release
+            const auto pressStart = lastReceivedFrame - heldFrameNmb;
+            const auto releaseFrameNmb = CountFramesInState(inputs, pressStart, button, false);
+            if (releaseFrameNmb > 0 && releaseFrameNmb <= maxTapFrameNmb && releaseFrameNmb <= pressStart)
+            {
+                const auto previousPressFrameNmb = CountFramesInState(inputs, pressStart - releaseFrameNmb, button, true);
+                const auto predictedHeldFrameNmb = heldFrameNmb + (frame - lastReceivedFrame);
+                released = previousPressFrameNmb > 0 && previousPressFrameNmb <= maxTapFrameNmb &&
+                    predictedHeldFrameNmb > previousPressFrameNmb;
+            }
+        }
+        if (!released)
+        {
+            prediction |= button;
+        }
+    }
+    return prediction;
+}
+
+std::unique_ptr<InputPredictorInterface> CreateInputPredictor(InputPredictorType type)
+{
+    switch (type)
+    {
+    case InputPredictorType::FREQUENCY:
+        return std::make_unique<FrequencyInputPredictor>();
+    case InputPredictorType::BUTTON_HOLD:
+        return std::make_unique<ButtonHoldInputPredictor>();
+    default:
+        return std::make_unique<RepeatLastInputPredictor>();
+    }
+}
+}
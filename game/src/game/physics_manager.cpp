@@ -1,19 +1,184 @@
 #include "game/physics_manager.h"
+#include "engine/entity_view.h"
 #include "engine/transform.h"
 
 #include <SFML/Graphics/RectangleShape.hpp>
 
+#include <algorithm>
+
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
 
 namespace game
 {
+namespace
+{
+/**
+ * \brief GravityAndGroundKernel adds the gravity to the velocity of the simulated bodies affected by it,
+ * and puts back the ones below the ground on it.
+ * The arrays never overlap, telling it to the compiler removes the aliasing that blocks the vectorisation.
+ */
+void GravityAndGroundKernel(core::Vec2f* __restrict positions, core::Vec2f* __restrict velocities,
+    const std::uint8_t* __restrict affectedByGravity, const std::uint8_t* __restrict simulatedBodies,
+    std::size_t bodyNmb, core::Vec2f gravityVelocity)
+{
+    for (std::size_t i = 0; i < bodyNmb; i++)
+    {
+        const bool isAffected = (simulatedBodies[i] & affectedByGravity[i]) != 0;
+        const core::Scalar positionY = positions[i].y;
+        const core::Scalar previousVelocityX = velocities[i].x;
+        const core::Scalar previousVelocityY = velocities[i].y;
+        const core::Scalar velocityX = isAffected ? previousVelocityX + gravityVelocity.x : previousVelocityX;
+        const core::Scalar velocityY = isAffected ? previousVelocityY + gravityVelocity.y : previousVelocityY;
+        const bool isGrounded = isAffected && positionY <= groundLevel;
+        positions[i].y = isGrounded ? groundLevel : positionY;
+        velocities[i].x = velocityX;
+        velocities[i].y = isGrounded ? 0.0f : velocityY;
+    }
+}
+
+constexpr auto colliderMask = static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
+    static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D);
+constexpr auto destroyedMask = static_cast<core::EntityMask>(ComponentType::DESTROYED);
+using ColliderView = core::EntityView<colliderMask, destroyedMask>;
+}
+
+PhysicsManager::PhysicsManager(core::EntityManager& entityManager, const PhysicsArenaLayout& layout, core::Arena& arena) :
+    entityManager_(entityManager), bodyManager_(entityManager, layout.bodies, arena), boxManager_(entityManager, layout.boxes, arena),
+    broadphase_(std::make_unique<SweepAndPruneBroadphase>())
+{
+
+}
+
+BodyArenaLayout::BodyArenaLayout(core::ArenaLayout& layout) :
+    sparseSet(layout),
+    positions(sparseSet.AddComponentArray<core::Vec2f>(layout)),
+    velocities(sparseSet.AddComponentArray<core::Vec2f>(layout)),
+    angularVelocities(sparseSet.AddComponentArray<core::Degree>(layout)),
+    rotations(sparseSet.AddComponentArray<core::Degree>(layout)),
+    bodyTypes(sparseSet.AddComponentArray<BodyType>(layout)),
+    affectedByGravity(sparseSet.AddComponentArray<std::uint8_t>(layout))
+{
+}
+
+BodyManager::BodyManager(core::EntityManager& entityManager, const BodyArenaLayout& layout, core::Arena& arena) :
+    entityManager_(entityManager), layout_(layout), arena_(arena)
+{
+}
+
+Body BodyManager::GetBody(std::size_t index) const
+{
+    return { arena_.Get<core::Vec2f>(layout_.positions)[index], arena_.Get<core::Vec2f>(layout_.velocities)[index],
+        arena_.Get<core::Degree>(layout_.angularVelocities)[index], arena_.Get<core::Degree>(layout_.rotations)[index],
+        arena_.Get<BodyType>(layout_.bodyTypes)[index], arena_.Get<std::uint8_t>(layout_.affectedByGravity)[index] != 0 };
+}
+
+void BodyManager::SetBody(std::size_t index, const Body& body)
+{
+    arena_.Get<core::Vec2f>(layout_.positions)[index] = body.position;
+    arena_.Get<core::Vec2f>(layout_.velocities)[index] = body.velocity;
+    arena_.Get<core::Degree>(layout_.angularVelocities)[index] = body.angularVelocity;
+    arena_.Get<core::Degree>(layout_.rotations)[index] = body.rotation;
+    arena_.Get<BodyType>(layout_.bodyTypes)[index] = body.bodyType;
+    arena_.Get<std::uint8_t>(layout_.affectedByGravity)[index] = body.affectedByGravity_ ? 1 : 0;
+}
+
+void BodyManager::AddComponent(core::Entity entity)
+{
+    gpr_assert(entity != core::INVALID_ENTITY, "Invalid Entity");
+    if (entity == core::INVALID_ENTITY)
+        return;
+    if (!layout_.sparseSet.Contains(arena_, entity))
+    {
+        SetBody(layout_.sparseSet.Insert(arena_, entity), Body{});
+    }
+    entityManager_.AddComponent(entity, componentType);
+}
 
-PhysicsManager::PhysicsManager(core::EntityManager& entityManager) :
-    entityManager_(entityManager), bodyManager_(entityManager), boxManager_(entityManager)
+void BodyManager::RemoveComponent(core::Entity entity)
 {
+    gpr_assert(entity != core::INVALID_ENTITY, "Invalid Entity");
+    gpr_warn(entityManager_.HasComponent(entity, componentType), "Entity has not the removing component");
+    entityManager_.RemoveComponent(entity, componentType);
+    if (!layout_.sparseSet.Contains(arena_, entity))
+        return;
+    layout_.sparseSet.Erase(arena_, entity);
+}
 
+Body BodyManager::GetComponent(core::Entity entity) const
+{
+    gpr_warn(entityManager_.HasComponent(entity, componentType), "Entity has not the requested component");
+    gpr_assert(layout_.sparseSet.Contains(arena_, entity), "Entity component is not stored");
+    return GetBody(layout_.sparseSet.GetIndex(arena_, entity));
+}
+
+core::Vec2f BodyManager::GetPosition(core::Entity entity) const
+{
+    gpr_assert(layout_.sparseSet.Contains(arena_, entity), "Entity component is not stored");
+    return arena_.Get<core::Vec2f>(layout_.positions)[layout_.sparseSet.GetIndex(arena_, entity)];
+}
+
+void BodyManager::SetComponent(core::Entity entity, const Body& body)
+{
+    gpr_warn(entityManager_.HasComponent(entity, componentType), "Entity has not the requested component");
+    gpr_assert(layout_.sparseSet.Contains(arena_, entity), "Entity component is not stored");
+    SetBody(layout_.sparseSet.GetIndex(arena_, entity), body);
+}
+
+void BodyManager::UpdateSimulatedBodies()
+{
+    const auto entities = layout_.sparseSet.GetEntities(arena_);
+    simulatedBodies_.resize(entities.size());
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        simulatedBodies_[i] = entityManager_.HasComponent(entities[i], componentType) ? 1 : 0;
+    }
+}
+
+void BodyManager::Integrate(core::Scalar dt)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    UpdateSimulatedBodies();
+    const auto bodyNmb = layout_.sparseSet.GetSize(arena_);
+    auto* positions = arena_.Get<core::Vec2f>(layout_.positions);
+    auto* velocities = arena_.Get<core::Vec2f>(layout_.velocities);
+    auto* angularVelocities = arena_.Get<core::Degree>(layout_.angularVelocities);
+    auto* rotations = arena_.Get<core::Degree>(layout_.rotations);
+    const auto* bodyTypes = arena_.Get<BodyType>(layout_.bodyTypes);
+    const auto* simulatedBodies = simulatedBodies_.data();
+    //Selecting the results instead of branching lets the loop vectorise,
+    //and unlike adding a zero velocity, it keeps the exact same floats as updating each body on its own
+    for (std::size_t i = 0; i < bodyNmb; i++)
+    {
+        //Bitwise operators avoid the short-circuit branches
+        const bool isSimulated = simulatedBodies[i] != 0;
+        const bool isStatic = bodyTypes[i] == BodyType::STATIC;
+        const bool isMoving = isSimulated & !isStatic;
+        const bool isStopped = isSimulated & isStatic;
+        const core::Scalar movedX = positions[i].x + velocities[i].x * dt;
+        const core::Scalar movedY = positions[i].y + velocities[i].y * dt;
+        const core::Scalar rotated = rotations[i].value() + angularVelocities[i].value() * dt;
+        positions[i].x = isMoving ? movedX : positions[i].x;
+        positions[i].y = isMoving ? movedY : positions[i].y;
+        rotations[i] = core::Degree(isMoving ? rotated : rotations[i].value());
+        velocities[i].x = isStopped ? 0.0f : velocities[i].x;
+        velocities[i].y = isStopped ? 0.0f : velocities[i].y;
+        angularVelocities[i] = core::Degree(isStopped ? 0.0f : angularVelocities[i].value());
+    }
+}
+
+void BodyManager::ResolveGravityAndGround(core::Scalar dt)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //Triggers might have added or removed bodies since the integration
+    UpdateSimulatedBodies();
+    GravityAndGroundKernel(arena_.Get<core::Vec2f>(layout_.positions), arena_.Get<core::Vec2f>(layout_.velocities),
+        arena_.Get<std::uint8_t>(layout_.affectedByGravity), simulatedBodies_.data(), layout_.sparseSet.GetSize(arena_), gravity * dt);
 }
 
 /**
@@ -32,25 +197,12 @@ constexpr bool Box2Box(const core::Vec2f pos1,const core::Vec2f extend1,
         pos1.x + extend1.x >= pos2.x - extend2.x &&
         pos1.y + extend1.y >= pos2.y - extend2.y;
 }
-void PhysicsManager::FixedUpdate(sf::Time dt)
-{
-#ifdef TRACY_ENABLE
-    ZoneScoped;
-#endif
-
-    UpdatePositionFromVelocity(dt);
-	ResolveCollision();
-	ResolveGravity(dt);
-    ResolveGround();
-
-}
-
 void PhysicsManager::SetBody(core::Entity entity, const Body& body)
 {
     bodyManager_.SetComponent(entity, body);
 }
 
-const Body& PhysicsManager::GetBody(core::Entity entity) const
+Body PhysicsManager::GetBody(core::Entity entity) const
 {
     return bodyManager_.GetComponent(entity);
 }
@@ -60,11 +212,21 @@ void PhysicsManager::AddBody(core::Entity entity)
     bodyManager_.AddComponent(entity);
 }
 
+void PhysicsManager::RemoveBody(core::Entity entity)
+{
+    bodyManager_.RemoveComponent(entity);
+}
+
 void PhysicsManager::AddBox(core::Entity entity)
 {
     boxManager_.AddComponent(entity);
 }
 
+void PhysicsManager::RemoveBox(core::Entity entity)
+{
+    boxManager_.RemoveComponent(entity);
+}
+
 void PhysicsManager::SetBox(core::Entity entity, const Box& box)
 {
     boxManager_.SetComponent(entity, box);
@@ -75,129 +237,69 @@ const Box& PhysicsManager::GetBox(core::Entity entity) const
     return boxManager_.GetComponent(entity);
 }
 
-void PhysicsManager::RegisterTriggerListener(OnTriggerInterface& onTriggerInterface)
+bool PhysicsManager::IsInContact(core::Entity entity1, core::Entity entity2) const
 {
-    onTriggerAction_.RegisterCallback(
-        [&onTriggerInterface](core::Entity entity1, core::Entity entity2) { onTriggerInterface.OnTrigger(entity1, entity2); });
+    return Box2Box(bodyManager_.GetPosition(entity1), boxManager_.GetComponent(entity1).extends,
+        bodyManager_.GetPosition(entity2), boxManager_.GetComponent(entity2).extends);
 }
 
-void PhysicsManager::CopyAllComponents(const PhysicsManager& physicsManager)
+void PhysicsManager::SetBroadphase(std::unique_ptr<BroadphaseInterface> broadphase)
 {
-    bodyManager_.CopyAllComponents(physicsManager.bodyManager_.GetAllComponents());
-    boxManager_.CopyAllComponents(physicsManager.boxManager_.GetAllComponents());
+    broadphase_ = std::move(broadphase);
 }
 
 void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 {
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    const ColliderView colliderView(entityManager_);
+    colliderView.ForEach([this, &renderTarget](core::Entity, const Body& body, const Box& box)
     {
-        if (!entityManager_.HasComponent(entity,
-            static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
-            static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)) ||
-            entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-            continue;
-        const auto& [extends, isTrigger] = boxManager_.GetComponent(entity);
-        const auto& body = bodyManager_.GetComponent(entity);
+        const sf::Vector2f extends = box.extends;
         sf::RectangleShape rectShape;
         rectShape.setFillColor(core::Color::transparent());
         rectShape.setOutlineColor(core::Color::green());
         rectShape.setOutlineThickness(2.0f);
-        const auto position = body.position;
+        const sf::Vector2f position = body.position;
         rectShape.setOrigin({ extends.x * core::pixelPerMeter, extends.y * core::pixelPerMeter });
         rectShape.setPosition(
             position.x * core::pixelPerMeter + center_.x,
             windowSize_.y - (position.y * core::pixelPerMeter + center_.y));
         rectShape.setSize({ extends.x * 2.0f * core::pixelPerMeter, extends.y * 2.0f * core::pixelPerMeter });
         renderTarget.draw(rectShape);
-    }
+    }, bodyManager_, boxManager_);
 }
 
-	void PhysicsManager::UpdatePositionFromVelocity(sf::Time dt)
+void PhysicsManager::FindContacts()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    colliderEntities_.clear();
+    colliderProxies_.clear();
+    contacts_.clear();
+    const ColliderView colliderView(entityManager_);
+    colliderView.ForEach([this](core::Entity entity, const Body& body, const Box& box)
     {
+        colliderEntities_.push_back(entity);
+        colliderProxies_.push_back({
+            core::Vec2f(body.position.x - box.extends.x, body.position.y - box.extends.y),
+            core::Vec2f(body.position.x + box.extends.x, body.position.y + box.extends.y) });
+    }, bodyManager_, boxManager_);
+    broadphase_->FindPairs(colliderProxies_, colliderPairs_);
+    //Colliders are in ascending Entity order, so sorting the pairs gives the same contacts order on the server and the clients
+    std::sort(colliderPairs_.begin(), colliderPairs_.end());
 
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-        {
-            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BODY2D)))
-                continue;
-            auto body = bodyManager_.GetComponent(entity);
-
-            if (body.bodyType == BodyType::DYNAMIC || body.bodyType == BodyType::KINEMATIC) {
-                body.position += body.velocity * dt.asSeconds();
-                body.rotation += body.angularVelocity * dt.asSeconds();
-            }
-            if (body.bodyType == BodyType::STATIC)
-            {
-                body.velocity = core::Vec2f::zero();
-                body.angularVelocity = core::Degree(0.0f);
-            }
-
-            bodyManager_.SetComponent(entity, body);
-        }
-    }
-
-
-	void PhysicsManager::ResolveCollision()
-	{
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-        {
-            if (!entityManager_.HasComponent(entity,
-                static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
-                static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)) ||
-                entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-                continue;
-            for (core::Entity otherEntity = entity + 1; otherEntity < entityManager_.GetEntitiesSize(); otherEntity++)
-            {
-                if (!entityManager_.HasComponent(otherEntity,
-                    static_cast<core::EntityMask>(core::ComponentType::BODY2D) | static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)) ||
-                    entityManager_.HasComponent(otherEntity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-                    continue;
-                const Body& body1 = bodyManager_.GetComponent(entity);
-                const Box& box1 = boxManager_.GetComponent(entity);
-
-                const Body& body2 = bodyManager_.GetComponent(otherEntity);
-                const Box& box2 = boxManager_.GetComponent(otherEntity);
-
-                if (Box2Box(body1.position, box1.extends,
-                    body2.position, box2.extends))
-                {
-                    onTriggerAction_.Execute(entity, otherEntity);
-                }
-
-            }
-        }
-	}
-
-	void PhysicsManager::ResolveGravity(sf::Time dt)
-	{
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-        {
-            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BODY2D)))
-                continue;
-
-            auto body = bodyManager_.GetComponent(entity);
-            if(body.affectedByGravity_)
-            {
-                body.velocity += gravity * dt.asSeconds();
-                bodyManager_.SetComponent(entity, body);
-            }
-        }
-	}
+    for (const auto& [first, second] : colliderPairs_)
+    {
+        const core::Entity entity = colliderEntities_[first];
+        const core::Entity otherEntity = colliderEntities_[second];
+        const Box& box1 = boxManager_.GetComponent(entity);
+        const Box& box2 = boxManager_.GetComponent(otherEntity);
 
-    void PhysicsManager::ResolveGround()
-	{
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        if (Box2Box(bodyManager_.GetPosition(entity), box1.extends,
+            bodyManager_.GetPosition(otherEntity), box2.extends))
         {
-            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BODY2D)))
-                continue;
-
-            auto body = bodyManager_.GetComponent(entity);
-            if (body.affectedByGravity_ && body.position.y <= groundLevel)
-            {
-                body.position.y = groundLevel;
-                body.velocity.y = 0.0f;
-                bodyManager_.SetComponent(entity, body);
-            }
+            contacts_.push_back({ entity, otherEntity });
         }
-
-	}
+    }
+}
 }
@@ -6,8 +6,9 @@
 #endif
 namespace game
 {
-PlayerCharacterManager::PlayerCharacterManager(core::EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager) :
-    ComponentManager(entityManager),
+PlayerCharacterManager::PlayerCharacterManager(core::EntityManager& entityManager, const core::ArenaComponentLayout<PlayerCharacter>& layout,
+    core::Arena& arena, PhysicsManager& physicsManager, GameManager& gameManager) :
+    ArenaComponentManager(entityManager, layout, arena),
     physicsManager_(physicsManager),
     gameManager_(gameManager)
 {
@@ -23,7 +24,7 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
         const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-        if (!entityManager_.HasComponent(playerEntity,
+        if (playerEntity == core::INVALID_ENTITY || !entityManager_.HasComponent(playerEntity,
             static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
             continue;
         auto playerBody = physicsManager_.GetBody(playerEntity);
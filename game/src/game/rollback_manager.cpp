@@ -1,9 +1,15 @@
 #include <game/rollback_manager.h>
 #include <game/game_manager.h>
+#include <game/speculative_branch.h>
+#include "engine/entity_view.h"
 #include "utils/assert.h"
+#include "utils/hash.h"
 #include <utils/log.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <numeric>
+
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
@@ -11,102 +17,299 @@
 namespace game
 {
 
-RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager& entityManager) :
-    gameManager_(gameManager), entityManager_(entityManager),
-    currentTransformManager_(entityManager),
-    currentPhysicsManager_(entityManager), currentPlayerManager_(entityManager, currentPhysicsManager_, gameManager_),
-    currentAttackManager_(entityManager, gameManager),
-    lastValidatePhysicsManager_(entityManager),
-    lastValidatePlayerManager_(entityManager, lastValidatePhysicsManager_, gameManager_), lastValidateAttackManager_(entityManager, gameManager)
+void WorldArenaLayout::RemoveEntity(core::Arena& arena, core::Entity entity) const
 {
-    for (auto& input : inputs_)
+    for (const auto* sparseSet : { &physics.bodies.sparseSet, &physics.boxes.sparseSet,
+        &playerCharacters.sparseSet, &attacks.sparseSet })
     {
-        std::fill(input.begin(), input.end(), '\0');
+        if (sparseSet->Contains(arena, entity))
+        {
+            sparseSet->Erase(arena, entity);
+        }
     }
-    currentPhysicsManager_.RegisterTriggerListener(*this);
 }
 
-void RollbackManager::SimulateToCurrentFrame()
+namespace
+{
+/**
+ * \brief HashElements is a function that hashes count component elements with the hashElement function.
+ * The element hashes are summed, such that the checksum depends neither on the Entity of the elements nor on their order,
+ * as a client can give other entities than the server to its predicted then validated attacks.
+ * The elements that belong to a player need to hash its PlayerNumber, to tell them apart from the elements of other players.
+ */
+template<typename HashElementFunc>
+Checksum HashElements(std::size_t count, HashElementFunc hashElement)
 {
+    Checksum elementSum = 0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        core::Hasher hasher;
+        hashElement(hasher, i);
+        elementSum += hasher.Digest();
+    }
+    core::Hasher hasher;
+    hasher.Update(static_cast<std::uint64_t>(count));
+    hasher.Update(elementSum);
+    return hasher.Digest();
+}
 
+/**
+ * \brief ContactCategory is the kind of an Entity in contact, given by its components.
+ */
+enum class ContactCategory : std::uint8_t
+{
+    OTHER,
+    PLAYER,
+    ATTACK,
+    LENGTH
+};
+
+/**
+ * \brief ContactHandler is the RollbackManager method managing two entities in contact, in the order of the contact or swapped.
+ */
+enum class ContactHandler : std::uint8_t
+{
+    NONE,
+    PLAYER_ATTACK,
+    ATTACK_PLAYER,
+    PLAYER_PLAYER
+};
+
+constexpr auto contactCategoryNmb = static_cast<std::size_t>(ContactCategory::LENGTH);
+using ContactHandlerTable = std::array<std::array<ContactHandler, contactCategoryNmb>, contactCategoryNmb>;
+
+/**
+ * \brief contactHandlers is the compile-time table giving the ContactHandler of the categories of both entities in contact.
+ */
+constexpr ContactHandlerTable contactHandlers = []
+{
+    constexpr auto player = static_cast<std::size_t>(ContactCategory::PLAYER);
+    constexpr auto attack = static_cast<std::size_t>(ContactCategory::ATTACK);
+    ContactHandlerTable table{};
+    table[player][attack] = ContactHandler::PLAYER_ATTACK;
+    table[attack][player] = ContactHandler::ATTACK_PLAYER;
+    table[player][player] = ContactHandler::PLAYER_PLAYER;
+    return table;
+}();
+}
+
+WorldChecksum WorldArenaLayout::ComputeChecksum(const core::Arena& arena) const
+{
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    const auto currentFrame = gameManager_.GetCurrentFrame();
-    const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
-    //Destroying all created Entities after the last validated frame
-    for (const auto& createdEntity : createdEntities_)
+    std::array<Checksum, checksumComponentNmb> components{};
+    const auto* players = arena.Get<PlayerCharacter>(playerCharacters.components);
+    //The player numbers are the same on all the peers, unlike the entities of the players
+    const auto getPlayerNumber = [&](core::Entity entity)
     {
-        if (createdEntity.createdFrame > lastValidateFrame)
-        {
-            entityManager_.DestroyEntity(createdEntity.entity);
-        }
+        const auto index = playerCharacters.sparseSet.GetIndex(arena, entity);
+        return index == core::ArenaSparseSet::INVALID_INDEX ? INVALID_PLAYER : players[index].playerNumber;
+    };
+    {
+        const auto& bodies = physics.bodies;
+        const auto* positions = arena.Get<core::Vec2f>(bodies.positions);
+        const auto* velocities = arena.Get<core::Vec2f>(bodies.velocities);
+        const auto* angularVelocities = arena.Get<core::Degree>(bodies.angularVelocities);
+        const auto* rotations = arena.Get<core::Degree>(bodies.rotations);
+        const auto* bodyTypes = arena.Get<BodyType>(bodies.bodyTypes);
+        const auto* affectedByGravity = arena.Get<std::uint8_t>(bodies.affectedByGravity);
+        const auto bodyEntities = bodies.sparseSet.GetEntities(arena);
+        components[static_cast<std::size_t>(ChecksumComponent::BODY)] = HashElements(bodyEntities.size(),
+            [&](core::Hasher& hasher, std::size_t i)
+            {
+                hasher.Update(getPlayerNumber(bodyEntities[i]));
+                hasher.Update(positions[i].x);
+                hasher.Update(positions[i].y);
+                hasher.Update(velocities[i].x);
+                hasher.Update(velocities[i].y);
+                hasher.Update(angularVelocities[i].value());
+                hasher.Update(rotations[i].value());
+                hasher.Update(bodyTypes[i]);
+                hasher.Update(affectedByGravity[i]);
+            });
     }
-    createdEntities_.clear();
-    //Remove DESTROY flags
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
     {
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        const auto* boxes = arena.Get<Box>(physics.boxes.components);
+        const auto boxEntities = physics.boxes.sparseSet.GetEntities(arena);
+        components[static_cast<std::size_t>(ChecksumComponent::BOX)] = HashElements(boxEntities.size(),
+            [&](core::Hasher& hasher, std::size_t i)
+            {
+                hasher.Update(getPlayerNumber(boxEntities[i]));
+                hasher.Update(boxes[i].extends.x);
+                hasher.Update(boxes[i].extends.y);
+                hasher.Update(static_cast<std::uint8_t>(boxes[i].isTrigger));
+            });
+    }
+    {
+        components[static_cast<std::size_t>(ChecksumComponent::PLAYER_CHARACTER)] = HashElements(playerCharacters.sparseSet.GetSize(arena),
+            [players](core::Hasher& hasher, std::size_t i)
+            {
+                const auto& player = players[i];
+                hasher.Update(player.shootingTime);
+                hasher.Update(player.input);
+                hasher.Update(player.playerNumber);
+                hasher.Update(player.health);
+                hasher.Update(player.actualStateTime);
+                hasher.Update(player.doubleClickTimeRight);
+                hasher.Update(player.doubleClickTimeLeft);
+                hasher.Update(player.playerState);
+                hasher.Update(static_cast<std::uint8_t>(player.oldRightClick));
+                hasher.Update(static_cast<std::uint8_t>(player.oldLeftClick));
+                hasher.Update(static_cast<std::uint8_t>(player.playerFaceRight));
+            });
+    }
+    {
+        const auto* attackComponents = arena.Get<Attack>(attacks.components);
+        components[static_cast<std::size_t>(ChecksumComponent::ATTACK)] = HashElements(attacks.sparseSet.GetSize(arena),
+            [attackComponents](core::Hasher& hasher, std::size_t i)
+            {
+                hasher.Update(attackComponents[i].remainingTime);
+                hasher.Update(attackComponents[i].playerNumber);
+            });
+    }
+    core::Hasher hasher;
+    hasher.UpdateArray(components.data(), components.size());
+    return { hasher.Digest(), components };
+}
+
+RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager& entityManager,
+    std::size_t windowCapacity, WorldMode worldMode) :
+    gameManager_(gameManager), entityManager_(entityManager), worldMode_(worldMode),
+    currentWorld_(worldLayout_.layout, worldArenaInitCapacity),
+    //The validated world is the current world, its copy is never filled
+    lastValidateWorld_(worldLayout_.layout, worldMode == WorldMode::ROLLBACK ? worldArenaInitCapacity : 0),
+    currentTransformManager_(entityManager),
+    currentPhysicsManager_(entityManager, worldLayout_.physics, currentWorld_),
+    currentPlayerManager_(entityManager, worldLayout_.playerCharacters, currentWorld_, currentPhysicsManager_, gameManager_),
+    currentAttackManager_(entityManager, worldLayout_.attacks, currentWorld_, gameManager),
+    lastValidatePhysicsManager_(entityManager, worldLayout_.physics, lastValidateWorld_),
+    lastValidatePlayerManager_(entityManager, worldLayout_.playerCharacters, lastValidateWorld_, lastValidatePhysicsManager_, gameManager_),
+    lastValidateAttackManager_(entityManager, worldLayout_.attacks, lastValidateWorld_, gameManager)
+{
+    if (worldMode_ == WorldMode::ROLLBACK)
+    {
+        snapshots_.reserve(windowCapacity);
+        for (std::size_t i = 0; i < windowCapacity; i++)
         {
-            entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+            snapshots_.emplace_back(worldLayout_.layout, worldArenaInitCapacity);
         }
     }
+    for (auto& input : inputs_)
+    {
+        input.Reserve(windowCapacity);
+    }
+    inputPredictor_ = std::make_unique<RepeatLastInputPredictor>();
+    predictionFrames_.fill(INVALID_FRAME);
+}
 
-    //Revert the current game state to the last validated game state
-    currentAttackManager_.CopyAllComponents(lastValidateAttackManager_.GetAllComponents());
-    currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
-    currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
+RollbackManager::~RollbackManager() = default;
 
-    for (Frame frame = lastValidateFrame + 1; frame <= currentFrame; frame++)
+bool RollbackManager::SimulateToCurrentFrame()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    gpr_assert(worldMode_ == WorldMode::ROLLBACK, "Only a rollback world can simulate predicted frames");
+    const auto start = std::chrono::steady_clock::now();
+    const auto currentFrame = gameManager_.GetCurrentFrame();
+    UpdatePredictions();
+    //A speculative branch simulated with the right inputs saves the rollback
+    AdoptSpeculation();
+    //Go back to the last frame simulated with the right inputs
+    RevertToDirtyFrame();
+    if (simulatedFrame_ > currentFrame)
     {
-        testedFrame_ = frame;
-        //Copy player inputs to player manager
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        RevertToFrame(std::max(currentFrame, lastValidateFrame_));
+    }
+
+    //Only simulate the frames that are not up to date
+    //The mispredictions received meanwhile may have reverted the progress of the previous incomplete calls
+    const bool isBudgeted = incompleteSimulationNmb_ < maxIncompleteSimulationNmb;
+    Frame simulatedFrameNmb = 0;
+    for (Frame frame = simulatedFrame_ + 1; frame <= currentFrame; frame++)
+    {
+        if (isBudgeted && simulatedFrameNmb > 0 &&
+            ((simulationBudget_.maxFrameNmb > 0 && simulatedFrameNmb >= simulationBudget_.maxFrameNmb) ||
+            (simulationBudget_.maxDuration.count() > 0 && std::chrono::steady_clock::now() - start >= simulationBudget_.maxDuration)))
         {
-            const auto playerInput = GetInputAtFrame(playerNumber, frame);
-            const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-            if (playerEntity == core::INVALID_ENTITY)
-            {
-                core::LogWarning(fmt::format("Invalid Entity in {}:line {}", __FILE__, __LINE__));
-                continue;
-            }
-            auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-            playerCharacter.input = playerInput;
-            currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
+            //The rest of the rollback is simulated by the next calls, the transforms keep the last consistent frame
+            incompleteSimulationNmb_++;
+            return false;
         }
-        //Simulate one frame of the game
-        currentAttackManager_.FixedUpdate(sf::seconds(fixedPeriod));
-        currentPlayerManager_.FixedUpdate(sf::seconds(fixedPeriod));
-        currentPhysicsManager_.FixedUpdate(sf::seconds(fixedPeriod));
+        SimulateFrame(frame);
+        simulatedFrameNmb++;
     }
+    incompleteSimulationNmb_ = 0;
     //Copy the physics states to the transforms
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    const core::EntityView<
+        static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
+        static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)> bodyTransformView(entityManager_);
+    bodyTransformView.ForEach([this](core::Entity entity)
     {
-        if (!entityManager_.HasComponent(entity,
-            static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
-            static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
-            continue;
-        const auto& body = currentPhysicsManager_.GetBody(entity);
-        currentTransformManager_.SetPosition(entity, body.position);
-    }
+        currentTransformManager_.SetPosition(entity, currentPhysicsManager_.GetBody(entity).position);
+    });
+    LaunchSpeculation();
+    return true;
 }
 void RollbackManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, Frame inputFrame)
 {
-    //Should only be called on the server
-    if (currentFrame_ < inputFrame)
+    //A wrong frame number or a player stalled for the whole window would grow the window without limit
+    if (inputFrame > GetWindowEndFrame())
     {
-        StartNewFrame(inputFrame);
+        core::LogWarning(fmt::format("Input of player {} on frame {} is rejected, the window ends on frame {}",
+            playerNumber + 1, inputFrame, GetWindowEndFrame()));
+        return;
     }
-    inputs_[playerNumber][currentFrame_ - inputFrame] = playerInput;
-    if (lastReceivedFrame_[playerNumber] < inputFrame)
+    //The current frame follows the game frame, an input ahead of it is stored until the game reaches its frame
+    StartNewInputFrame(playerNumber, inputFrame);
+    auto& inputs = inputs_[playerNumber];
+    //The frames older than the window are already validated
+    if (!inputs.Contains(inputFrame))
+        return;
+    playerInput = static_cast<PlayerInput>(playerInput & playerInputMask);
+    if (!inputs.IsReceived(inputFrame))
     {
-        lastReceivedFrame_[playerNumber] = inputFrame;
-        //Repeat the same inputs until currentFrame
-        for (size_t i = 0; i < currentFrame_ - inputFrame; i++)
+        inputs.SetReceived(inputFrame);
+        //The frames older than the window are already validated
+        auto& lastContiguousFrame = lastContiguousFrame_[playerNumber];
+        while (lastContiguousFrame < inputs.GetCurrentFrame() &&
+            (!inputs.Contains(lastContiguousFrame + 1) || inputs.IsReceived(lastContiguousFrame + 1)))
         {
-            inputs_[playerNumber][i] = playerInput;
+            lastContiguousFrame++;
         }
+        //The prediction was already used in the simulation
+        if (inputFrame <= simulatedFrame_)
+        {
+            auto& predictionStats = predictionStats_[playerNumber];
+            if (inputs.GetInput(inputFrame) == playerInput)
+            {
+                predictionStats.confirmationNmb++;
+            }
+            else
+            {
+                predictionStats.mispredictionNmb++;
+            }
+        }
+    }
+    const bool inputChanged = inputs.GetInput(inputFrame) != playerInput;
+    if (inputChanged)
+    {
+        inputs.SetInput(inputFrame, playerInput);
+        dirtyFrame_ = std::min(dirtyFrame_, inputFrame);
+    }
+    if (lastReceivedFrame_[playerNumber] < inputFrame)
+    {
+        lastReceivedFrame_[playerNumber] = inputFrame;
+    }
+    else if (!inputChanged)
+    {
+        return;
     }
+    //The predictions after the last received input depend on the received inputs,
+    //they are updated once before the next simulation instead of after each input of a packet
+    predictionFrames_[playerNumber] = lastReceivedFrame_[playerNumber] + 1;
 }
 
 void RollbackManager::StartNewFrame(Frame newFrame)
@@ -115,24 +318,23 @@ void RollbackManager::StartNewFrame(Frame newFrame)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    if (currentFrame_ > newFrame)
+    if (currentFrame_ >= newFrame)
         return;
-    const auto delta = newFrame - currentFrame_;
-    if (delta == 0)
+    if (newFrame > GetWindowEndFrame())
     {
+        gpr_assert(false, "Trying to start a frame after the end of the window");
         return;
     }
-    for (auto& inputs : inputs_)
+    //A lagging player delays the validation, the window grows instead of overwriting frames that are not validated yet
+    const std::size_t windowFrameNmb = newFrame - lastValidateFrame_ + 1;
+    if (windowFrameNmb > GetWindowCapacity())
     {
-        for (auto i = inputs.size() - 1; i >= delta; i--)
-        {
-            inputs[i] = inputs[i - delta];
-        }
-
-        for (Frame i = 0; i < delta; i++)
-        {
-            inputs[i] = inputs[delta];
-        }
+        ReserveWindow(windowFrameNmb);
+    }
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        inputs_[playerNumber].StartNewFrame(newFrame);
+        predictionFrames_[playerNumber] = std::min(predictionFrames_[playerNumber], currentFrame_ + 1);
     }
     currentFrame_ = newFrame;
 }
@@ -143,131 +345,111 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
     //We check that we got all the inputs
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
-        if (GetLastReceivedFrame(playerNumber) < newValidateFrame)
+        if (GetLastContiguousFrame(playerNumber) < newValidateFrame)
         {
             gpr_assert(false, "We should not validate a frame if we did not receive all inputs!!!");
             return;
         }
     }
-    //Destroying all created Entities after the last validated frame
-    for (const auto& createdEntity : createdEntities_)
+    if (newValidateFrame <= lastValidateFrame_)
+        return;
+    if (worldMode_ == WorldMode::VALIDATED)
     {
-        if (createdEntity.createdFrame > lastValidateFrame)
-        {
-            entityManager_.DestroyEntity(createdEntity.entity);
-        }
+        AdvanceValidatedWorld(newValidateFrame);
+        return;
     }
+    //Go back to the last frame simulated with the right inputs
+    RevertToDirtyFrame();
 
-    createdEntities_.clear();
-    //Remove DESTROYED flag
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    //We simulate the frames until the new validated frame if needed
+    for (Frame frame = simulatedFrame_ + 1; frame <= newValidateFrame; frame++)
     {
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-        {
-            entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
-        }
-
+        SimulateFrame(frame);
     }
-    createdEntities_.clear();
-
-    //We use the current game state as the temporary new validate game state
-    currentAttackManager_.CopyAllComponents(lastValidateAttackManager_.GetAllComponents());
-    currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
-    currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
-
-    //We simulate the frames until the new validated frame
-    for (Frame frame = lastValidateFrame_ + 1; frame <= newValidateFrame; frame++)
+    //The speculative branches cannot go back before the new validated frame
+    if (newValidateFrame >= speculationFrame_)
     {
-        testedFrame_ = frame;
-        //Copy the players inputs into the player manager
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-        {
-            const auto playerInput = GetInputAtFrame(playerNumber, frame);
-            const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-            auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-            playerCharacter.input = playerInput;
-            currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
-        }
-        //We simulate one frame
-        currentAttackManager_.FixedUpdate(sf::seconds(fixedPeriod));
-        currentPlayerManager_.FixedUpdate(sf::seconds(fixedPeriod));
-        currentPhysicsManager_.FixedUpdate(sf::seconds(fixedPeriod));
+        speculationFrame_ = INVALID_FRAME;
     }
-    //Definitely remove DESTROY entities
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    //Definitely remove DESTROY entities until the new validated frame,
+    //the journal is in frame order so only the records of the validated frames are visited
+    while (!destroyedEntities_.empty() && destroyedEntities_.front().destroyedFrame <= newValidateFrame)
     {
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-        {
-            entityManager_.DestroyEntity(entity);
-        }
+        const auto entity = destroyedEntities_.front().entity;
+        //The worlds of the speculative branches still contain the removed components
+        speculationFrame_ = INVALID_FRAME;
+        RemoveRollbackComponents(entity, newValidateFrame);
+        entityManager_.DestroyEntity(entity);
+        destroyedEntities_.pop_front();
+    }
+    //Created entities until the new validated frame cannot be rollbacked anymore
+    while (!createdEntities_.empty() && createdEntities_.front().createdFrame <= newValidateFrame)
+    {
+        createdEntities_.pop_front();
     }
-    //Copy back the new validate game state to the last validated game state
-    lastValidateAttackManager_.CopyAllComponents(currentAttackManager_.GetAllComponents());
-    lastValidatePlayerManager_.CopyAllComponents(currentPlayerManager_.GetAllComponents());
-    lastValidatePhysicsManager_.CopyAllComponents(currentPhysicsManager_);
+    //Copy the new validate frame snapshot to the last validated game state
+    lastValidateWorld_.CopyFrom(GetSnapshot(newValidateFrame));
+    lastValidateChecksum_ = worldLayout_.ComputeChecksum(lastValidateWorld_);
     lastValidateFrame_ = newValidateFrame;
-    createdEntities_.clear();
 }
-void RollbackManager::ConfirmFrame(Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState)
+
+void RollbackManager::AdvanceValidatedWorld(Frame newValidateFrame)
 {
 
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    ValidateFrame(newValidateFrame);
-    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    //All the inputs until the new validated frame are received, the world never goes back
+    gpr_assert(simulatedFrame_ == lastValidateFrame_, "The validated world cannot be ahead of the validated frame");
+    dirtyFrame_ = INVALID_FRAME;
+    for (Frame frame = simulatedFrame_ + 1; frame <= newValidateFrame; frame++)
     {
-        const PhysicsState lastPhysicsState = GetValidatePhysicsState(playerNumber);
-        if (serverPhysicsState[playerNumber] != lastPhysicsState)
-        {
-            gpr_assert(false, fmt::format("Physics State are not equal for player {} (server frame: {}, client frame: {}, server: {}, client: {})", 
-                playerNumber+1, 
-                newValidateFrame, 
-                lastValidateFrame_, 
-                serverPhysicsState[playerNumber], 
-                lastPhysicsState));
-        }
+        SimulateFrame(frame);
     }
-}
-PhysicsState RollbackManager::GetValidatePhysicsState(PlayerNumber playerNumber) const
-{
-    PhysicsState state = 0;
-    const core::Entity playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-    const auto& playerBody = lastValidatePhysicsManager_.GetBody(playerEntity);
-
-    const auto pos = playerBody.position;
-    const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
-    //Adding position
-    for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+    //Like on the clients, the entities are truly destroyed once their frames are validated
+    while (!destroyedEntities_.empty())
     {
-        state += posPtr[i];
+        const auto entity = destroyedEntities_.front().entity;
+        worldLayout_.RemoveEntity(currentWorld_, entity);
+        entityManager_.DestroyEntity(entity);
+        destroyedEntities_.pop_front();
     }
+    lastValidateChecksum_ = worldLayout_.ComputeChecksum(currentWorld_);
+    lastValidateFrame_ = newValidateFrame;
+}
+void RollbackManager::ConfirmFrame(Frame newValidateFrame, const WorldChecksum& serverChecksum)
+{
 
-    //Adding velocity
-    const auto velocity = playerBody.velocity;
-    const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&velocity);
-    for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    ValidateFrame(newValidateFrame);
+    if (serverChecksum.value == lastValidateChecksum_.value)
+        return;
+    std::string desyncComponents;
+    if (serverChecksum.components.has_value() && lastValidateChecksum_.components.has_value())
     {
-        state += velocityPtr[i];
+        for (std::size_t component = 0; component < checksumComponentNmb; component++)
+        {
+            if (serverChecksum.components.value()[component] != lastValidateChecksum_.components.value()[component])
+            {
+                desyncComponents += fmt::format("{}{}", desyncComponents.empty() ? "" : ", ", checksumComponentNames[component]);
+            }
+        }
     }
-    //Adding rotation
-    const auto angle = playerBody.rotation.value();
-    const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
+    else
     {
-        state += anglePtr[i];
+        desyncComponents = "unknown";
     }
-    //Adding angular Velocity
-    const auto angularVelocity = playerBody.angularVelocity.value();
-    const auto* angularVelPtr = reinterpret_cast<const PhysicsState*>(&angularVelocity);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += angularVelPtr[i];
-    }    return state;
+    gpr_assert(false, fmt::format("World checksums are not equal (server frame: {}, client frame: {}, server: {:016x}, client: {:016x}, desync components: {})",
+        newValidateFrame,
+        lastValidateFrame_,
+        serverChecksum.value,
+        lastValidateChecksum_.value,
+        desyncComponents));
 }
 
 void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position)
@@ -276,6 +458,8 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    speculationFrame_ = INVALID_FRAME;
+    ReserveEntity(entity);
     Body playerBody;
     playerBody.position = position;
     Box playerBox;
@@ -292,6 +476,8 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
     currentPhysicsManager_.AddBox(entity);
     currentPhysicsManager_.SetBox(entity, playerBox);
 
+    if (worldMode_ == WorldMode::VALIDATED)
+        return;
     lastValidatePlayerManager_.AddComponent(entity);
     lastValidatePlayerManager_.SetComponent(entity, playerCharacter);
 
@@ -304,120 +490,563 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
     currentTransformManager_.SetPosition(entity, position);
 }
 
+void RollbackManager::SpawnPlatform(core::Entity entity, core::Vec2f position, core::Vec2f extends)
+{
+    speculationFrame_ = INVALID_FRAME;
+    ReserveEntity(entity);
+    Body platformBody;
+    platformBody.position = position;
+    platformBody.bodyType = BodyType::STATIC;
+    platformBody.affectedByGravity_ = false;
+    Box platformBox;
+    platformBox.extends = extends;
+
+    entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::PLATFORM));
+
+    currentPhysicsManager_.AddBody(entity);
+    currentPhysicsManager_.SetBody(entity, platformBody);
+    currentPhysicsManager_.AddBox(entity);
+    currentPhysicsManager_.SetBox(entity, platformBox);
+
+    if (worldMode_ == WorldMode::VALIDATED)
+        return;
+    lastValidatePhysicsManager_.AddBody(entity);
+    lastValidatePhysicsManager_.SetBody(entity, platformBody);
+    lastValidatePhysicsManager_.AddBox(entity);
+    lastValidatePhysicsManager_.SetBox(entity, platformBox);
+
+    currentTransformManager_.AddComponent(entity);
+    currentTransformManager_.SetPosition(entity, position);
+}
+
 PlayerInput RollbackManager::GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const
 {
-    gpr_assert(currentFrame_ - frame < inputs_[playerNumber].size(),
-        "Trying to get input too far in the past");
-    return inputs_[playerNumber][currentFrame_ - frame];
+    return inputs_[playerNumber].GetInput(frame);
 }
 
-void RollbackManager::OnTrigger(core::Entity entity1, core::Entity entity2)
+void RollbackManager::SetInputPredictor(std::unique_ptr<InputPredictorInterface> inputPredictor)
 {
-   
+    inputPredictor_ = std::move(inputPredictor);
+    predictionStats_ = {};
+    resimulatedFrameNmb_ = 0;
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        predictionFrames_[playerNumber] = lastReceivedFrame_[playerNumber] + 1;
+    }
+}
 
-    const std::function<void(const PlayerCharacter&, core::Entity, const Attack&, core::Entity)> ManageCollisionAttack =
-        [this](const auto& player, auto playerEntity, const auto& attack, auto attackEntity)
+void RollbackManager::UpdatePredictions()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
-        if (player.playerNumber != attack.playerNumber && player.playerState != PlayerState::DASH)
+        const auto lastReceivedFrame = lastReceivedFrame_[playerNumber];
+        auto& inputs = inputs_[playerNumber];
+        for (auto frame = std::max(predictionFrames_[playerNumber], lastReceivedFrame + 1); frame <= currentFrame_; frame++)
         {
-            gameManager_.DestroyAttackBox(attackEntity);
-            //lower health point
-            auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-            auto playerBody = currentPhysicsManager_.GetBody(playerEntity);
-            
-        	core::LogDebug(fmt::format("Player {} is hit by attack", playerCharacter.playerNumber));
-            currentPlayerManager_.InitSpawn(playerCharacter, playerBody);
-
-            -- playerCharacter.health;
-            
-            currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
-            currentPhysicsManager_.SetBody(playerEntity, playerBody);
+            const auto prediction = inputPredictor_->Predict(inputs, lastReceivedFrame, frame);
+            if (inputs.GetInput(frame) != prediction)
+            {
+                inputs.SetInput(frame, prediction);
+                dirtyFrame_ = std::min(dirtyFrame_, frame);
+            }
         }
-    };
+        predictionFrames_[playerNumber] = INVALID_FRAME;
+    }
+}
 
-    const auto ManageCollisionPlayer =
-        [this](PlayerCharacter& firstPlayer, core::Entity firstPlayerEntity, PlayerCharacter& secondPlayer, core::Entity secondPlayerEntity)
+void RollbackManager::SimulateFrame(Frame frame)
+{
+    testedFrame_ = frame;
+    //Copy player inputs to player manager
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
-        if (firstPlayer.playerState != PlayerState::SPAWN && secondPlayer.playerState != PlayerState::SPAWN) {
-            if (firstPlayer.playerNumber != secondPlayer.playerNumber &&
-                !(firstPlayer.playerState == PlayerState::ATTACK && secondPlayer.playerState == PlayerState::DASH ||
-                    firstPlayer.playerState == PlayerState::DASH && secondPlayer.playerState == PlayerState::ATTACK))
-            {
-                auto firstPlayerBody = currentPhysicsManager_.GetBody(firstPlayerEntity);
-                const auto firstPlayerBox = currentPhysicsManager_.GetBox(firstPlayerEntity);
+        const auto playerInput = GetInputAtFrame(playerNumber, frame);
+        const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
+        if (playerEntity == core::INVALID_ENTITY)
+        {
+            core::LogWarning(fmt::format("Invalid Entity in {}:line {}", __FILE__, __LINE__));
+            continue;
+        }
+        auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
+        playerCharacter.input = playerInput;
+        currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
+    }
+    //Simulate one frame of the game
+    currentAttackManager_.FixedUpdate(sf::seconds(fixedPeriod));
+    currentPlayerManager_.FixedUpdate(sf::seconds(fixedPeriod));
+    currentPhysicsManager_.FixedUpdate(sf::seconds(fixedPeriod), *this);
 
-                auto secondPlayerBody = currentPhysicsManager_.GetBody(secondPlayerEntity);
-                const auto secondPlayerBox = currentPhysicsManager_.GetBox(secondPlayerEntity);
+    if (worldMode_ == WorldMode::ROLLBACK)
+    {
+        SaveSnapshot(frame);
+    }
+    simulatedFrame_ = frame;
+}
 
-                ResolveCollisionBoxToBox(firstPlayerBody, firstPlayerBox, secondPlayerBody, secondPlayerBox);
+void RollbackManager::RevertToDirtyFrame()
+{
+    if (dirtyFrame_ == INVALID_FRAME)
+        return;
+    //The changed frame needs to be simulated again, so we restart from the frame before
+    const auto revertFrame = dirtyFrame_ > lastValidateFrame_ ? dirtyFrame_ - 1 : lastValidateFrame_;
+    dirtyFrame_ = INVALID_FRAME;
+    if (revertFrame >= simulatedFrame_)
+        return;
+    resimulatedFrameNmb_ += simulatedFrame_ - revertFrame;
+    RevertToFrame(revertFrame);
+}
 
-                currentPhysicsManager_.SetBody(firstPlayerEntity, firstPlayerBody);
-                currentPhysicsManager_.SetBody(secondPlayerEntity, secondPlayerBody);
+void RollbackManager::RevertToFrame(Frame frame)
+{
 
-                if (firstPlayer.playerState == PlayerState::DASH)
-                {
-                    PlayerCharacterManager::InitStun(firstPlayer, firstPlayerBody);
-                }
-                if (secondPlayer.playerState == PlayerState::DASH)
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //The speculative branches start from a world that is not simulated anymore
+    if (frame + 1 < speculationFrame_)
+    {
+        speculationFrame_ = INVALID_FRAME;
+    }
+    RevertEntities(frame);
+    //Revert the current game state to the snapshot of the revert frame
+    currentWorld_.CopyFrom(frame == lastValidateFrame_ ? lastValidateWorld_ : GetSnapshot(frame));
+    simulatedFrame_ = frame;
+}
+
+void RollbackManager::RevertEntities(Frame frame)
+{
+    //Destroying all created Entities after the revert frame, from the last one
+    while (!createdEntities_.empty() && createdEntities_.back().createdFrame > frame)
+    {
+        const auto& createdEntity = createdEntities_.back();
+        //An outdated record must not destroy another entity reusing the same index
+        if (entityManager_.GetGeneration(createdEntity.entity) == createdEntity.generation)
+        {
+            entityManager_.DestroyEntity(createdEntity.entity);
+        }
+        else
+        {
+            gpr_warn(false, "Created entity record is outdated");
+        }
+        createdEntities_.pop_back();
+    }
+    //Remove DESTROY flags put after the revert frame
+    while (!destroyedEntities_.empty() && destroyedEntities_.back().destroyedFrame > frame)
+    {
+        entityManager_.RemoveComponent(destroyedEntities_.back().entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+        destroyedEntities_.pop_back();
+    }
+}
+
+void RollbackManager::SetSpeculativeBranchNmb(std::size_t branchNmb)
+{
+    //Each branch changes another button of the predicted input
+    branchNmb = std::min<std::size_t>(branchNmb, playerInputBitNmb);
+    speculationFrame_ = INVALID_FRAME;
+    speculationStats_ = {};
+    //Removed branches wait for their worker thread to finish
+    branches_.resize(std::min(branches_.size(), branchNmb));
+    while (branches_.size() < branchNmb)
+    {
+        branches_.push_back(std::make_unique<SpeculativeBranch>());
+    }
+}
+
+bool RollbackManager::IsSpeculating() const
+{
+    return std::any_of(branches_.begin(), branches_.end(), [](const auto& branch) { return branch->IsRunning(); });
+}
+
+void RollbackManager::LaunchSpeculation()
+{
+    if (branches_.empty() || speculationFrame_ != INVALID_FRAME)
+        return;
+    if (IsSpeculating())
+        return;
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //The most late remote player has the most frames to simulate again after a misprediction
+    auto speculatedPlayer = INVALID_PLAYER;
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        if (lastReceivedFrame_[playerNumber] < currentFrame_ &&
+            (speculatedPlayer == INVALID_PLAYER || lastReceivedFrame_[playerNumber] < lastReceivedFrame_[speculatedPlayer]))
+        {
+            speculatedPlayer = playerNumber;
+        }
+    }
+    if (speculatedPlayer == INVALID_PLAYER)
+        return;
+    const Frame startFrame = lastReceivedFrame_[speculatedPlayer] + 1;
+    if (startFrame <= lastValidateFrame_ || startFrame > simulatedFrame_)
+        return;
+
+    //The buttons the player changed the most on the last received frames are the most likely to change next
+    const auto& inputs = inputs_[speculatedPlayer];
+    std::array<std::uint32_t, playerInputBitNmb> changeNmbs{};
+    for (Frame frame = startFrame - 1; frame > 0 && startFrame - frame <= speculationHistoryFrameNmb && inputs.Contains(frame - 1); frame--)
+    {
+        const auto changedButtons = inputs.GetInput(frame) ^ inputs.GetInput(frame - 1);
+        for (std::uint8_t button = 0; button < playerInputBitNmb; button++)
+        {
+            changeNmbs[button] += changedButtons >> button & 1u;
+        }
+    }
+    std::array<std::uint8_t, playerInputBitNmb> buttons{};
+    std::iota(buttons.begin(), buttons.end(), std::uint8_t{ 0 });
+    std::stable_sort(buttons.begin(), buttons.end(), [&changeNmbs](auto button1, auto button2)
+        {
+            return changeNmbs[button1] > changeNmbs[button2];
+        });
+
+    //The main world already simulates the predicted input
+    const auto prediction = inputs.GetInput(startFrame);
+    for (std::size_t i = 0; i < branches_.size(); i++)
+    {
+        const auto startInput = static_cast<PlayerInput>(prediction ^ 1u << buttons[i]);
+        branches_[i]->Load(*this, speculatedPlayer, startFrame, startInput);
+        branches_[i]->Start();
+    }
+    speculationFrame_ = startFrame;
+    speculatedPlayer_ = speculatedPlayer;
+    speculationStats_.branchNmb += static_cast<std::uint32_t>(branches_.size());
+}
+
+void RollbackManager::AdoptSpeculation()
+{
+    if (speculationFrame_ == INVALID_FRAME)
+        return;
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto startFrame = speculationFrame_;
+    //An input changed before the speculation, the branches do not start from the right world
+    if (dirtyFrame_ < startFrame)
+    {
+        speculationFrame_ = INVALID_FRAME;
+        return;
+    }
+    //The branches keep simulating until the speculated input is received
+    if (lastReceivedFrame_[speculatedPlayer_] < startFrame)
+        return;
+    speculationFrame_ = INVALID_FRAME;
+    for (const auto& branch : branches_)
+    {
+        //A branch still running is not waited for, the rollback is simulated as usual
+        if (branch->IsRunning() || !branch->IsAdoptable())
+            continue;
+        const auto& branchRollbackManager = branch->GetRollbackManager();
+        if (branchRollbackManager.currentWorld_.GetCapacity() != currentWorld_.GetCapacity())
+            continue;
+        const auto endFrame = branchRollbackManager.simulatedFrame_;
+        bool inputsMatch = true;
+        for (Frame frame = startFrame; frame <= endFrame && inputsMatch; frame++)
+        {
+            for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+            {
+                if (GetInputAtFrame(playerNumber, frame) != branchRollbackManager.GetInputAtFrame(playerNumber, frame))
                 {
-                    PlayerCharacterManager::InitStun(secondPlayer, secondPlayerBody);
+                    inputsMatch = false;
+                    break;
                 }
             }
-            else
-            {
-                PlayerCharacter attackPlayer;
-                core::Entity attackPlayerEntity;
+        }
+        if (!inputsMatch)
+            continue;
 
-                if (firstPlayer.playerState == PlayerState::ATTACK)
-                {
-                    attackPlayer = firstPlayer;
-                    attackPlayerEntity = firstPlayerEntity;
-                }
-                else
-                {
-                    attackPlayer = secondPlayer;
-                    attackPlayerEntity = secondPlayerEntity;
-                }
+        RevertToFrame(startFrame - 1);
+        for (Frame frame = startFrame; frame <= endFrame; frame++)
+        {
+            snapshots_[frame % snapshots_.size()].CopyFrom(branchRollbackManager.GetSnapshot(frame));
+        }
+        currentWorld_.CopyFrom(branchRollbackManager.currentWorld_);
+        simulatedFrame_ = endFrame;
+        if (dirtyFrame_ <= endFrame)
+        {
+            dirtyFrame_ = INVALID_FRAME;
+        }
+        speculationStats_.adoptionNmb++;
+        speculationStats_.adoptedFrameNmb += endFrame - startFrame + 1;
+        return;
+    }
+}
 
-                auto attackPlayerBody = currentPhysicsManager_.GetBody(attackPlayerEntity);
-                currentPlayerManager_.InitSpawn(attackPlayer,attackPlayerBody);
+void RollbackManager::LoadBranch(RollbackManager& source, PlayerNumber playerNumber, Frame startFrame, PlayerInput startInput)
+{
+    const Frame baseFrame = startFrame - 1;
+    entityManager_.CopyFrom(source.entityManager_);
+    //The branch Arenas are copied from and to the source ones, they need the same capacity
+    const auto capacity = source.currentWorld_.GetCapacity();
+    if (currentWorld_.GetCapacity() != capacity)
+    {
+        currentWorld_ = core::Arena(worldLayout_.layout, capacity);
+        lastValidateWorld_ = core::Arena(worldLayout_.layout, capacity);
+        snapshots_.clear();
+    }
+    while (snapshots_.size() < source.snapshots_.size())
+    {
+        snapshots_.emplace_back(worldLayout_.layout, capacity);
+    }
+    currentWorld_.CopyFrom(baseFrame == source.lastValidateFrame_ ? source.lastValidateWorld_ : source.GetSnapshot(baseFrame));
+    createdEntities_.assign(source.createdEntities_.begin(), source.createdEntities_.end());
+    destroyedEntities_.assign(source.destroyedEntities_.begin(), source.destroyedEntities_.end());
+    RevertEntities(baseFrame);
+
+    //The input histories keep their buffers, they have the same capacity as the source ones
+    inputs_ = source.inputs_;
+    lastReceivedFrame_ = source.lastReceivedFrame_;
+    lastContiguousFrame_ = source.lastContiguousFrame_;
+    auto& inputs = inputs_[playerNumber];
+    inputs.SetInput(startFrame, startInput);
+    inputs.SetReceived(startFrame);
+    lastReceivedFrame_[playerNumber] = startFrame;
+    for (Frame frame = startFrame + 1; frame <= source.currentFrame_; frame++)
+    {
+        inputs.SetInput(frame, source.inputPredictor_->Predict(inputs, startFrame, frame));
+    }
+    lastValidateFrame_ = baseFrame;
+    simulatedFrame_ = baseFrame;
+    currentFrame_ = source.currentFrame_;
+    dirtyFrame_ = INVALID_FRAME;
+}
 
-                --attackPlayer.health;
+void RollbackManager::SimulateBranch()
+{
 
-                currentPlayerManager_.SetComponent(attackPlayerEntity, attackPlayer);
-                currentPhysicsManager_.SetBody(attackPlayerEntity, attackPlayerBody);
-            }
-        }
-    };
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    for (Frame frame = simulatedFrame_ + 1; frame <= currentFrame_; frame++)
+    {
+        SimulateFrame(frame);
+    }
+}
+
+void RollbackManager::SaveSnapshot(Frame frame)
+{
+    snapshots_[frame % snapshots_.size()].CopyFrom(currentWorld_);
+}
+
+void RollbackManager::RemoveRollbackComponents(core::Entity entity, Frame validateFrame)
+{
+    worldLayout_.RemoveEntity(currentWorld_, entity);
+    //The snapshots that can still be restored would bring back the components of the reused Entity index
+    for (Frame frame = validateFrame; frame <= simulatedFrame_; frame++)
+    {
+        worldLayout_.RemoveEntity(snapshots_[frame % snapshots_.size()], entity);
+    }
+}
+
+void RollbackManager::ReserveEntity(core::Entity entity)
+{
+    auto capacity = currentWorld_.GetCapacity();
+    if (entity < capacity)
+        return;
+    while (entity >= capacity)
+    {
+        capacity *= 2;
+    }
+    currentWorld_.Reserve(capacity);
+    if (worldMode_ == WorldMode::ROLLBACK)
+    {
+        lastValidateWorld_.Reserve(capacity);
+    }
+    for (auto& snapshot : snapshots_)
+    {
+        snapshot.Reserve(capacity);
+    }
+}
 
-    if (entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) &&
-        entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK)))
+void RollbackManager::ReserveWindow(std::size_t frameNmb)
+{
+    auto capacity = GetWindowCapacity();
+    while (capacity < frameNmb)
+    {
+        capacity *= 2;
+    }
+    capacity = std::min(capacity, maxWindowBufferSize);
+    core::LogWarning(fmt::format("Rollback window grows to {} frames, the validated frame {} lags behind the current frame {}",
+        capacity, lastValidateFrame_, currentFrame_));
+    for (auto& inputs : inputs_)
+    {
+        inputs.Reserve(capacity);
+    }
+    if (worldMode_ == WorldMode::VALIDATED)
+        return;
+    //The snapshots of the frames after the validated frame keep their content at their new index
+    std::vector<core::Arena> snapshots;
+    snapshots.reserve(capacity);
+    for (std::size_t i = 0; i < capacity; i++)
+    {
+        snapshots.emplace_back(worldLayout_.layout, currentWorld_.GetCapacity());
+    }
+    for (Frame frame = lastValidateFrame_ + 1; frame <= simulatedFrame_; frame++)
     {
-        const auto& player = currentPlayerManager_.GetComponent(entity1);
-        const auto& attack = currentAttackManager_.GetComponent(entity2);
-        ManageCollisionAttack(player, entity1, attack, entity2);
+        snapshots[frame % capacity] = std::move(snapshots_[frame % snapshots_.size()]);
+    }
+    snapshots_ = std::move(snapshots);
+}
 
+void RollbackManager::StartNewInputFrame(PlayerNumber playerNumber, Frame newFrame)
+{
+    auto& inputs = inputs_[playerNumber];
+    if (inputs.GetCurrentFrame() >= newFrame)
+        return;
+    const std::size_t windowFrameNmb = newFrame - lastValidateFrame_ + 1;
+    if (windowFrameNmb > GetWindowCapacity())
+    {
+        ReserveWindow(windowFrameNmb);
     }
-    if (entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) &&
-        entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK)))
+    inputs.StartNewFrame(newFrame);
+}
+
+const core::Arena& RollbackManager::GetSnapshot(Frame frame) const
+{
+    gpr_assert(simulatedFrame_ - frame < snapshots_.size(),
+        "Trying to get snapshot too far in the past");
+    return snapshots_[frame % snapshots_.size()];
+}
+
+void RollbackManager::OnContacts(const std::vector<Contact>& contacts)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    for (const auto& [entity1, entity2] : contacts)
     {
-        const auto& player = currentPlayerManager_.GetComponent(entity2);
-        const auto& attack = currentAttackManager_.GetComponent(entity1);
-        ManageCollisionAttack(player, entity2, attack, entity1);
+        //A previous contact of the batch might have destroyed one of the entities
+        if (entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::DESTROYED)) ||
+            entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        {
+            continue;
+        }
+        //A previous contact of the batch might have pushed one of the players away,
+        //the boxes are tested again at their current positions like when the contacts were dispatched pair by pair
+        if (!currentPhysicsManager_.IsInContact(entity1, entity2))
+        {
+            continue;
+        }
+        switch (contactHandlers[GetContactCategory(entity1)][GetContactCategory(entity2)])
+        {
+        case ContactHandler::PLAYER_ATTACK:
+            ManageCollisionAttack(entity1, entity2);
+            break;
+        case ContactHandler::ATTACK_PLAYER:
+            ManageCollisionAttack(entity2, entity1);
+            break;
+        case ContactHandler::PLAYER_PLAYER:
+            ManageCollisionPlayer(entity1, entity2);
+            break;
+        default:
+            break;
+        }
     }
+}
+
+std::size_t RollbackManager::GetContactCategory(core::Entity entity) const
+{
+    if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
+        return static_cast<std::size_t>(ContactCategory::PLAYER);
+    if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::PLAYER_ATTACK)))
+        return static_cast<std::size_t>(ContactCategory::ATTACK);
+    return static_cast<std::size_t>(ContactCategory::OTHER);
+}
 
-    if (entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) &&
-        entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
+void RollbackManager::ManageCollisionAttack(core::Entity playerEntity, core::Entity attackEntity)
+{
+    const auto& player = currentPlayerManager_.GetComponent(playerEntity);
+    const auto& attack = currentAttackManager_.GetComponent(attackEntity);
+    if (player.playerNumber != attack.playerNumber && player.playerState != PlayerState::DASH)
     {
-        auto& firstPlayer = currentPlayerManager_.GetComponent(entity1);
-        auto& secondPlayer = currentPlayerManager_.GetComponent(entity2);
-        ManageCollisionPlayer(firstPlayer, entity1, secondPlayer, entity2);
+        gameManager_.DestroyAttackBox(attackEntity);
+        //lower health point
+        auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
+        auto playerBody = currentPhysicsManager_.GetBody(playerEntity);
+        
+    	core::LogDebug(fmt::format("Player {} is hit by attack", playerCharacter.playerNumber));
+        currentPlayerManager_.InitSpawn(playerCharacter, playerBody);
+
+        -- playerCharacter.health;
+        
+        currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
+        currentPhysicsManager_.SetBody(playerEntity, playerBody);
+    }
+}
+
+void RollbackManager::ManageCollisionPlayer(core::Entity firstPlayerEntity, core::Entity secondPlayerEntity)
+{
+    auto& firstPlayer = currentPlayerManager_.GetComponent(firstPlayerEntity);
+    auto& secondPlayer = currentPlayerManager_.GetComponent(secondPlayerEntity);
+    if (firstPlayer.playerState != PlayerState::SPAWN && secondPlayer.playerState != PlayerState::SPAWN) {
+        if (firstPlayer.playerNumber != secondPlayer.playerNumber &&
+            !(firstPlayer.playerState == PlayerState::ATTACK && secondPlayer.playerState == PlayerState::DASH ||
+                firstPlayer.playerState == PlayerState::DASH && secondPlayer.playerState == PlayerState::ATTACK))
+        {
+            auto firstPlayerBody = currentPhysicsManager_.GetBody(firstPlayerEntity);
+            const auto firstPlayerBox = currentPhysicsManager_.GetBox(firstPlayerEntity);
+
+            auto secondPlayerBody = currentPhysicsManager_.GetBody(secondPlayerEntity);
+            const auto secondPlayerBox = currentPhysicsManager_.GetBox(secondPlayerEntity);
+
+            ResolveCollisionBoxToBox(firstPlayerBody, firstPlayerBox, secondPlayerBody, secondPlayerBox);
+
+            currentPhysicsManager_.SetBody(firstPlayerEntity, firstPlayerBody);
+            currentPhysicsManager_.SetBody(secondPlayerEntity, secondPlayerBody);
+
+            if (firstPlayer.playerState == PlayerState::DASH)
+            {
+                PlayerCharacterManager::InitStun(firstPlayer, firstPlayerBody);
+            }
+            if (secondPlayer.playerState == PlayerState::DASH)
+            {
+                PlayerCharacterManager::InitStun(secondPlayer, secondPlayerBody);
+            }
+        }
+        else
+        {
+            PlayerCharacter attackPlayer;
+            core::Entity attackPlayerEntity;
+
+            if (firstPlayer.playerState == PlayerState::ATTACK)
+            {
+                attackPlayer = firstPlayer;
+                attackPlayerEntity = firstPlayerEntity;
+            }
+            else
+            {
+                attackPlayer = secondPlayer;
+                attackPlayerEntity = secondPlayerEntity;
+            }
+
+            auto attackPlayerBody = currentPhysicsManager_.GetBody(attackPlayerEntity);
+            currentPlayerManager_.InitSpawn(attackPlayer,attackPlayerBody);
+
+            --attackPlayer.health;
+
+            currentPlayerManager_.SetComponent(attackPlayerEntity, attackPlayer);
+            currentPhysicsManager_.SetBody(attackPlayerEntity, attackPlayerBody);
+        }
     }
 }
 
 void RollbackManager::SpawnAttack(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position)
 {
-    createdEntities_.push_back({ entity, testedFrame_ });
+    gpr_assert(createdEntities_.empty() || createdEntities_.back().createdFrame <= testedFrame_,
+        "Created entity journal must stay in frame order");
+    //A validated world never goes back, its created entities are kept
+    if (worldMode_ == WorldMode::ROLLBACK)
+    {
+        createdEntities_.push_back({ entity, entityManager_.GetGeneration(entity), testedFrame_ });
+    }
+    ReserveEntity(entity);
 
     Body attackBody;
     attackBody.position = position;
@@ -432,6 +1061,8 @@ void RollbackManager::SpawnAttack(PlayerNumber playerNumber, core::Entity entity
     currentPhysicsManager_.AddBox(entity);
     currentPhysicsManager_.SetBox(entity, attackBox);
 
+    if (worldMode_ == WorldMode::VALIDATED)
+        return;
     currentTransformManager_.AddComponent(entity);
     currentTransformManager_.SetPosition(entity, position);
     currentTransformManager_.SetScale(entity, core::Vec2f::one() * attackScale);
@@ -443,37 +1074,34 @@ void RollbackManager::DestroyEntity(core::Entity entity)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    //we don't need to save a bullet that has been created in the time window
-    if (std::find_if(createdEntities_.begin(), createdEntities_.end(), [entity](auto newEntity)
-        {
-            return newEntity.entity == entity;
-        }) != createdEntities_.end())
-    {
-        entityManager_.DestroyEntity(entity);
+    if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
         return;
-    }
-        entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+    //the entity might come back if we go back before this frame
+    gpr_assert(destroyedEntities_.empty() || destroyedEntities_.back().destroyedFrame <= testedFrame_,
+        "Destroyed entity journal must stay in frame order");
+    destroyedEntities_.push_back({ entity, testedFrame_ });
+    entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
 }
 
 void RollbackManager::ResolveCollisionBoxToBox(Body& firstPlayerBody,const Box& firstPlayerBox,Body& secondPlayerBody,const Box& secondPlayerBox)
 {
-    const float firstPlayerMaxY = firstPlayerBody.position.y + firstPlayerBox.extends.y;
-    const float firstPlayerMinY = firstPlayerBody.position.y - firstPlayerBox.extends.y;
+    const core::Scalar firstPlayerMaxY = firstPlayerBody.position.y + firstPlayerBox.extends.y;
+    const core::Scalar firstPlayerMinY = firstPlayerBody.position.y - firstPlayerBox.extends.y;
 
-    const float secondPlayerMaxY = secondPlayerBody.position.y + secondPlayerBox.extends.y;
-    const float secondPlayerMinY = secondPlayerBody.position.y - secondPlayerBox.extends.y;
+    const core::Scalar secondPlayerMaxY = secondPlayerBody.position.y + secondPlayerBox.extends.y;
+    const core::Scalar secondPlayerMinY = secondPlayerBody.position.y - secondPlayerBox.extends.y;
 
-    const float overlapY = std::min(firstPlayerMaxY - secondPlayerMinY, secondPlayerMaxY - firstPlayerMinY);
+    const core::Scalar overlapY = std::min(firstPlayerMaxY - secondPlayerMinY, secondPlayerMaxY - firstPlayerMinY);
 
-    const float firstPlayerMaxX = firstPlayerBody.position.x + firstPlayerBox.extends.x;
-    const float firstPlayerMinX = firstPlayerBody.position.x - firstPlayerBox.extends.x;
+    const core::Scalar firstPlayerMaxX = firstPlayerBody.position.x + firstPlayerBox.extends.x;
+    const core::Scalar firstPlayerMinX = firstPlayerBody.position.x - firstPlayerBox.extends.x;
 
-    const float secondPlayerMaxX = secondPlayerBody.position.x + secondPlayerBox.extends.x;
-    const float secondPlayerMinX = secondPlayerBody.position.x - secondPlayerBox.extends.x;
+    const core::Scalar secondPlayerMaxX = secondPlayerBody.position.x + secondPlayerBox.extends.x;
+    const core::Scalar secondPlayerMinX = secondPlayerBody.position.x - secondPlayerBox.extends.x;
 
-    const float overlapX = std::min(firstPlayerMaxX - secondPlayerMinX, secondPlayerMaxX - firstPlayerMinX);
+    const core::Scalar overlapX = std::min(firstPlayerMaxX - secondPlayerMinX, secondPlayerMaxX - firstPlayerMinX);
 
-    const float overlap = std::min(overlapY, overlapX);
+    const core::Scalar overlap = std::min(overlapY, overlapX);
 
     if (overlap == overlapY)
     {
@@ -0,0 +1,83 @@
+#include "game/speculative_branch.h"
+
+#include "utils/assert.h"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+
+void SpeculativeBranch::BranchGameManager::CopyPlayers(const GameManager& gameManager)
+{
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        playerEntityMap_[playerNumber] = gameManager.GetEntityFromPlayerNumber(playerNumber);
+    }
+    currentFrame_ = gameManager.GetCurrentFrame();
+}
+
+SpeculativeBranch::SpeculativeBranch() : thread_(&SpeculativeBranch::Run, this)
+{
+}
+
+SpeculativeBranch::~SpeculativeBranch()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        isStopping_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+}
+
+void SpeculativeBranch::Load(RollbackManager& rollbackManager, PlayerNumber playerNumber, Frame startFrame, PlayerInput startInput)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    gpr_assert(!IsRunning(), "Loading a speculative branch while it is simulated");
+    gameManager_.CopyPlayers(rollbackManager.gameManager_);
+    auto& branchRollbackManager = gameManager_.GetMutableRollbackManager();
+    branchRollbackManager.LoadBranch(rollbackManager, playerNumber, startFrame, startInput);
+    createdEntityNmb_ = branchRollbackManager.createdEntities_.size();
+    destroyedEntityNmb_ = branchRollbackManager.destroyedEntities_.size();
+}
+
+void SpeculativeBranch::Start()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        hasJob_ = true;
+        isRunning_.store(true, std::memory_order_release);
+    }
+    condition_.notify_one();
+}
+
+bool SpeculativeBranch::IsAdoptable() const
+{
+    const auto& branchRollbackManager = gameManager_.GetRollbackManager();
+    return branchRollbackManager.createdEntities_.size() == createdEntityNmb_ &&
+        branchRollbackManager.destroyedEntities_.size() == destroyedEntityNmb_;
+}
+
+void SpeculativeBranch::Run()
+{
+    while (true)
+    {
+        std::unique_lock lock(mutex_);
+        condition_.wait(lock, [this] { return hasJob_ || isStopping_; });
+        if (isStopping_)
+        {
+            return;
+        }
+        hasJob_ = false;
+        lock.unlock();
+
+        gameManager_.GetMutableRollbackManager().SimulateBranch();
+        isRunning_.store(false, std::memory_order_release);
+    }
+}
+}
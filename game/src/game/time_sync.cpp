@@ -0,0 +1,33 @@
+#include "game/time_sync.h"
+
+#include <algorithm>
+
+namespace game
+{
+
+void TimeSync::AddSample(Frame currentFrame, Frame remoteFrame, float rtt)
+{
+    const auto remoteFrameEstimate = static_cast<float>(remoteFrame) + rtt / 1000.0f / fixedPeriod;
+    const auto frameAdvantage = static_cast<float>(currentFrame) - remoteFrameEstimate;
+    if (!hasSample_)
+    {
+        frameAdvantage_ = frameAdvantage;
+        hasSample_ = true;
+        return;
+    }
+    frameAdvantage_ += (frameAdvantage - frameAdvantage_) * frameAdvantageSmoothing;
+}
+
+float TimeSync::GetTimeScale() const
+{
+    if (frameAdvantage_ > frameAdvantageDeadZone)
+    {
+        return 1.0f - std::min((frameAdvantage_ - frameAdvantageDeadZone) * timeDilationPerFrame, maxTimeDilation);
+    }
+    if (frameAdvantage_ < -frameAdvantageDeadZone)
+    {
+        return 1.0f + std::min((-frameAdvantage_ - frameAdvantageDeadZone) * timeDilationPerFrame, maxTimeDilation);
+    }
+    return 1.0f;
+}
+}
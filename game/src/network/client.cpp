@@ -1,8 +1,10 @@
 #include "network/client.h"
 
+#include <chrono>
+#include <cmath>
+
 #include "maths/basic.h"
 #include "utils/assert.h"
-#include "utils/conversion.h"
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
@@ -10,146 +12,155 @@
 
 namespace game
 {
-void Client::ReceivePacket(const Packet* packet)
+void Client::ReceivePacket(const Packet& packet)
 {
 
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    const auto packetType = packet->packetType;
-    switch (packetType)
+    if (!gameManager_.IsSimulationThreaded())
     {
-    case PacketType::SPAWN_PLAYER:
+        ApplyPacket(packet);
+        return;
+    }
+    //The render thread never waits for the simulation thread, the packets are applied between two of its updates
+    PushPendingPackets();
+    if (!pendingPackets_.empty() || !gameManager_.PushReceivedPacket(packet))
     {
-        const auto* spawnPlayerPacket = static_cast<const SpawnPlayerPacket*>(packet);
-        const auto clientId = core::ConvertFromBinary<ClientId>(spawnPlayerPacket->clientId);
-
-        const PlayerNumber playerNumber = spawnPlayerPacket->playerNumber;
-        if (clientId == clientId_)
-        {
-            gameManager_.SetClientPlayer(playerNumber);
-        }
+        pendingPackets_.push_back(packet);
+    }
+}
 
-        const auto pos = core::ConvertFromBinary<core::Vec2f>(spawnPlayerPacket->pos);
-        const auto rotation = core::ConvertFromBinary<core::Degree>(spawnPlayerPacket->angle);
+void Client::ApplyPacket(const Packet& packet)
+{
+    std::visit([this](const auto& typedPacket) { ReceiveTypedPacket(typedPacket); }, packet);
+}
 
-        gameManager_.SpawnPlayer(playerNumber, pos);
-        break;
-    }
-    case PacketType::START_GAME:
+void Client::PushPendingPackets()
+{
+    while (!pendingPackets_.empty() && gameManager_.PushReceivedPacket(pendingPackets_.front()))
     {
-        core::LogDebug("Start Game Packet Received");
-        using namespace std::chrono;
-        const auto startingTime = (duration_cast<duration<long long, std::milli>>(
-            system_clock::now().time_since_epoch()
-            ) + milliseconds(startDelay)).count() - milliseconds(static_cast<long long>(currentPing_)).count();
-
-        gameManager_.StartGame(startingTime);
-        break;
+        pendingPackets_.pop_front();
     }
-    case PacketType::INPUT:
+}
+
+void Client::ReceiveTypedPacket(const SpawnPlayerPacket& spawnPlayerPacket)
+{
+    const auto clientId = spawnPlayerPacket.clientId;
+
+    const PlayerNumber playerNumber = spawnPlayerPacket.playerNumber;
+    if (clientId == clientId_)
     {
-        const auto* playerInputPacket = static_cast<const PlayerInputPacket*>(packet);
-        const auto playerNumber = playerInputPacket->playerNumber;
-        const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+        gameManager_.SetClientPlayer(playerNumber);
+    }
 
-        if (playerNumber == gameManager_.GetPlayerNumber())
+    const auto pos = spawnPlayerPacket.pos;
+
+    gameManager_.SpawnPlayer(playerNumber, pos);
+}
+
+void Client::ReceiveTypedPacket([[maybe_unused]] const StartGamePacket& startGamePacket)
+{
+    core::LogDebug("Start Game Packet Received");
+    using namespace std::chrono;
+    const auto startingTime = (duration_cast<duration<long long, std::milli>>(
+        system_clock::now().time_since_epoch()
+        ) + milliseconds(startDelay)).count() - milliseconds(static_cast<long long>(currentPing_)).count();
+
+    gameManager_.StartGame(startingTime);
+}
+
+void Client::ReceiveTypedPacket(const PlayerInputPacket& playerInputPacket)
+{
+    const auto playerNumber = playerInputPacket.playerNumber;
+    const auto inputFrame = playerInputPacket.currentFrame;
+
+    if (playerNumber == gameManager_.GetPlayerNumber())
+    {
+        //Verify the inputs coming back from the server
+        const auto& inputs = gameManager_.GetRollbackManager().GetInputs(playerNumber);
+        for (Frame i = 0; i < playerInputPacket.inputNmb; i++)
         {
-            //Verify the inputs coming back from the server
-            const auto& inputs = gameManager_.GetRollbackManager().GetInputs(playerNumber);
-            const auto currentFrame = gameManager_.GetRollbackManager().GetCurrentFrame();
-            for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+            if (!inputs.Contains(inputFrame - i))
             {
-                const auto index = currentFrame - inputFrame + i;
-                if (index > inputs.size())
-                {
-                    break;
-                }
-                if (inputs[index] != playerInputPacket->inputs[i])
-                {
-                    gpr_assert(false, "Inputs coming back from server are not coherent!!!");
-                }
-                if (inputFrame - i == 0)
-                {
-                    break;
-                }
+                break;
+            }
+            if (inputs.GetInput(inputFrame - i) != playerInputPacket.inputs[i])
+            {
+                gpr_assert(false, "Inputs coming back from server are not coherent!!!");
             }
-            break;
-        }
-
-        //discard delayed input packet
-        if (inputFrame < gameManager_.GetRollbackManager().GetLastReceivedFrame(playerNumber))
-        {
-            break;
-        }
-        for (Frame i = 0; i < playerInputPacket->inputs.size(); i++)
-        {
-            gameManager_.SetPlayerInput(playerNumber,
-                playerInputPacket->inputs[i],
-                inputFrame - i);
-
             if (inputFrame - i == 0)
             {
                 break;
             }
         }
-        break;
+        gameManager_.AcknowledgeInputs(playerInputPacket.ackFrame);
+        return;
     }
-    case PacketType::VALIDATE_STATE:
+
+    //discard delayed input packet
+    if (inputFrame < gameManager_.GetRollbackManager().GetLastReceivedFrame(playerNumber))
     {
-        const auto* validateFramePacket = static_cast<const ValidateFramePacket*>(packet);
-        const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateFramePacket->newValidateFrame);
-        std::array<PhysicsState, maxPlayerNmb> physicsStates{};
-        for (size_t i = 0; i < validateFramePacket->physicsState.size(); i++)
+        return;
+    }
+    gameManager_.SetRemoteInputDelay(playerNumber, playerInputPacket.inputDelay);
+    for (Frame i = 0; i < playerInputPacket.inputNmb; i++)
+    {
+        gameManager_.SetPlayerInput(playerNumber,
+            playerInputPacket.inputs[i],
+            inputFrame - i);
+
+        if (inputFrame - i == 0)
         {
-            auto* statePtr = reinterpret_cast<std::uint8_t*>(physicsStates.data());
-            statePtr[i] = validateFramePacket->physicsState[i];
+            break;
         }
-        gameManager_.ConfirmValidateFrame(newValidateFrame, physicsStates);
-        //logDebug("Client received validate frame " + std::to_string(newValidateFrame));
-        break;
     }
-    case PacketType::WIN_GAME:
+}
+
+void Client::ReceiveTypedPacket(const ValidateFramePacket& validateFramePacket)
+{
+    const auto newValidateFrame = validateFramePacket.newValidateFrame;
+    gameManager_.ConfirmValidateFrame(newValidateFrame, ReadWorldChecksum(validateFramePacket));
+    //logDebug("Client received validate frame " + std::to_string(newValidateFrame));
+}
+
+void Client::ReceiveTypedPacket(const WinGamePacket& winGamePacket)
+{
+    gameManager_.WinGame(winGamePacket.winner);
+}
+
+void Client::ReceiveTypedPacket(const PingPacket& pingPacket)
+{
+    const auto clientId = pingPacket.clientId;
+    if (clientId != clientId_)
     {
-        const auto* winGamePacket = static_cast<const WinGamePacket*>(packet);
-        gameManager_.WinGame(winGamePacket->winner);
-        break;
+        return;
     }
-    case PacketType::PING:
+    const auto originTime = pingPacket.time;
+    using namespace std::chrono;
+    const auto currentTime = static_cast<std::uint64_t>(duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()
+        ).count());
+    const auto delta = currentTime - originTime;
+    const auto ping = static_cast<float>(delta);
+
+    //calculate average and var ping
+    if (srtt_ < 0.0f)
     {
-        const auto* pingPacket = static_cast<const PingPacket*>(packet);
-        const auto clientId = core::ConvertFromBinary<ClientId>(pingPacket->clientId);
-        if (clientId == clientId_)
-        {
-            const auto originTime = core::ConvertFromBinary<unsigned long long>(pingPacket->time);
-            using namespace std::chrono;
-            const auto currentTime = duration_cast<duration<unsigned long long, std::milli>>(
-                system_clock::now().time_since_epoch()
-                ).count();
-            const auto delta = currentTime - originTime;
-            const auto ping = static_cast<float>(delta);
-
-            //calculate average and var ping
-            if (srtt_ < 0.0f)
-            {
-                srtt_ = ping;
-                rttvar_ = ping / 2.0f;
-            }
-            else
-            {
-                srtt_ = (1.0f - alpha) * srtt_ + alpha * ping;
-                rttvar_ = (1.0f - beta) * rttvar_ + beta * core::Abs(srtt_ - ping);
-            }
-
-            rto_ = srtt_ + std::max(g, k * rttvar_);
-            currentPing_ = srtt_;
-        }
-
+        srtt_ = ping;
+        rttvar_ = ping / 2.0f;
     }
-    case PacketType::SPAWN_BULLET: break;
-    default:;
+    else
+    {
+        srtt_ = (1.0f - alpha) * srtt_ + alpha * ping;
+        rttvar_ = (1.0f - beta) * rttvar_ + beta * core::Abs(srtt_ - ping);
     }
 
+    rto_ = srtt_ + std::max(g, k * rttvar_);
+    currentPing_ = srtt_;
+    gameManager_.SetRoundTripTime(srtt_);
+    //The inputs are resent until acknowledged, at most two retransmission timeouts of them in a packet
+    gameManager_.SetInputRedundancy(static_cast<Frame>(std::ceil(2.0f * rto_ / (fixedPeriod * 1000.0f))));
 }
 
 void Client::Update(sf::Time dt)
@@ -158,17 +169,18 @@ void Client::Update(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    PushPendingPackets();
     pingTimer_ -= dt.asSeconds();
     if (pingTimer_ < 0.0f)
     {
         if (clientId_ != INVALID_CLIENT_ID)
         {
             using namespace std::chrono;
-            auto pingPacket = std::make_unique<PingPacket>();
-            pingPacket->time = core::ConvertToBinary(duration_cast<duration<unsigned long long, std::milli>>(
+            PingPacket pingPacket;
+            pingPacket.time = static_cast<std::uint64_t>(duration_cast<milliseconds>(
                 system_clock::now().time_since_epoch()).count());
-            pingPacket->clientId = core::ConvertToBinary(clientId_);
-            SendUnreliablePacket(std::move(pingPacket));
+            pingPacket.clientId = clientId_;
+            SendUnreliablePacket(pingPacket);
         }
         pingTimer_ = pingPeriod_;
     }
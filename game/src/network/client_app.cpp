@@ -18,6 +18,10 @@ void ClientApp::Begin()
     windowSize_ = core::windowSize;
     client_.SetWindowSize(windowSize_);
     client_.Begin();
+    if constexpr (useSimulationThread)
+    {
+        client_.StartSimulationThread([] { return GetPlayerInput(0); });
+    }
 }
 
 void ClientApp::Update(sf::Time dt)
@@ -26,7 +30,10 @@ void ClientApp::Update(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    client_.SetPlayerInput(GetPlayerInput(0));
+    if (!client_.IsSimulationThreaded())
+    {
+        client_.SetPlayerInput(GetPlayerInput(0));
+    }
     client_.Update(dt);
 }
 
@@ -3,7 +3,6 @@
 #ifdef ENABLE_SQLITE
 
 #include "utils/log.h"
-#include "utils/conversion.h"
 
 
 #include <sqlite3.h>
@@ -52,8 +51,11 @@ void DebugDatabase::StorePacket(const PlayerInputPacket* inputPacket)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    //A relayed packet can only acknowledge the inputs, without any input
+    if (inputPacket->inputNmb == 0)
+        return;
     const PlayerNumber playerNumber = inputPacket->playerNumber;
-    const auto frame = core::ConvertFromBinary<Frame>(inputPacket->currentFrame);
+    const auto frame = inputPacket->currentFrame;
     const PlayerInput input = inputPacket->inputs[0];
 
     auto query = fmt::format("INSERT INTO inputs (player_number, frame, up, down, left, right, shoot) VALUES({}, {}, {}, {}, {}, {},  {});",
@@ -79,15 +81,11 @@ void DebugDatabase::StorePhysicsState(const DbPhysicsState& physicsState)
     ZoneScoped;
 #endif
 
-    std::string query = "INSERT INTO physics_state (local_frame, validate_frame ";
-    std::string arguments;
-    std::string values = fmt::format(" VALUES ({}, {}", physicsState.lastLocalValidateFrame, physicsState.validateFrame);
-    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-    {
-        arguments += fmt::format(",state_p{}_local, state_p{}_server ", playerNumber + 1, playerNumber + 1);
-        values += fmt::format(",{},{}", physicsState.localStates[playerNumber], physicsState.serverStates[playerNumber]);
-    }
-    query += arguments + ") " + values + " );";
+    //SQLite integers are signed 64-bit
+    const std::string query = fmt::format(
+        "INSERT INTO physics_state (local_frame, validate_frame, checksum_local, checksum_server) VALUES ({}, {}, {}, {});",
+        physicsState.lastLocalValidateFrame, physicsState.validateFrame,
+        static_cast<std::int64_t>(physicsState.localChecksum), static_cast<std::int64_t>(physicsState.serverChecksum));
     {
         std::lock_guard lock(m_);
         commands_.push_back(query);
@@ -171,13 +169,9 @@ void DebugDatabase::CreateTables() const
     std::string createPhysicsStateTable = "CREATE TABLE physics_state ("\
         "phys_id INTEGER PRIMARY KEY,"\
         "local_frame INTEGER NOT NULL,"\
-        "validate_frame INTEGER NOT NULL"\
-        ;
-    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-    {
-        createPhysicsStateTable += fmt::format(",state_p{}_local INTEGER NOT NULL, state_p{}_server INTEGER NOT NULL", playerNumber + 1, playerNumber + 1);
-    }
-    createPhysicsStateTable += ");";
+        "validate_frame INTEGER NOT NULL,"\
+        "checksum_local INTEGER NOT NULL,"\
+        "checksum_server INTEGER NOT NULL);";
     zErrMsg = nullptr;
     const auto rc2 = sqlite3_exec(db, createPhysicsStateTable.data(), callback, nullptr, &zErrMsg);
     if (rc2 != SQLITE_OK) {
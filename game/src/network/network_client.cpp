@@ -4,7 +4,6 @@
 #include <network/network_client.h>
 
 #include "maths/basic.h"
-#include "utils/conversion.h"
 #include "utils/log.h"
 
 #ifdef TRACY_ENABLE
@@ -49,12 +48,12 @@ void NetworkClient::Update(sf::Time dt)
         //Receive TCP Packet
         while (status == sf::Socket::Done)
         {
-            sf::Packet packet;
-            status = tcpSocket_.receive(packet);
+            status = tcpSocket_.receive(tcpReceivePacket_);
             switch (status)
             {
             case sf::Socket::Done:
-                ReceiveNetPacket(packet, PacketSource::TCP);
+                ReceiveNetPacket({ static_cast<const std::uint8_t*>(tcpReceivePacket_.getData()), tcpReceivePacket_.getDataSize() },
+                    PacketSource::TCP);
                 break;
             case sf::Socket::NotReady:
                 //core::LogDebug("[Client] Error while receiving tcp socket is not ready");
@@ -71,14 +70,14 @@ void NetworkClient::Update(sf::Time dt)
         status = sf::Socket::Done;
         while (status == sf::Socket::Done)
         {
-            sf::Packet packet;
             sf::IpAddress sender;
             unsigned short port;
-            status = udpSocket_.receive(packet, sender, port);
+            std::size_t receivedSize = 0;
+            status = udpSocket_.receive(receiveBuffer_.data(), receiveBuffer_.size(), receivedSize, sender, port);
             switch (status)
             {
             case sf::Socket::Done:
-                ReceiveNetPacket(packet, PacketSource::UDP);
+                ReceiveNetPacket({ receiveBuffer_.data(), receivedSize }, PacketSource::UDP);
                 break;
             case sf::Socket::NotReady: break;
             case sf::Socket::Partial:
@@ -100,9 +99,9 @@ void NetworkClient::Update(sf::Time dt)
             if (serverUdpPort_ != 0)
             {
                 //Need to send a join packet on the unreliable channel
-                auto joinPacket = std::make_unique<JoinPacket>();
-                joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
-                SendUnreliablePacket(std::move(joinPacket));
+                JoinPacket joinPacket;
+                joinPacket.clientId = clientId_;
+                SendUnreliablePacket(joinPacket);
             }
             break;
         }
@@ -153,12 +152,12 @@ void NetworkClient::DrawImGui()
         if (status == sf::Socket::Done)
         {
             core::LogDebug("[Client] Connect to server " + serverAddress_ + " with port: " + std::to_string(serverTcpPort_));
-            auto joinPacket = std::make_unique<JoinPacket>();
-            joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
+            JoinPacket joinPacket;
+            joinPacket.clientId = clientId_;
             using namespace std::chrono;
-            const unsigned long clientTime = static_cast<unsigned long>((duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count());
-            joinPacket->startTime = core::ConvertToBinary<unsigned long>(clientTime);
-            SendReliablePacket(std::move(joinPacket));
+            const auto clientTime = static_cast<std::uint64_t>((duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count());
+            joinPacket.startTime = clientTime;
+            SendReliablePacket(joinPacket);
             currentState_ = State::JOINING;
         }
         else
@@ -180,29 +179,32 @@ void NetworkClient::Draw(sf::RenderTarget& renderTarget)
     gameManager_.Draw(renderTarget);
 }
 
-void NetworkClient::SendReliablePacket(std::unique_ptr<Packet> packet)
+void NetworkClient::SendReliablePacket(const Packet& packet)
 {
 
     //core::LogDebug("[Client] Sending reliable packet to server");
-    sf::Packet tcpPacket;
-    GeneratePacket(tcpPacket, *packet);
+    PacketBuffer buffer;
+    const auto packetSize = WritePacket(buffer, packet);
+    tcpSendPacket_.clear();
+    tcpSendPacket_.append(buffer.data(), packetSize);
     auto status = sf::Socket::Partial;
     while (status == sf::Socket::Partial)
     {
-        status = tcpSocket_.send(tcpPacket);
+        status = tcpSocket_.send(tcpSendPacket_);
     }
 }
 
-void NetworkClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
+void NetworkClient::SendUnreliablePacket(const Packet& packet)
 {
 
     if (currentState_ == State::NONE)
     {
         return;
     }
-    sf::Packet udpPacket;
-    GeneratePacket(udpPacket, *packet);
-    const auto status = udpSocket_.send(udpPacket, serverAddress_, serverUdpPort_);
+    //The inputs are sent by the simulation thread and the pings by the main thread, each send writes on its own stack buffer
+    PacketBuffer buffer;
+    const auto packetSize = WritePacket(buffer, packet);
+    const auto status = udpSocket_.send(buffer.data(), packetSize, serverAddress_, serverUdpPort_);
     switch (status)
     {
     case sf::Socket::Done:
@@ -228,6 +230,9 @@ void NetworkClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
 
 void NetworkClient::SetPlayerInput(PlayerInput playerInput)
 {
+    //The simulation thread samples the local input itself
+    if (gameManager_.IsSimulationThreaded())
+        return;
     const auto currentFrame = gameManager_.GetCurrentFrame();
     gameManager_.SetPlayerInput(
         gameManager_.GetPlayerNumber(),
@@ -235,83 +240,60 @@ void NetworkClient::SetPlayerInput(PlayerInput playerInput)
         currentFrame);
 }
 
-void NetworkClient::ReceivePacket(const Packet* packet)
+void NetworkClient::ApplyPacket(const Packet& packet)
 {
-    Client::ReceivePacket(packet);
+    Client::ApplyPacket(packet);
 #ifdef ENABLE_SQLITE
-    switch (packet->packetType)
-    {
-    case PacketType::JOIN: break;
-    case PacketType::SPAWN_PLAYER: break;
-    case PacketType::INPUT:
+    if (const auto* inputPacket = std::get_if<PlayerInputPacket>(&packet))
     {
-        auto* inputPacket = static_cast<const PlayerInputPacket*>(packet);
         debugDb_.StorePacket(inputPacket);
-        break;
     }
-    case PacketType::SPAWN_BULLET: break;
-    case PacketType::VALIDATE_STATE:
+    else if (const auto* validateStatePacket = std::get_if<ValidateFramePacket>(&packet))
     {
-        auto* validateStatePacket = static_cast<const ValidateFramePacket*>(packet);
-        const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateStatePacket->newValidateFrame);
+        const auto newValidateFrame = validateStatePacket->newValidateFrame;
         DbPhysicsState state{};
         state.validateFrame = newValidateFrame;
         state.lastLocalValidateFrame = gameManager_.GetLastValidateFrame();
-        for (size_t i = 0; i < validateStatePacket->physicsState.size(); i++)
-        {
-            auto* statePtr = reinterpret_cast<std::uint8_t*>(state.serverStates.data());
-            statePtr[i] = validateStatePacket->physicsState[i];
-        }
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-        {
-            state.localStates[playerNumber] = gameManager_.GetRollbackManager().GetValidatePhysicsState(playerNumber);
-        }
+        state.serverChecksum = ReadWorldChecksum(*validateStatePacket).value;
+        state.localChecksum = gameManager_.GetRollbackManager().GetValidateChecksum().value;
         debugDb_.StorePhysicsState(state);
-        break;
-    }
-    case PacketType::START_GAME: break;
-    case PacketType::JOIN_ACK: break;
-    case PacketType::WIN_GAME: break;
-    case PacketType::PING: break;
-    case PacketType::NONE: break;
-    default:;
     }
 #endif
 }
 
-void NetworkClient::ReceiveNetPacket(sf::Packet& packet, PacketSource source)
+void NetworkClient::ReceiveNetPacket(std::span<const std::uint8_t> data, PacketSource source)
 {
-    const auto receivePacket = GenerateReceivedPacket(packet);
-    Client::ReceivePacket(receivePacket.get());
-    switch (receivePacket->packetType)
+    const auto receivePacket = ReadPacket(data);
+    if (!receivePacket.has_value())
     {
-    case PacketType::JOIN_ACK:
+        core::LogDebug("[Client] Error while reading " + std::string(source == PacketSource::UDP ? "UDP" : "TCP") + " packet");
+        return;
+    }
+    Client::ReceivePacket(receivePacket.value());
+    const auto* joinAckPacket = std::get_if<JoinAckPacket>(&receivePacket.value());
+    if (joinAckPacket == nullptr)
     {
-        core::LogDebug("[Client] Receive " + std::string(source == PacketSource::UDP ? "UDP" : "TCP") + " Join ACK Packet");
-        auto* joinAckPacket = static_cast<JoinAckPacket*>(receivePacket.get());
+        return;
+    }
+    core::LogDebug("[Client] Receive " + std::string(source == PacketSource::UDP ? "UDP" : "TCP") + " Join ACK Packet");
 
-        serverUdpPort_ = core::ConvertFromBinary<unsigned short>(joinAckPacket->udpPort);
-        const auto clientId = core::ConvertFromBinary<ClientId>(joinAckPacket->clientId);
-        if (clientId != clientId_)
-            return;
-        if (source == PacketSource::TCP)
+    serverUdpPort_ = joinAckPacket->udpPort;
+    const auto clientId = joinAckPacket->clientId;
+    if (clientId != clientId_)
+        return;
+    if (source == PacketSource::TCP)
+    {
+        //Need to send a join packet on the unreliable channel
+        JoinPacket joinPacket;
+        joinPacket.clientId = clientId_;
+        SendUnreliablePacket(joinPacket);
+    }
+    else
+    {
+        if (currentState_ == State::JOINING)
         {
-            //Need to send a join packet on the unreliable channel
-            auto joinPacket = std::make_unique<JoinPacket>();
-            joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
-            SendUnreliablePacket(std::move(joinPacket));
+            currentState_ = State::JOINED;
         }
-        else
-        {
-            if (currentState_ == State::JOINING)
-            {
-                currentState_ = State::JOINED;
-            }
-        }
-        break;
-    }
-    default:
-        break;
     }
 }
 }
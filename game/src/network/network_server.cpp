@@ -1,6 +1,5 @@
 #include <network/network_server.h>
 #include "utils/log.h"
-#include "utils/conversion.h"
 #include "utils/assert.h"
 
 #include <fmt/format.h>
@@ -13,20 +12,21 @@
 namespace game
 {
 void NetworkServer::SendReliablePacket(
-    std::unique_ptr<Packet> packet)
+    const Packet& packet)
 {
     core::LogDebug(fmt::format("[Server] Sending TCP packet: {}",
-        std::to_string(static_cast<int>(packet->packetType))));
+        std::to_string(static_cast<int>(GetPacketType(packet)))));
+    //The packet is written once for all the clients, sf::Packet only adds the TCP length framing
+    const auto packetSize = WritePacket(sendBuffer_, packet);
+    tcpSendPacket_.clear();
+    tcpSendPacket_.append(sendBuffer_.data(), packetSize);
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb;
         playerNumber++)
     {
-        sf::Packet sendingPacket;
-        GeneratePacket(sendingPacket, *packet);
-
         auto status = sf::Socket::Partial;
         while (status == sf::Socket::Partial)
         {
-            status = tcpSockets_[playerNumber].send(sendingPacket);
+            status = tcpSockets_[playerNumber].send(tcpSendPacket_);
             switch (status)
             {
             case sf::Socket::NotReady:
@@ -44,8 +44,9 @@ void NetworkServer::SendReliablePacket(
 }
 
 void NetworkServer::SendUnreliablePacket(
-    std::unique_ptr<Packet> packet)
+    const Packet& packet)
 {
+    const auto packetSize = WritePacket(sendBuffer_, packet);
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb;
         playerNumber++)
     {
@@ -55,15 +56,13 @@ void NetworkServer::SendUnreliablePacket(
             continue;
         }
 
-        sf::Packet sendingPacket;
-        GeneratePacket(sendingPacket, *packet);
-        const auto status = udpSocket_.send(sendingPacket, clientInfoMap_[playerNumber].udpRemoteAddress,
+        const auto status = udpSocket_.send(sendBuffer_.data(), packetSize, clientInfoMap_[playerNumber].udpRemoteAddress,
             clientInfoMap_[playerNumber].udpRemotePort);
         switch (status)
         {
         case sf::Socket::Done:
             //core::LogDebug("[Server] Sending UDP packet: " +
-                //std::to_string(static_cast<int>(packet->packetType)));
+                //std::to_string(static_cast<int>(GetPacketType(packet))));
             break;
 
         case sf::Socket::Disconnected:
@@ -125,7 +124,7 @@ void NetworkServer::Begin()
 
 }
 
-void NetworkServer::Update([[maybe_unused]] sf::Time dt)
+void NetworkServer::Update(sf::Time dt)
 {
 
 #ifdef TRACY_ENABLE
@@ -149,12 +148,12 @@ void NetworkServer::Update([[maybe_unused]] sf::Time dt)
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb;
         playerNumber++)
     {
-        sf::Packet tcpPacket;
         switch (tcpSockets_[playerNumber].receive(
-            tcpPacket))
+            tcpReceivePacket_))
         {
         case sf::Socket::Done:
-            ReceiveNetPacket(tcpPacket, PacketSocketSource::TCP);
+            ReceiveNetPacket({ static_cast<const std::uint8_t*>(tcpReceivePacket_.getData()), tcpReceivePacket_.getDataSize() },
+                PacketSocketSource::TCP);
             break;
         case sf::Socket::Disconnected:
         {
@@ -162,22 +161,22 @@ void NetworkServer::Update([[maybe_unused]] sf::Time dt)
                 "[Error] Player Number {} is disconnected when receiving",
                 playerNumber + 1));
             status_ = status_ & ~(FIRST_PLAYER_CONNECT << playerNumber);
-            auto endGame = std::make_unique<WinGamePacket>();
-            SendReliablePacket(std::move(endGame));
+            SendReliablePacket(WinGamePacket{});
             status_ = status_ & ~OPEN; //Close the server
             break;
         }
         default: break;
         }
     }
-    sf::Packet udpPacket;
+    //All the datagrams received since the last update are applied before the tick validation
     sf::IpAddress address;
     unsigned short port;
-    const auto status = udpSocket_.receive(udpPacket, address, port);
-    if (status == sf::Socket::Done)
+    std::size_t receivedSize = 0;
+    while (udpSocket_.receive(receiveBuffer_.data(), receiveBuffer_.size(), receivedSize, address, port) == sf::Socket::Done)
     {
-        ReceiveNetPacket(udpPacket, PacketSocketSource::UDP, address, port);
+        ReceiveNetPacket({ receiveBuffer_.data(), receivedSize }, PacketSocketSource::UDP, address, port);
     }
+    UpdateTick(dt);
 }
 
 void NetworkServer::End()
@@ -201,89 +200,81 @@ void NetworkServer::SpawnNewPlayer([[maybe_unused]] ClientId clientId, [[maybe_u
     //Spawning the new player in the arena
     for (PlayerNumber p = 0; p <= lastPlayerNumber_; p++)
     {
-        auto spawnPlayer = std::make_unique<SpawnPlayerPacket>();
-        spawnPlayer->clientId = core::ConvertToBinary(clientMap_[p]);
-        spawnPlayer->playerNumber = p;
+        SpawnPlayerPacket spawnPlayer;
+        spawnPlayer.clientId = clientMap_[p];
+        spawnPlayer.playerNumber = p;
 
         const auto pos = spawnPositions[p] * 3.0f;
-        spawnPlayer->pos = ConvertToBinary(pos);
+        spawnPlayer.pos = pos;
 
         const auto rotation = spawnRotations[p];
-        spawnPlayer->angle = core::ConvertToBinary(rotation);
+        spawnPlayer.angle = rotation;
         gameManager_.SpawnPlayer(p, pos);
 
-        SendReliablePacket(std::move(spawnPlayer));
+        SendReliablePacket(spawnPlayer);
     }
 }
 
 
 void NetworkServer::ProcessReceivePacket(
-    std::unique_ptr<Packet> packet,
+    const Packet& packet,
     PacketSocketSource packetSource,
     sf::IpAddress address,
     unsigned short port)
 {
-
-    const auto packetType = static_cast<PacketType>(packet->packetType);
-    switch (packetType)
+    Server::ReceivePacket(packet);
+    const auto* joinPacket = std::get_if<JoinPacket>(&packet);
+    if (joinPacket == nullptr)
     {
-    case PacketType::JOIN:
+        return;
+    }
+    auto clientId = joinPacket->clientId;
+    core::LogDebug(fmt::format("[Server] Received Join Packet from: {} {}", static_cast<unsigned>(clientId),
+        (packetSource == PacketSocketSource::UDP ? fmt::format(" UDP with port: {}", port) : " TCP")));
+    const auto it = std::find(clientMap_.begin(), clientMap_.end(), clientId);
+    PlayerNumber playerNumber;
+    if (it != clientMap_.end())
     {
-        const auto joinPacket = *static_cast<JoinPacket*>(packet.get());
-        Server::ReceivePacket(std::move(packet));
-        auto clientId = core::ConvertFromBinary<ClientId>(joinPacket.clientId);
-        core::LogDebug(fmt::format("[Server] Received Join Packet from: {} {}", static_cast<unsigned>(clientId),
-            (packetSource == PacketSocketSource::UDP ? fmt::format(" UDP with port: {}", port) : " TCP")));
-        const auto it = std::find(clientMap_.begin(), clientMap_.end(), clientId);
-        PlayerNumber playerNumber;
-        if (it != clientMap_.end())
-        {
-            playerNumber = static_cast<PlayerNumber>(std::distance(clientMap_.begin(), it));
-            clientInfoMap_[playerNumber].clientId = clientId;
-        }
-        else
-        {
-            gpr_assert(false, "Player Number is supposed to be already set before join!");
-        }
+        playerNumber = static_cast<PlayerNumber>(std::distance(clientMap_.begin(), it));
+        clientInfoMap_[playerNumber].clientId = clientId;
+    }
+    else
+    {
+        gpr_assert(false, "Player Number is supposed to be already set before join!");
+    }
 
-        auto joinAckPacket = std::make_unique<JoinAckPacket>();
-        joinAckPacket->clientId = core::ConvertToBinary(clientId);
-        joinAckPacket->udpPort = core::ConvertToBinary(udpPort_);
-        if (packetSource == PacketSocketSource::UDP)
-        {
-            auto& clientInfo = clientInfoMap_[playerNumber];
-            clientInfo.udpRemoteAddress = address;
-            clientInfo.udpRemotePort = port;
-            SendUnreliablePacket(std::move(joinAckPacket));
-        }
-        else
-        {
-            SendReliablePacket(std::move(joinAckPacket));
-            //Calculate time difference
-            const auto clientTime = core::ConvertFromBinary<unsigned long>(joinPacket.startTime);
-            using namespace std::chrono;
-            const unsigned long deltaTime = static_cast<unsigned long>((duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count())) - clientTime;
-            core::LogDebug(fmt::format("[Server] Client Server deltaTime: {}", deltaTime));
-            clientInfoMap_[playerNumber].timeDifference = deltaTime;
-        }
-        break;
+    JoinAckPacket joinAckPacket;
+    joinAckPacket.clientId = clientId;
+    joinAckPacket.udpPort = udpPort_;
+    if (packetSource == PacketSocketSource::UDP)
+    {
+        auto& clientInfo = clientInfoMap_[playerNumber];
+        clientInfo.udpRemoteAddress = address;
+        clientInfo.udpRemotePort = port;
+        SendUnreliablePacket(joinAckPacket);
     }
-    default:
-        Server::ReceivePacket(std::move(packet));
-        break;
+    else
+    {
+        SendReliablePacket(joinAckPacket);
+        //Calculate time difference
+        const auto clientTime = joinPacket->startTime;
+        using namespace std::chrono;
+        const auto deltaTime = static_cast<std::uint64_t>((duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count())) - clientTime;
+        core::LogDebug(fmt::format("[Server] Client Server deltaTime: {}", deltaTime));
+        clientInfoMap_[playerNumber].timeDifference = deltaTime;
     }
 }
 
-void NetworkServer::ReceiveNetPacket(sf::Packet& packet,
+void NetworkServer::ReceiveNetPacket(std::span<const std::uint8_t> data,
     PacketSocketSource packetSource,
     sf::IpAddress address,
     unsigned short port)
 {
-    auto receivedPacket = GenerateReceivedPacket(packet);
+    const auto receivedPacket = ReadPacket(data);
 
-    if (receivedPacket != nullptr)
+    if (receivedPacket.has_value())
     {
-        ProcessReceivePacket(std::move(receivedPacket), packetSource, address, port);
+        ProcessReceivePacket(receivedPacket.value(), packetSource, address, port);
     }
 }
 }
@@ -1,7 +1,7 @@
 #include <network/server.h>
 #include <utils/log.h>
 #include <fmt/format.h>
-#include <utils/conversion.h>
+#include <cmath>
 #include <cstdint>
 
 #ifdef TRACY_ENABLE
@@ -11,112 +11,174 @@
 namespace game
 {
 
-void Server::ReceivePacket(std::unique_ptr<Packet> packet)
+void Server::ReceivePacket(const Packet& packet)
 {
 
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    switch (packet->packetType)
+    std::visit([this](const auto& typedPacket) { ReceiveTypedPacket(typedPacket); }, packet);
+}
+
+void Server::ReceiveTypedPacket(const JoinPacket& joinPacket)
+{
+    const auto clientId = joinPacket.clientId;
+    if (std::any_of(clientMap_.begin(), clientMap_.end(), [clientId](const auto clientMapId)
+        {
+            return clientMapId == clientId;
+        }))
+    {
+        //Player joined twice!
+        return;
+    }
+    core::LogDebug("Managing Received Packet Join from: " + std::to_string(static_cast<unsigned>(clientId)));
+    clientMap_[lastPlayerNumber_] = clientId;
+    SpawnNewPlayer(clientId, lastPlayerNumber_);
+
+    lastPlayerNumber_++;
+
+    if (lastPlayerNumber_ == maxPlayerNmb)
     {
-    case PacketType::JOIN:
+        core::LogDebug("Send Start Game Packet");
+        SendReliablePacket(StartGamePacket{});
+    }
+}
+
+void Server::ReceiveTypedPacket(const PlayerInputPacket& playerInputPacket)
+{
+    //Manage internal state
+    const auto playerNumber = playerInputPacket.playerNumber;
+    const auto inputFrame = playerInputPacket.currentFrame;
+    if (playerNumber >= maxPlayerNmb)
     {
-        const auto* joinPacket = static_cast<const JoinPacket*>(packet.get());
-        const auto clientId = core::ConvertFromBinary<ClientId>(joinPacket->clientId);
-        if (std::any_of(clientMap_.begin(), clientMap_.end(), [clientId](const auto clientMapId)
-            {
-                return clientMapId == clientId;
-            }))
+        return;
+    }
+
+    for (std::uint32_t i = 0; i < playerInputPacket.inputNmb; i++)
+    {
+        gameManager_.SetPlayerInput(playerNumber,
+            playerInputPacket.inputs[i],
+            inputFrame - i);
+        if (inputFrame - i == 0)
         {
-            //Player joined twice!
-            return;
+            break;
         }
-            core::LogDebug("Managing Received Packet Join from: " + std::to_string(static_cast<unsigned>(clientId)));
-            clientMap_[lastPlayerNumber_] = clientId;
-            SpawnNewPlayer(clientId, lastPlayerNumber_);
+    }
+    remoteAckFrames_[playerNumber] = std::max(remoteAckFrames_[playerNumber], playerInputPacket.ackFrame);
+    inputDelays_[playerNumber] = playerInputPacket.inputDelay;
 
-            lastPlayerNumber_++;
+    //The inputs are relayed right away, but only validated on the next tick
+    RelayInputs(playerNumber);
+}
 
-            if (lastPlayerNumber_ == maxPlayerNmb)
-            {
-                auto startGamePacket = std::make_unique<StartGamePacket>();
-                startGamePacket->packetType = PacketType::START_GAME;
-                core::LogDebug("Send Start Game Packet");
-                SendReliablePacket(std::move(startGamePacket));
-            }
+void Server::RelayInputs(PlayerNumber playerNumber)
+{
+    const auto& rollbackManager = gameManager_.GetRollbackManager();
+    const auto& inputs = rollbackManager.GetInputs(playerNumber);
+    //After a missing frame, the server only has predicted inputs to relay
+    const auto lastContiguousFrame = rollbackManager.GetLastContiguousFrame(playerNumber);
+    auto relayAckFrame = lastContiguousFrame;
+    for (PlayerNumber otherPlayerNumber = 0; otherPlayerNumber < maxPlayerNmb; otherPlayerNumber++)
+    {
+        if (otherPlayerNumber == playerNumber)
+            continue;
+        relayAckFrame = std::min(relayAckFrame, remoteAckFrames_[otherPlayerNumber]);
+    }
 
+    PlayerInputPacket relayPacket;
+    relayPacket.playerNumber = playerNumber;
+    //The relay always starts after the acknowledged frame, the frames after maxInputNmb wait for the next relays
+    relayPacket.currentFrame = std::min<Frame>(lastContiguousFrame, relayAckFrame + maxInputNmb);
+    relayPacket.ackFrame = lastContiguousFrame;
+    relayPacket.inputDelay = inputDelays_[playerNumber];
+    for (Frame frame = relayPacket.currentFrame; frame > relayAckFrame; frame--)
+    {
+        if (!inputs.Contains(frame))
+        {
             break;
+        }
+        relayPacket.inputs[relayPacket.inputNmb] = inputs.GetInput(frame);
+        relayPacket.inputNmb++;
     }
-    case PacketType::INPUT:
-    {
-        //Manage internal state
-        const auto* playerInputPacket = static_cast<const PlayerInputPacket*>(packet.get());
-        const auto playerNumber = playerInputPacket->playerNumber;
-        const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+    SendUnreliablePacket(relayPacket);
+}
+
+void Server::ReceiveTypedPacket(const PingPacket& pingPacket)
+{
+    SendUnreliablePacket(pingPacket);
+}
+
+void Server::UpdateTick(sf::Time dt)
+{
+    tickTime_ += dt.asSeconds();
+    if (tickTime_ < serverTickPeriod)
+        return;
+    //One validation covers all the frames received since the last tick, a late tick is not caught up
+    tickTime_ = std::fmod(tickTime_, serverTickPeriod);
+    ValidateReceivedFrames();
+}
+
+void Server::ValidateReceivedFrames()
+{
 
-        for (std::uint32_t i = 0; i < playerInputPacket->inputs.size(); i++)
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //Validate new frame if needed, the frames after a missing input cannot be validated
+    std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastContiguousFrame(0);
+    for (PlayerNumber i = 1; i < maxPlayerNmb; i++)
+    {
+        const auto playerLastFrame = gameManager_.GetRollbackManager().GetLastContiguousFrame(i);
+        if (playerLastFrame < lastReceiveFrame)
         {
-            gameManager_.SetPlayerInput(playerNumber,
-                playerInputPacket->inputs[i],
-                inputFrame - i);
-            if (inputFrame - i == 0)
-            {
-                break;
-            }
+            lastReceiveFrame = playerLastFrame;
         }
+    }
+    if (lastReceiveFrame > gameManager_.GetLastValidateFrame())
+    {
+        //Validate frame
+        gameManager_.Validate(lastReceiveFrame);
 
-        SendUnreliablePacket(std::move(packet));
+        ValidateFramePacket validatePacket;
+        validatePacket.newValidateFrame = lastReceiveFrame;
 
-        //Validate new frame if needed
-        std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(0);
-        for (PlayerNumber i = 1; i < maxPlayerNmb; i++)
+        //copy world checksum
+        auto worldChecksum = gameManager_.GetRollbackManager().GetValidateChecksum();
+        if (!sendComponentChecksums)
         {
-            const auto playerLastFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(i);
-            if (playerLastFrame < lastReceiveFrame)
-            {
-                lastReceiveFrame = playerLastFrame;
-            }
+            worldChecksum.components.reset();
         }
-        if (lastReceiveFrame > gameManager_.GetLastValidateFrame())
+        WriteWorldChecksum(validatePacket, worldChecksum);
+        SendUnreliablePacket(validatePacket);
+        const auto winner = gameManager_.CheckWinner();
+        if (winner != INVALID_PLAYER)
         {
-            //Validate frame
-            gameManager_.Validate(lastReceiveFrame);
-
-            auto validatePacket = std::make_unique<ValidateFramePacket>();
-            validatePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
-
-            //copy physics state
-            for (PlayerNumber i = 0; i < maxPlayerNmb; i++)
-            {
-                auto physicsState = gameManager_.GetRollbackManager().GetValidatePhysicsState(i);
-                const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
-                for (size_t j = 0; j < sizeof(PhysicsState); j++)
-                {
-                    validatePacket->physicsState[i * sizeof(PhysicsState) + j] = statePtr[j];
-                }
-            }
-            SendUnreliablePacket(std::move(validatePacket));
-            const auto winner = gameManager_.CheckWinner();
-            if (winner != INVALID_PLAYER)
-            {
-                core::LogDebug(fmt::format("Server declares P{} a winner", static_cast<unsigned>(winner) + 1));
-                auto winGamePacket = std::make_unique<WinGamePacket>();
-                winGamePacket->winner = winner;
-                SendReliablePacket(std::move(winGamePacket));
-                gameManager_.WinGame(winner);
-            }
+            core::LogDebug(fmt::format("Server declares P{} a winner", static_cast<unsigned>(winner) + 1));
+            WinGamePacket winGamePacket;
+            winGamePacket.winner = winner;
+            SendReliablePacket(winGamePacket);
+            gameManager_.WinGame(winner);
         }
-
-        break;
     }
-    case PacketType::PING:
+    CheckStalledPlayers();
+}
+
+void Server::CheckStalledPlayers()
+{
+    if (hasStalledPlayer_)
+        return;
+    const auto& rollbackManager = gameManager_.GetRollbackManager();
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
-        auto pingPacket = std::make_unique<PingPacket>();
-        *pingPacket = *static_cast<PingPacket*>(packet.get());
-        SendUnreliablePacket(std::move(pingPacket));
-        break;
-    }
-    default: break;
+        //The inputs of the other players after the window end are rejected
+        if (rollbackManager.GetLastContiguousFrame(playerNumber) < rollbackManager.GetWindowEndFrame())
+            continue;
+        core::LogWarning(fmt::format("[Server] No frame validated since frame {}, a player is stalled and treated as disconnected",
+            rollbackManager.GetLastValidateFrame()));
+        hasStalledPlayer_ = true;
+        SendReliablePacket(WinGamePacket{});
+        gameManager_.WinGame(INVALID_PLAYER);
+        return;
     }
 }
 }
@@ -3,7 +3,6 @@
 #include <imgui.h>
 #include <network/simulation_server.h>
 
-#include "utils/conversion.h"
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
@@ -80,13 +79,9 @@ void SimulationClient::DrawImGui()
     ImGui::Begin(windowName.c_str());
     if (gameManager_.GetPlayerNumber() == INVALID_PLAYER && ImGui::Button("Spawn Player"))
     {
-        auto joinPacket = std::make_unique<JoinPacket>();
-        const auto* clientIdPtr = reinterpret_cast<std::uint8_t*>(&clientId_);
-        for (std::size_t i = 0; i < sizeof(clientId_); i++)
-        {
-            joinPacket->clientId[i] = clientIdPtr[i];
-        }
-        SendReliablePacket(std::move(joinPacket));
+        JoinPacket joinPacket;
+        joinPacket.clientId = clientId_;
+        SendReliablePacket(joinPacket);
     }
     gameManager_.DrawImGui();
     if (srtt_ > 0.0f)
@@ -98,56 +93,33 @@ void SimulationClient::DrawImGui()
     ImGui::End();
 }
 
-void SimulationClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
+void SimulationClient::SendUnreliablePacket(const Packet& packet)
 {
-    server_.PutPacketInReceiveQueue(std::move(packet),true);
+    server_.PutPacketInReceiveQueue(packet,true);
 }
 
-void SimulationClient::SendReliablePacket(std::unique_ptr<Packet> packet)
+void SimulationClient::SendReliablePacket(const Packet& packet)
 {
-    server_.PutPacketInReceiveQueue(std::move(packet),false);
+    server_.PutPacketInReceiveQueue(packet,false);
 }
 
-void SimulationClient::ReceivePacket(const Packet* packet)
+void SimulationClient::ApplyPacket(const Packet& packet)
 {
-    Client::ReceivePacket(packet);
+    Client::ApplyPacket(packet);
 #ifdef ENABLE_SQLITE
-    switch (packet->packetType)
+    if (const auto* inputPacket = std::get_if<PlayerInputPacket>(&packet))
     {
-    case PacketType::JOIN: break;
-    case PacketType::SPAWN_PLAYER: break;
-    case PacketType::INPUT:
-    {
-        auto* inputPacket = static_cast<const PlayerInputPacket*>(packet);
         debugDb_.StorePacket(inputPacket);
-        break;
     }
-    case PacketType::SPAWN_BULLET: break;
-    case PacketType::VALIDATE_STATE:
+    else if (const auto* validateStatePacket = std::get_if<ValidateFramePacket>(&packet))
     {
-        auto* validateStatePacket = static_cast<const ValidateFramePacket*>(packet);
-        const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateStatePacket->newValidateFrame);
+        const auto newValidateFrame = validateStatePacket->newValidateFrame;
         DbPhysicsState state{};
         state.validateFrame = newValidateFrame;
         state.lastLocalValidateFrame = gameManager_.GetLastValidateFrame();
-        for (size_t i = 0; i < validateStatePacket->physicsState.size(); i++)
-        {
-            auto* statePtr = reinterpret_cast<std::uint8_t*>(state.serverStates.data());
-            statePtr[i] = validateStatePacket->physicsState[i];
-        }
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-        {
-            state.localStates[playerNumber] = gameManager_.GetRollbackManager().GetValidatePhysicsState(playerNumber);
-        }
+        state.serverChecksum = ReadWorldChecksum(*validateStatePacket).value;
+        state.localChecksum = gameManager_.GetRollbackManager().GetValidateChecksum().value;
         debugDb_.StorePhysicsState(state);
-        break;
-    }
-    case PacketType::START_GAME: break;
-    case PacketType::JOIN_ACK: break;
-    case PacketType::WIN_GAME: break;
-    case PacketType::PING: break;
-    case PacketType::NONE: break;
-    default:;
     }
 #endif
 }
@@ -2,7 +2,6 @@
 #include <network/simulation_client.h>
 #include <imgui.h>
 #include <maths/basic.h>
-#include <utils/conversion.h>
 #include <utils/log.h>
 
 #ifdef TRACY_ENABLE
@@ -32,7 +31,7 @@ void SimulationServer::Update(sf::Time dt)
         packetIt->currentTime -= dt.asSeconds();
         if (packetIt->currentTime <= 0.0f)
         {
-            ProcessReceivePacket(std::move(packetIt->packet));
+            ProcessReceivePacket(packetIt->packet);
 
             packetIt = receivedPackets_.erase(packetIt);
         }
@@ -42,6 +41,7 @@ void SimulationServer::Update(sf::Time dt)
         }
 
     }
+    UpdateTick(dt);
 
     packetIt = sentPackets_.begin();
     while (packetIt != sentPackets_.end())
@@ -51,9 +51,8 @@ void SimulationServer::Update(sf::Time dt)
         {
             for (auto& client : clients_)
             {
-                client->ReceivePacket(packetIt->packet.get());
+                client->ReceivePacket(packetIt->packet);
             }
-            packetIt->packet = nullptr;
             packetIt = sentPackets_.erase(packetIt);
         }
         else
@@ -84,12 +83,12 @@ void SimulationServer::DrawImGui()
     ImGui::End();
 }
 
-void SimulationServer::PutPacketInSendingQueue(std::unique_ptr<Packet> packet)
+void SimulationServer::PutPacketInSendingQueue(const Packet& packet)
 {
-    sentPackets_.push_back({ avgDelay_ + core::RandomRange(-marginDelay_, marginDelay_), std::move(packet) });
+    sentPackets_.push_back({ avgDelay_ + core::RandomRange(-marginDelay_, marginDelay_), packet });
 }
 
-void SimulationServer::PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, bool unreliable)
+void SimulationServer::PutPacketInReceiveQueue(const Packet& packet, bool unreliable)
 {
     if(unreliable)
     {
@@ -99,37 +98,36 @@ void SimulationServer::PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, b
             return;
         }
     }
-    receivedPackets_.push_back({ avgDelay_ + core::RandomRange(-marginDelay_, marginDelay_), std::move(packet) });
+    receivedPackets_.push_back({ avgDelay_ + core::RandomRange(-marginDelay_, marginDelay_), packet });
 }
 
-void SimulationServer::SendReliablePacket(std::unique_ptr<Packet> packet)
+void SimulationServer::SendReliablePacket(const Packet& packet)
 {
-    PutPacketInSendingQueue(std::move(packet));
+    PutPacketInSendingQueue(packet);
 }
 
-void SimulationServer::SendUnreliablePacket(std::unique_ptr<Packet> packet)
+void SimulationServer::SendUnreliablePacket(const Packet& packet)
 {
-    PutPacketInSendingQueue(std::move(packet));
+    PutPacketInSendingQueue(packet);
 }
 
-void SimulationServer::ProcessReceivePacket(std::unique_ptr<Packet> packet)
+void SimulationServer::ProcessReceivePacket(const Packet& packet)
 {
-    Server::ReceivePacket(std::move(packet));
+    Server::ReceivePacket(packet);
 }
 
 void SimulationServer::SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber)
 {
     core::LogDebug("[Server] Spawn new player");
-    auto spawnPlayer = std::make_unique<SpawnPlayerPacket>();
-    spawnPlayer->packetType = PacketType::SPAWN_PLAYER;
-    spawnPlayer->clientId = core::ConvertToBinary(clientId);
-    spawnPlayer->playerNumber = playerNumber;
+    SpawnPlayerPacket spawnPlayer;
+    spawnPlayer.clientId = clientId;
+    spawnPlayer.playerNumber = playerNumber;
 
     const auto pos = spawnPositions[playerNumber] * 3.0f;
-    spawnPlayer->pos = ConvertToBinary(pos);
+    spawnPlayer.pos = pos;
     const auto rotation = spawnRotations[playerNumber];
-    spawnPlayer->angle = core::ConvertToBinary(rotation);
+    spawnPlayer.angle = rotation;
     gameManager_.SpawnPlayer(playerNumber, pos);
-    SendReliablePacket(std::move(spawnPlayer));
+    SendReliablePacket(spawnPlayer);
 }
 }
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include "game/rollback_manager.h"
+
+namespace
+{
+void AddBody(const game::WorldArenaLayout& worldLayout, core::Arena& arena, core::Entity entity, core::Vec2f position)
+{
+    const auto& bodies = worldLayout.physics.bodies;
+    const auto index = bodies.sparseSet.Insert(arena, entity);
+    arena.Get<core::Vec2f>(bodies.positions)[index] = position;
+    arena.Get<core::Vec2f>(bodies.velocities)[index] = {};
+    arena.Get<core::Degree>(bodies.angularVelocities)[index] = core::Degree(0.0f);
+    arena.Get<core::Degree>(bodies.rotations)[index] = core::Degree(0.0f);
+    arena.Get<game::BodyType>(bodies.bodyTypes)[index] = game::BodyType::DYNAMIC;
+    arena.Get<std::uint8_t>(bodies.affectedByGravity)[index] = 1u;
+}
+
+void AddBox(const game::WorldArenaLayout& worldLayout, core::Arena& arena, core::Entity entity, core::Vec2f extends)
+{
+    const auto& boxes = worldLayout.physics.boxes;
+    arena.Get<game::Box>(boxes.components)[boxes.sparseSet.Insert(arena, entity)] = { extends, false };
+}
+
+void AddPlayer(const game::WorldArenaLayout& worldLayout, core::Arena& arena, core::Entity entity,
+    game::PlayerNumber playerNumber, core::Vec2f position, core::Vec2f extends)
+{
+    game::PlayerCharacter playerCharacter;
+    playerCharacter.playerNumber = playerNumber;
+    const auto& players = worldLayout.playerCharacters;
+    arena.Get<game::PlayerCharacter>(players.components)[players.sparseSet.Insert(arena, entity)] = playerCharacter;
+    AddBody(worldLayout, arena, entity, position);
+    AddBox(worldLayout, arena, entity, extends);
+}
+
+void AddAttack(const game::WorldArenaLayout& worldLayout, core::Arena& arena, core::Entity entity,
+    game::PlayerNumber playerNumber, core::Vec2f position)
+{
+    const auto& attacks = worldLayout.attacks;
+    arena.Get<game::Attack>(attacks.components)[attacks.sparseSet.Insert(arena, entity)] = { 1.0f, playerNumber };
+    AddBody(worldLayout, arena, entity, position);
+    AddBox(worldLayout, arena, entity, core::Vec2f::one());
+}
+}
+
+TEST(Checksum, SwappedPlayerBodies)
+{
+    const game::WorldArenaLayout worldLayout;
+    core::Arena world(worldLayout.layout, 8);
+    core::Arena swappedWorld(worldLayout.layout, 8);
+    AddPlayer(worldLayout, world, 1, 0, { -1.0f, 0.0f }, core::Vec2f::one());
+    AddPlayer(worldLayout, world, 2, 1, { 1.0f, 0.0f }, core::Vec2f::one());
+    AddPlayer(worldLayout, swappedWorld, 1, 0, { 1.0f, 0.0f }, core::Vec2f::one());
+    AddPlayer(worldLayout, swappedWorld, 2, 1, { -1.0f, 0.0f }, core::Vec2f::one());
+
+    const auto checksum = worldLayout.ComputeChecksum(world);
+    const auto swappedChecksum = worldLayout.ComputeChecksum(swappedWorld);
+    EXPECT_NE(checksum.value, swappedChecksum.value);
+    ASSERT_TRUE(checksum.components.has_value());
+    ASSERT_TRUE(swappedChecksum.components.has_value());
+    EXPECT_NE((*checksum.components)[static_cast<std::size_t>(game::ChecksumComponent::BODY)],
+        (*swappedChecksum.components)[static_cast<std::size_t>(game::ChecksumComponent::BODY)]);
+    EXPECT_EQ((*checksum.components)[static_cast<std::size_t>(game::ChecksumComponent::BOX)],
+        (*swappedChecksum.components)[static_cast<std::size_t>(game::ChecksumComponent::BOX)]);
+}
+
+TEST(Checksum, SwappedPlayerBoxes)
+{
+    const game::WorldArenaLayout worldLayout;
+    core::Arena world(worldLayout.layout, 8);
+    core::Arena swappedWorld(worldLayout.layout, 8);
+    AddPlayer(worldLayout, world, 1, 0, { -1.0f, 0.0f }, { 1.0f, 2.0f });
+    AddPlayer(worldLayout, world, 2, 1, { 1.0f, 0.0f }, { 2.0f, 1.0f });
+    AddPlayer(worldLayout, swappedWorld, 1, 0, { -1.0f, 0.0f }, { 2.0f, 1.0f });
+    AddPlayer(worldLayout, swappedWorld, 2, 1, { 1.0f, 0.0f }, { 1.0f, 2.0f });
+
+    EXPECT_NE(worldLayout.ComputeChecksum(world).value, worldLayout.ComputeChecksum(swappedWorld).value);
+}
+
+TEST(Checksum, PlayerEntities)
+{
+    const game::WorldArenaLayout worldLayout;
+    core::Arena world(worldLayout.layout, 8);
+    core::Arena otherWorld(worldLayout.layout, 8);
+    AddPlayer(worldLayout, world, 1, 0, { -1.0f, 0.0f }, core::Vec2f::one());
+    AddPlayer(worldLayout, world, 2, 1, { 1.0f, 0.0f }, core::Vec2f::one());
+    //The same players with other entities
+    AddPlayer(worldLayout, otherWorld, 3, 1, { 1.0f, 0.0f }, core::Vec2f::one());
+    AddPlayer(worldLayout, otherWorld, 4, 0, { -1.0f, 0.0f }, core::Vec2f::one());
+
+    EXPECT_EQ(worldLayout.ComputeChecksum(world).value, worldLayout.ComputeChecksum(otherWorld).value);
+}
+
+TEST(Checksum, AttackEntities)
+{
+    const game::WorldArenaLayout worldLayout;
+    core::Arena world(worldLayout.layout, 8);
+    core::Arena otherWorld(worldLayout.layout, 8);
+    AddPlayer(worldLayout, world, 1, 0, { -1.0f, 0.0f }, core::Vec2f::one());
+    AddAttack(worldLayout, world, 3, 0, { 0.0f, 1.0f });
+    AddAttack(worldLayout, world, 4, 0, { 0.0f, 2.0f });
+    //A client can create the same attacks in another order and with other entities than the server
+    AddPlayer(worldLayout, otherWorld, 1, 0, { -1.0f, 0.0f }, core::Vec2f::one());
+    AddAttack(worldLayout, otherWorld, 5, 0, { 0.0f, 2.0f });
+    AddAttack(worldLayout, otherWorld, 7, 0, { 0.0f, 1.0f });
+
+    EXPECT_EQ(worldLayout.ComputeChecksum(world).value, worldLayout.ComputeChecksum(otherWorld).value);
+}
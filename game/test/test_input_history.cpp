@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "game/input_history.h"
+
+namespace
+{
+game::PlayerInput GetTestInput(game::Frame frame)
+{
+    return static_cast<game::PlayerInput>((frame * 7u + 3u) & game::playerInputMask);
+}
+}
+
+TEST(InputHistory, PackingAcrossWords)
+{
+    //64 bits hold 12 inputs of 5 bits, the 3 words of the buffer are all used
+    constexpr std::size_t capacity = 30;
+    game::InputHistory inputHistory(capacity);
+    inputHistory.StartNewFrame(capacity - 1);
+    for (game::Frame frame = 0; frame < capacity; frame++)
+    {
+        inputHistory.SetInput(frame, GetTestInput(frame));
+    }
+    for (game::Frame frame = 0; frame < capacity; frame++)
+    {
+        EXPECT_EQ(inputHistory.GetInput(frame), GetTestInput(frame)) << "frame " << frame;
+    }
+
+    //Writing the last input of a word and the first one of the next word leaves their neighbours untouched
+    inputHistory.SetInput(11, game::playerInputMask);
+    inputHistory.SetInput(12, game::playerInputMask);
+    EXPECT_EQ(inputHistory.GetInput(10), GetTestInput(10));
+    EXPECT_EQ(inputHistory.GetInput(11), game::playerInputMask);
+    EXPECT_EQ(inputHistory.GetInput(12), game::playerInputMask);
+    EXPECT_EQ(inputHistory.GetInput(13), GetTestInput(13));
+    inputHistory.SetInput(11, game::PlayerInputEnum::NONE);
+    EXPECT_EQ(inputHistory.GetInput(11), game::PlayerInputEnum::NONE);
+    EXPECT_EQ(inputHistory.GetInput(12), game::playerInputMask);
+
+    //The received bits do not change the inputs
+    inputHistory.SetReceived(12);
+    EXPECT_TRUE(inputHistory.IsReceived(12));
+    EXPECT_FALSE(inputHistory.IsReceived(11));
+    EXPECT_FALSE(inputHistory.IsReceived(13));
+    EXPECT_EQ(inputHistory.GetInput(12), game::playerInputMask);
+}
+
+TEST(InputHistory, WrapAround)
+{
+    constexpr std::size_t capacity = 16;
+    game::InputHistory inputHistory(capacity);
+    for (game::Frame frame = 1; frame <= 40; frame++)
+    {
+        inputHistory.StartNewFrame(frame);
+        inputHistory.SetInput(frame, GetTestInput(frame));
+        if (frame % 2 == 0)
+        {
+            inputHistory.SetReceived(frame);
+        }
+    }
+    EXPECT_EQ(inputHistory.GetCurrentFrame(), 40u);
+    EXPECT_FALSE(inputHistory.Contains(24));
+    EXPECT_FALSE(inputHistory.Contains(41));
+    for (game::Frame frame = 25; frame <= 40; frame++)
+    {
+        ASSERT_TRUE(inputHistory.Contains(frame));
+        EXPECT_EQ(inputHistory.GetInput(frame), GetTestInput(frame)) << "frame " << frame;
+        EXPECT_EQ(inputHistory.IsReceived(frame), frame % 2 == 0) << "frame " << frame;
+    }
+
+    //The new frame reuses the slot of the oldest frame, it repeats the current input and is not received
+    inputHistory.SetReceived(40);
+    inputHistory.StartNewFrame(41);
+    EXPECT_FALSE(inputHistory.Contains(25));
+    EXPECT_EQ(inputHistory.GetInput(41), GetTestInput(40));
+    EXPECT_FALSE(inputHistory.IsReceived(41));
+    EXPECT_EQ(inputHistory.GetInput(26), GetTestInput(26));
+}
+
+TEST(InputHistory, StartNewFrameJumpLargerThanCapacity)
+{
+    constexpr std::size_t capacity = 16;
+    game::InputHistory inputHistory(capacity);
+    for (game::Frame frame = 1; frame <= 5; frame++)
+    {
+        inputHistory.StartNewFrame(frame);
+        inputHistory.SetInput(frame, GetTestInput(frame));
+        inputHistory.SetReceived(frame);
+    }
+    inputHistory.StartNewFrame(100);
+    EXPECT_EQ(inputHistory.GetCurrentFrame(), 100u);
+    EXPECT_FALSE(inputHistory.Contains(5));
+    EXPECT_FALSE(inputHistory.Contains(84));
+    //All the slots are overwritten once by the repeated input of the previous current frame
+    for (game::Frame frame = 85; frame <= 100; frame++)
+    {
+        ASSERT_TRUE(inputHistory.Contains(frame));
+        EXPECT_EQ(inputHistory.GetInput(frame), GetTestInput(5)) << "frame " << frame;
+        EXPECT_FALSE(inputHistory.IsReceived(frame)) << "frame " << frame;
+    }
+    //A frame that is not after the current frame changes nothing
+    inputHistory.StartNewFrame(90);
+    EXPECT_EQ(inputHistory.GetCurrentFrame(), 100u);
+}
+
+TEST(InputHistory, ReserveKeepsLastFrames)
+{
+    constexpr std::size_t capacity = 16;
+    game::InputHistory inputHistory(capacity);
+    for (game::Frame frame = 1; frame <= 30; frame++)
+    {
+        inputHistory.StartNewFrame(frame);
+        inputHistory.SetInput(frame, GetTestInput(frame));
+        if (frame % 3 == 0)
+        {
+            inputHistory.SetReceived(frame);
+        }
+    }
+    inputHistory.Reserve(40);
+    EXPECT_EQ(inputHistory.GetCapacity(), 40u);
+    EXPECT_EQ(inputHistory.GetCurrentFrame(), 30u);
+    //The frames stored before growing keep their input and received bit at their new slot
+    for (game::Frame frame = 15; frame <= 30; frame++)
+    {
+        ASSERT_TRUE(inputHistory.Contains(frame));
+        EXPECT_EQ(inputHistory.GetInput(frame), GetTestInput(frame)) << "frame " << frame;
+        EXPECT_EQ(inputHistory.IsReceived(frame), frame % 3 == 0) << "frame " << frame;
+    }
+    //A smaller capacity does not shrink the buffer
+    inputHistory.Reserve(20);
+    EXPECT_EQ(inputHistory.GetCapacity(), 40u);
+
+    //The new frames wrap around the grown buffer without overwriting the kept frames
+    for (game::Frame frame = 31; frame <= 54; frame++)
+    {
+        inputHistory.StartNewFrame(frame);
+        inputHistory.SetInput(frame, GetTestInput(frame));
+    }
+    EXPECT_FALSE(inputHistory.Contains(14));
+    for (game::Frame frame = 15; frame <= 54; frame++)
+    {
+        EXPECT_EQ(inputHistory.GetInput(frame), GetTestInput(frame)) << "frame " << frame;
+    }
+}
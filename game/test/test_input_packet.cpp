@@ -0,0 +1,147 @@
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "network/packet_type.h"
+
+namespace
+{
+/**
+ * \brief inputHeaderSize is the number of bytes of a written PlayerInputPacket before its input runs.
+ */
+constexpr std::size_t inputHeaderSize = sizeof(game::PacketType) + sizeof(game::PlayerNumber) + sizeof(game::Frame) + 3;
+
+game::PlayerInputPacket CreateInputPacket(const std::vector<game::PlayerInput>& inputs)
+{
+    game::PlayerInputPacket playerInputPacket;
+    playerInputPacket.playerNumber = 1;
+    playerInputPacket.currentFrame = 100;
+    playerInputPacket.ackFrame = 90;
+    playerInputPacket.inputDelay = 3;
+    playerInputPacket.inputNmb = static_cast<std::uint8_t>(inputs.size());
+    std::copy(inputs.begin(), inputs.end(), playerInputPacket.inputs.begin());
+    return playerInputPacket;
+}
+
+std::optional<game::PlayerInputPacket> RoundTrip(const game::PlayerInputPacket& playerInputPacket, std::size_t& size)
+{
+    game::PacketBuffer buffer{};
+    size = game::WritePacket(buffer, playerInputPacket);
+    const auto packet = game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), size));
+    if (!packet.has_value())
+    {
+        return std::nullopt;
+    }
+    const auto* readPacket = std::get_if<game::PlayerInputPacket>(&*packet);
+    if (readPacket == nullptr)
+    {
+        return std::nullopt;
+    }
+    return *readPacket;
+}
+
+void ExpectSameInputs(const game::PlayerInputPacket& playerInputPacket, const game::PlayerInputPacket& expectedPacket)
+{
+    EXPECT_EQ(playerInputPacket.playerNumber, expectedPacket.playerNumber);
+    EXPECT_EQ(playerInputPacket.currentFrame, expectedPacket.currentFrame);
+    EXPECT_EQ(playerInputPacket.ackFrame, expectedPacket.ackFrame);
+    EXPECT_EQ(playerInputPacket.inputDelay, expectedPacket.inputDelay);
+    ASSERT_EQ(playerInputPacket.inputNmb, expectedPacket.inputNmb);
+    for (std::size_t i = 0; i < expectedPacket.inputNmb; i++)
+    {
+        EXPECT_EQ(playerInputPacket.inputs[i], expectedPacket.inputs[i]) << "input " << i;
+    }
+}
+}
+
+TEST(InputPacket, RunLengthRoundTrip)
+{
+    using namespace game::PlayerInputEnum;
+    //Runs of exactly the maximum length, one longer, single inputs and a full packet
+    const std::vector<std::vector<game::PlayerInput>> inputSequences{
+        std::vector<game::PlayerInput>(game::maxInputRunLength, UP),
+        std::vector<game::PlayerInput>(game::maxInputRunLength + 1, LEFT | ATTACK),
+        { UP, DOWN, UP, DOWN, NONE, NONE, RIGHT },
+        std::vector<game::PlayerInput>(game::maxInputNmb, RIGHT),
+    };
+    for (const auto& inputs : inputSequences)
+    {
+        const auto playerInputPacket = CreateInputPacket(inputs);
+        std::size_t size = 0;
+        const auto readPacket = RoundTrip(playerInputPacket, size);
+        ASSERT_TRUE(readPacket.has_value());
+        ExpectSameInputs(*readPacket, playerInputPacket);
+    }
+}
+
+TEST(InputPacket, RunLengthSize)
+{
+    std::size_t size = 0;
+    //A run holds at most maxInputRunLength inputs in one byte
+    ASSERT_TRUE(RoundTrip(CreateInputPacket(std::vector<game::PlayerInput>(game::maxInputRunLength, 1u)), size).has_value());
+    EXPECT_EQ(size, inputHeaderSize + 1);
+    ASSERT_TRUE(RoundTrip(CreateInputPacket(std::vector<game::PlayerInput>(game::maxInputRunLength + 1, 1u)), size).has_value());
+    EXPECT_EQ(size, inputHeaderSize + 2);
+    ASSERT_TRUE(RoundTrip(CreateInputPacket({ 1u, 2u, 1u }), size).has_value());
+    EXPECT_EQ(size, inputHeaderSize + 3);
+}
+
+TEST(InputPacket, NoInput)
+{
+    const auto playerInputPacket = CreateInputPacket({});
+    std::size_t size = 0;
+    const auto readPacket = RoundTrip(playerInputPacket, size);
+    ASSERT_TRUE(readPacket.has_value());
+    EXPECT_EQ(size, inputHeaderSize);
+    ExpectSameInputs(*readPacket, playerInputPacket);
+}
+
+TEST(InputPacket, AckFrame)
+{
+    auto playerInputPacket = CreateInputPacket({ 1u });
+    std::size_t size = 0;
+    //An ack after the current frame is sent as the current frame
+    playerInputPacket.ackFrame = playerInputPacket.currentFrame + 5;
+    auto readPacket = RoundTrip(playerInputPacket, size);
+    ASSERT_TRUE(readPacket.has_value());
+    EXPECT_EQ(readPacket->ackFrame, playerInputPacket.currentFrame);
+    //An ack too old for its distance is not sent
+    playerInputPacket.currentFrame = 1000;
+    playerInputPacket.ackFrame = 10;
+    readPacket = RoundTrip(playerInputPacket, size);
+    ASSERT_TRUE(readPacket.has_value());
+    EXPECT_EQ(readPacket->ackFrame, 0u);
+}
+
+TEST(InputPacket, Truncated)
+{
+    game::PacketBuffer buffer{};
+    const auto size = game::WritePacket(buffer, CreateInputPacket({ 1u, 1u, 2u, 3u, 3u, 3u }));
+    for (std::size_t truncatedSize = 0; truncatedSize < size; truncatedSize++)
+    {
+        EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), truncatedSize)).has_value()) << truncatedSize;
+    }
+    EXPECT_TRUE(game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), size)).has_value());
+}
+
+TEST(InputPacket, InconsistentRuns)
+{
+    game::PacketBuffer buffer{};
+    const auto size = game::WritePacket(buffer, CreateInputPacket({ 1u, 1u, 2u }));
+    ASSERT_EQ(size, inputHeaderSize + 2);
+    //A run longer than the remaining inputs
+    auto corruptedBuffer = buffer;
+    corruptedBuffer[inputHeaderSize + 1] = static_cast<std::uint8_t>(2u | 1u << game::playerInputBitNmb);
+    EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(corruptedBuffer.data(), size)).has_value());
+    //More inputs than a packet can hold
+    corruptedBuffer = buffer;
+    corruptedBuffer[inputHeaderSize - 1] = static_cast<std::uint8_t>(game::maxInputNmb + 1);
+    EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(corruptedBuffer.data(), size)).has_value());
+    //More inputs than the written runs
+    corruptedBuffer = buffer;
+    corruptedBuffer[inputHeaderSize - 1] = 4u;
+    EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(corruptedBuffer.data(), size)).has_value());
+    //An input delay larger than a client can set
+    corruptedBuffer = buffer;
+    corruptedBuffer[inputHeaderSize - 2] = static_cast<std::uint8_t>(game::maxInputDelay + 1);
+    EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(corruptedBuffer.data(), size)).has_value());
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "game/input_predictor.h"
+
+namespace
+{
+constexpr game::PlayerInput none = game::PlayerInputEnum::NONE;
+constexpr game::PlayerInput right = game::PlayerInputEnum::RIGHT;
+constexpr game::PlayerInput attack = game::PlayerInputEnum::ATTACK;
+
+/**
+ * \brief CreateInputHistory creates the received history of the inputs, from frame 0 to the last given input.
+ */
+game::InputHistory CreateInputHistory(const std::vector<game::PlayerInput>& playerInputs, std::size_t capacity = game::windowBufferSize)
+{
+    game::InputHistory inputHistory(capacity);
+    for (game::Frame frame = 0; frame < playerInputs.size(); frame++)
+    {
+        inputHistory.StartNewFrame(frame);
+        inputHistory.SetInput(frame, playerInputs[frame]);
+        inputHistory.SetReceived(frame);
+    }
+    return inputHistory;
+}
+
+std::vector<game::PlayerInput> CreateHold(game::PlayerInput playerInput, game::Frame frameNmb)
+{
+    return std::vector<game::PlayerInput>(frameNmb, playerInput);
+}
+}
+
+TEST(ButtonHoldInputPredictor, DoubleTapDash)
+{
+    //A tap of 3 frames, released for 2 frames, and the second tap of the dash pressed for 2 frames
+    const auto inputs = CreateInputHistory({ none, right, right, right, none, none, right, right });
+    const game::Frame lastReceivedFrame = 7;
+    game::ButtonHoldInputPredictor predictor;
+    //The second tap is predicted as long as the first one, then released
+    EXPECT_EQ(predictor.Predict(inputs, lastReceivedFrame, 8), right);
+    EXPECT_EQ(predictor.Predict(inputs, lastReceivedFrame, 9), none);
+    EXPECT_EQ(predictor.Predict(inputs, lastReceivedFrame, 20), none);
+}
+
+TEST(ButtonHoldInputPredictor, DoubleTapKeepsOtherButtons)
+{
+    const auto inputs = CreateInputHistory({ right | attack, attack, right | attack, right | attack });
+    const game::Frame lastReceivedFrame = 3;
+    game::ButtonHoldInputPredictor predictor;
+    EXPECT_EQ(predictor.Predict(inputs, lastReceivedFrame, 4), attack);
+}
+
+TEST(ButtonHoldInputPredictor, LongHold)
+{
+    game::ButtonHoldInputPredictor predictor;
+    //A held button stays pressed
+    {
+        const auto inputs = CreateInputHistory(CreateHold(right, 40));
+        EXPECT_EQ(predictor.Predict(inputs, 39, 40), right);
+        EXPECT_EQ(predictor.Predict(inputs, 39, 100), right);
+    }
+    //A long previous press is not the first tap of a dash
+    {
+        auto playerInputs = CreateHold(right, 30);
+        playerInputs.push_back(none);
+        playerInputs.push_back(right);
+        const auto inputs = CreateInputHistory(playerInputs);
+        const auto lastReceivedFrame = static_cast<game::Frame>(playerInputs.size() - 1);
+        EXPECT_EQ(predictor.Predict(inputs, lastReceivedFrame, lastReceivedFrame + 10), right);
+    }
+    //The current press is already longer than a tap
+    {
+        auto playerInputs = std::vector<game::PlayerInput>{ right, none };
+        const auto hold = CreateHold(right, 20);
+        playerInputs.insert(playerInputs.end(), hold.begin(), hold.end());
+        const auto inputs = CreateInputHistory(playerInputs);
+        const auto lastReceivedFrame = static_cast<game::Frame>(playerInputs.size() - 1);
+        EXPECT_EQ(predictor.Predict(inputs, lastReceivedFrame, lastReceivedFrame + 10), right);
+    }
+    //A released button stays released
+    {
+        auto playerInputs = CreateHold(right, 20);
+        playerInputs.push_back(none);
+        const auto inputs = CreateInputHistory(playerInputs);
+        EXPECT_EQ(predictor.Predict(inputs, 20, 30), none);
+    }
+}
+
+TEST(ButtonHoldInputPredictor, FirstFrames)
+{
+    game::ButtonHoldInputPredictor predictor;
+    //Nothing before frame 0 is counted as a tap
+    {
+        const auto inputs = CreateInputHistory({ right });
+        EXPECT_EQ(predictor.Predict(inputs, 0, 1), right);
+        EXPECT_EQ(predictor.Predict(inputs, 0, 50), right);
+    }
+    {
+        const auto inputs = CreateInputHistory({ none, right });
+        EXPECT_EQ(predictor.Predict(inputs, 1, 50), right);
+    }
+    //The first tap starts on frame 0
+    {
+        const auto inputs = CreateInputHistory({ right, right, none, right });
+        EXPECT_EQ(predictor.Predict(inputs, 3, 4), right);
+        EXPECT_EQ(predictor.Predict(inputs, 3, 5), none);
+    }
+}
+
+TEST(ButtonHoldInputPredictor, LastReceivedFrameNotStored)
+{
+    constexpr std::size_t capacity = 16;
+    const auto inputs = CreateInputHistory(CreateHold(right, 40), capacity);
+    game::ButtonHoldInputPredictor predictor;
+    //Overwritten by the newer frames
+    EXPECT_EQ(predictor.Predict(inputs, 10, 41), none);
+    //After the current frame of the history
+    EXPECT_EQ(predictor.Predict(inputs, 45, 46), none);
+    //The oldest stored frame is still predicted
+    EXPECT_EQ(predictor.Predict(inputs, 40 - capacity, 41), right);
+}
+
+TEST(FrequencyInputPredictor, DoubleTapDash)
+{
+    game::FrequencyInputPredictor predictor(8u);
+    //Pressed on 5 of the last 8 frames
+    const auto inputs = CreateInputHistory({ none, right, right, right, none, none, right, right });
+    EXPECT_EQ(predictor.Predict(inputs, 7, 8), right);
+    //Released on 5 of the last 8 frames
+    const auto releasedInputs = CreateInputHistory({ none, none, right, none, none, right, right, none });
+    EXPECT_EQ(predictor.Predict(releasedInputs, 7, 8), none);
+}
+
+TEST(FrequencyInputPredictor, LongHold)
+{
+    game::FrequencyInputPredictor predictor(16u);
+    auto playerInputs = CreateHold(right | attack, 40);
+    //The attack is only released for the last 6 frames of the window
+    for (auto frame = playerInputs.size() - 6; frame < playerInputs.size(); frame++)
+    {
+        playerInputs[frame] = right;
+    }
+    const auto inputs = CreateInputHistory(playerInputs);
+    EXPECT_EQ(predictor.Predict(inputs, 39, 40), right | attack);
+    //Half of the frames is not a majority
+    for (auto frame = playerInputs.size() - 8; frame < playerInputs.size(); frame++)
+    {
+        playerInputs[frame] = right;
+    }
+    EXPECT_EQ(predictor.Predict(CreateInputHistory(playerInputs), 39, 40), right);
+}
+
+TEST(FrequencyInputPredictor, FirstFrames)
+{
+    game::FrequencyInputPredictor predictor(16u);
+    //The window stops at frame 0
+    const auto inputs = CreateInputHistory({ right, none, right });
+    EXPECT_EQ(predictor.Predict(inputs, 0, 1), right);
+    EXPECT_EQ(predictor.Predict(inputs, 1, 2), none);
+    EXPECT_EQ(predictor.Predict(inputs, 2, 3), right);
+}
+
+TEST(FrequencyInputPredictor, LastReceivedFrameNotStored)
+{
+    constexpr std::size_t capacity = 16;
+    //Only the last 16 stored frames are counted in the window of 32 frames, 9 of them are pressed
+    auto playerInputs = CreateHold(none, 40);
+    for (auto frame = playerInputs.size() - 9; frame < playerInputs.size(); frame++)
+    {
+        playerInputs[frame] = right;
+    }
+    const auto inputs = CreateInputHistory(playerInputs, capacity);
+    game::FrequencyInputPredictor predictor(32u);
+    EXPECT_EQ(predictor.Predict(inputs, 39, 40), right);
+    EXPECT_EQ(predictor.Predict(inputs, 10, 41), none);
+    EXPECT_EQ(predictor.Predict(inputs, 45, 46), none);
+}
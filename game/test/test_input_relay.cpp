@@ -0,0 +1,487 @@
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "network/client.h"
+#include "network/server.h"
+
+namespace
+{
+/**
+ * \brief SendThroughWire gives back a packet as read on the other side of the network.
+ */
+game::Packet SendThroughWire(const game::Packet& packet)
+{
+    game::PacketBuffer buffer{};
+    const auto size = game::WritePacket(buffer, packet);
+    const auto readPacket = game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), size));
+    EXPECT_TRUE(readPacket.has_value());
+    return readPacket.value_or(packet);
+}
+
+class TestServer final : public game::Server
+{
+public:
+    /**
+     * \param spawnedPlayerNmb is the number of spawned player characters, the inputs of all the players are still validated
+     */
+    explicit TestServer(game::PlayerNumber spawnedPlayerNmb = game::maxPlayerNmb)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < spawnedPlayerNmb; playerNumber++)
+        {
+            gameManager_.SpawnPlayer(playerNumber, game::spawnPositions[playerNumber]);
+        }
+        lastPlayerNumber_ = game::maxPlayerNmb;
+    }
+    void Begin() override {}
+    void Update(sf::Time) override {}
+    void End() override {}
+    void SendReliablePacket(const game::Packet& packet) override { sentPackets.push_back(SendThroughWire(packet)); }
+    void SendUnreliablePacket(const game::Packet& packet) override { sentPackets.push_back(SendThroughWire(packet)); }
+    void Receive(const game::Packet& packet) { ReceivePacket(SendThroughWire(packet)); }
+    void ValidateFrames() { ValidateReceivedFrames(); }
+    void Tick(sf::Time dt) { UpdateTick(dt); }
+    template<typename T>
+    [[nodiscard]] std::size_t CountSentPackets() const
+    {
+        return static_cast<std::size_t>(std::count_if(sentPackets.begin(), sentPackets.end(), [](const auto& packet)
+            {
+                return std::holds_alternative<T>(packet);
+            }));
+    }
+    [[nodiscard]] const game::GameManager& GetGameManager() const { return gameManager_; }
+    /**
+     * \brief GetLastRelay gives the last inputs of a player relayed to the clients.
+     */
+    [[nodiscard]] const game::PlayerInputPacket* GetLastRelay(game::PlayerNumber playerNumber) const
+    {
+        for (auto it = sentPackets.rbegin(); it != sentPackets.rend(); ++it)
+        {
+            const auto* playerInputPacket = std::get_if<game::PlayerInputPacket>(&*it);
+            if (playerInputPacket != nullptr && playerInputPacket->playerNumber == playerNumber)
+            {
+                return playerInputPacket;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<game::Packet> sentPackets;
+protected:
+    void SpawnNewPlayer(game::ClientId, game::PlayerNumber) override {}
+};
+
+class TestClient final : public game::Client
+{
+public:
+    TestClient(game::PlayerNumber playerNumber, game::Frame inputRedundancy)
+    {
+        for (game::PlayerNumber spawnedPlayer = 0; spawnedPlayer < game::maxPlayerNmb; spawnedPlayer++)
+        {
+            gameManager_.SpawnPlayer(spawnedPlayer, game::spawnPositions[spawnedPlayer]);
+        }
+        gameManager_.SetClientPlayer(playerNumber);
+        gameManager_.SetInputRedundancy(inputRedundancy);
+        //A starting time in the past starts the game on the first fixed update
+        gameManager_.StartGame(1);
+    }
+    void Begin() override {}
+    void Update(sf::Time) override {}
+    void End() override {}
+    void Draw(sf::RenderTarget&) override {}
+    void DrawImGui() override {}
+    void SendReliablePacket(const game::Packet& packet) override { sentPackets.push_back(SendThroughWire(packet)); }
+    void SendUnreliablePacket(const game::Packet& packet) override { sentPackets.push_back(SendThroughWire(packet)); }
+    /**
+     * \brief PlayFrame sets the local input of the current frame and sends it with the not acknowledged ones.
+     * \return the frame of the input
+     */
+    game::Frame PlayFrame(game::PlayerInput playerInput)
+    {
+        const auto frame = gameManager_.GetCurrentFrame();
+        gameManager_.SetPlayerInput(gameManager_.GetPlayerNumber(), playerInput, frame);
+        gameManager_.FixedUpdate();
+        return frame;
+    }
+    /**
+     * \brief RepeatFrame sends the current frame without sampling its local input, like a second fixed update in the same update.
+     * \return the frame of the input
+     */
+    game::Frame RepeatFrame()
+    {
+        const auto frame = gameManager_.GetCurrentFrame();
+        gameManager_.FixedUpdate();
+        return frame;
+    }
+    void SetInputDelay(game::Frame inputDelay) { gameManager_.SetInputDelay(inputDelay); }
+    [[nodiscard]] const game::PlayerInputPacket* GetLastInputPacket() const
+    {
+        for (auto it = sentPackets.rbegin(); it != sentPackets.rend(); ++it)
+        {
+            if (const auto* playerInputPacket = std::get_if<game::PlayerInputPacket>(&*it))
+            {
+                return playerInputPacket;
+            }
+        }
+        return nullptr;
+    }
+    [[nodiscard]] game::PlayerInput GetLocalInput(game::Frame frame) const
+    {
+        return gameManager_.GetRollbackManager().GetInputs(gameManager_.GetPlayerNumber()).GetInput(frame);
+    }
+    [[nodiscard]] const game::ClientGameManager& GetGameManager() const { return gameManager_; }
+
+    std::vector<game::Packet> sentPackets;
+};
+
+void ReceiveInputs(TestServer& server, game::PlayerNumber playerNumber, game::Frame currentFrame,
+    const std::vector<game::PlayerInput>& inputs, game::Frame ackFrame = 0)
+{
+    game::PlayerInputPacket playerInputPacket;
+    playerInputPacket.playerNumber = playerNumber;
+    playerInputPacket.currentFrame = currentFrame;
+    playerInputPacket.ackFrame = ackFrame;
+    playerInputPacket.inputNmb = static_cast<std::uint8_t>(inputs.size());
+    std::copy(inputs.begin(), inputs.end(), playerInputPacket.inputs.begin());
+    server.Receive(playerInputPacket);
+}
+}
+
+TEST(InputRelay, StopsAtMissingFrame)
+{
+    TestServer server;
+    //Inputs of frames 5 to 1, then of frames 10 to 8 with frames 6 and 7 missing
+    ReceiveInputs(server, 0, 5, { 1u, 1u, 2u, 2u, 3u });
+    ReceiveInputs(server, 0, 10, { 4u, 4u, 4u });
+    const auto& rollbackManager = server.GetGameManager().GetRollbackManager();
+    EXPECT_EQ(rollbackManager.GetLastReceivedFrame(0), 10u);
+    EXPECT_EQ(rollbackManager.GetLastContiguousFrame(0), 5u);
+
+    //The relay neither acknowledges nor sends the predicted inputs after the missing frames
+    const auto* relay = server.GetLastRelay(0);
+    ASSERT_NE(relay, nullptr);
+    EXPECT_EQ(relay->currentFrame, 5u);
+    EXPECT_EQ(relay->ackFrame, 5u);
+    ASSERT_EQ(relay->inputNmb, 5u);
+    EXPECT_EQ(relay->inputs[0], 1u);
+    EXPECT_EQ(relay->inputs[4], 3u);
+
+    ReceiveInputs(server, 1, 10, std::vector<game::PlayerInput>(10, 0u));
+    server.ValidateFrames();
+    EXPECT_EQ(server.GetGameManager().GetLastValidateFrame(), 5u);
+
+    ReceiveInputs(server, 0, 7, { 5u, 5u });
+    EXPECT_EQ(rollbackManager.GetLastContiguousFrame(0), 10u);
+    relay = server.GetLastRelay(0);
+    ASSERT_NE(relay, nullptr);
+    EXPECT_EQ(relay->currentFrame, 10u);
+    EXPECT_EQ(relay->ackFrame, 10u);
+    server.ValidateFrames();
+    EXPECT_EQ(server.GetGameManager().GetLastValidateFrame(), 10u);
+}
+
+TEST(InputRelay, StartsAfterRemoteAck)
+{
+    TestServer server;
+    ReceiveInputs(server, 0, 10, std::vector<game::PlayerInput>(10, 1u));
+    //The other client received the inputs until frame 8
+    ReceiveInputs(server, 1, 10, std::vector<game::PlayerInput>(10, 0u), 8);
+    ReceiveInputs(server, 0, 11, { 2u, 1u });
+    const auto* relay = server.GetLastRelay(0);
+    ASSERT_NE(relay, nullptr);
+    EXPECT_EQ(relay->currentFrame, 11u);
+    ASSERT_EQ(relay->inputNmb, 3u);
+    EXPECT_EQ(relay->inputs[0], 2u);
+}
+
+TEST(InputRelay, CappedFromRemoteAck)
+{
+    TestServer server;
+    constexpr game::Frame lastFrame = game::maxInputNmb + 20;
+    for (game::Frame frame = 1; frame <= lastFrame; frame++)
+    {
+        ReceiveInputs(server, 0, frame, { static_cast<game::PlayerInput>(frame % 32u) });
+    }
+    //The other client did not acknowledge anything, the relay starts from the first frame and the newest frames wait
+    const auto* relay = server.GetLastRelay(0);
+    ASSERT_NE(relay, nullptr);
+    EXPECT_EQ(relay->currentFrame, game::maxInputNmb);
+    ASSERT_EQ(relay->inputNmb, game::maxInputNmb);
+    EXPECT_EQ(relay->inputs[game::maxInputNmb - 1], 1u);
+}
+
+TEST(InputRelay, RejectsInputsAfterWindow)
+{
+    TestServer server;
+    const auto& rollbackManager = server.GetGameManager().GetRollbackManager();
+    const auto windowCapacity = rollbackManager.GetWindowCapacity();
+    //A wrong frame number does not grow the window
+    ReceiveInputs(server, 0, rollbackManager.GetWindowEndFrame() + 1, { 1u });
+    ReceiveInputs(server, 0, game::INVALID_FRAME - 1, { 1u });
+    EXPECT_EQ(rollbackManager.GetLastReceivedFrame(0), 0u);
+    EXPECT_EQ(rollbackManager.GetCurrentFrame(), 0u);
+    EXPECT_EQ(rollbackManager.GetWindowCapacity(), windowCapacity);
+
+    ReceiveInputs(server, 0, rollbackManager.GetWindowEndFrame(), { 1u });
+    EXPECT_EQ(rollbackManager.GetLastReceivedFrame(0), rollbackManager.GetWindowEndFrame());
+    EXPECT_EQ(rollbackManager.GetWindowCapacity(), game::maxWindowBufferSize);
+}
+
+TEST(InputRelay, StalledPlayerEndsGame)
+{
+    TestServer server;
+    const auto& rollbackManager = server.GetGameManager().GetRollbackManager();
+    const auto countWinGamePackets = [&server]()
+    {
+        return std::count_if(server.sentPackets.begin(), server.sentPackets.end(), [](const auto& packet)
+            {
+                return std::holds_alternative<game::WinGamePacket>(packet);
+            });
+    };
+    //Player 1 stops sending its inputs after frame 10, the validation waits for it until player 0 fills the window
+    ReceiveInputs(server, 1, 10, std::vector<game::PlayerInput>(10, 0u));
+    constexpr game::Frame windowEndFrame = 10 + game::maxWindowBufferSize - 1;
+    for (game::Frame frame = 1; frame < windowEndFrame; frame++)
+    {
+        ReceiveInputs(server, 0, frame, { 1u });
+        server.ValidateFrames();
+    }
+    EXPECT_EQ(rollbackManager.GetLastValidateFrame(), 10u);
+    EXPECT_EQ(countWinGamePackets(), 0);
+
+    //The game ends once, without a winner, like on a disconnection
+    ReceiveInputs(server, 0, windowEndFrame, { 1u });
+    server.ValidateFrames();
+    ReceiveInputs(server, 0, windowEndFrame + 1, { 1u });
+    server.ValidateFrames();
+    EXPECT_EQ(rollbackManager.GetLastContiguousFrame(0), windowEndFrame);
+    ASSERT_EQ(countWinGamePackets(), 1);
+    const auto winGamePacket = std::find_if(server.sentPackets.begin(), server.sentPackets.end(), [](const auto& packet)
+        {
+            return std::holds_alternative<game::WinGamePacket>(packet);
+        });
+    EXPECT_EQ(std::get<game::WinGamePacket>(*winGamePacket).winner, game::INVALID_PLAYER);
+}
+
+TEST(InputRelay, ValidatesOncePerTick)
+{
+    //With a single spawned player, each validation checks the winner and declares it
+    TestServer server(1);
+    const auto& rollbackManager = server.GetGameManager().GetRollbackManager();
+    const auto receiveFrame = [&server](game::Frame frame)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            ReceiveInputs(server, playerNumber, frame, { 0u });
+        }
+    };
+    //Several frames received during one tick are validated together
+    for (game::Frame frame = 1; frame <= 3; frame++)
+    {
+        receiveFrame(frame);
+        server.Tick(sf::seconds(game::serverTickPeriod * 0.25f));
+    }
+    EXPECT_EQ(server.CountSentPackets<game::ValidateFramePacket>(), 0u);
+    EXPECT_EQ(rollbackManager.GetLastValidateFrame(), 0u);
+    server.Tick(sf::seconds(game::serverTickPeriod * 0.3f));
+    ASSERT_EQ(server.CountSentPackets<game::ValidateFramePacket>(), 1u);
+    EXPECT_EQ(server.CountSentPackets<game::WinGamePacket>(), 1u);
+    EXPECT_EQ(rollbackManager.GetLastValidateFrame(), 3u);
+
+    //A long update validates everything received once, and keeps the time left over for the next tick
+    for (game::Frame frame = 4; frame <= 6; frame++)
+    {
+        receiveFrame(frame);
+    }
+    server.Tick(sf::seconds(game::serverTickPeriod * 2.5f));
+    EXPECT_EQ(server.CountSentPackets<game::ValidateFramePacket>(), 2u);
+    EXPECT_EQ(server.CountSentPackets<game::WinGamePacket>(), 2u);
+    EXPECT_EQ(rollbackManager.GetLastValidateFrame(), 6u);
+    receiveFrame(7);
+    server.Tick(sf::seconds(game::serverTickPeriod * 0.5f));
+    EXPECT_EQ(server.CountSentPackets<game::ValidateFramePacket>(), 3u);
+    EXPECT_EQ(server.CountSentPackets<game::WinGamePacket>(), 3u);
+    EXPECT_EQ(rollbackManager.GetLastValidateFrame(), 7u);
+    const auto validateFramePacket = std::find_if(server.sentPackets.rbegin(), server.sentPackets.rend(), [](const auto& packet)
+        {
+            return std::holds_alternative<game::ValidateFramePacket>(packet);
+        });
+    EXPECT_EQ(std::get<game::ValidateFramePacket>(*validateFramePacket).newValidateFrame, 7u);
+
+    //Nothing new received, nothing validated
+    server.Tick(sf::seconds(game::serverTickPeriod));
+    EXPECT_EQ(server.CountSentPackets<game::ValidateFramePacket>(), 3u);
+}
+
+TEST(InputDelay, SendsInputsAhead)
+{
+    using namespace game::PlayerInputEnum;
+    TestServer server;
+    TestClient client(0, game::maxInputNmb);
+    client.SetInputDelay(3);
+    EXPECT_EQ(client.GetGameManager().GetLocalInputFrame(10), 13u);
+
+    //The input sampled on frame 0 is applied and sent on frame 3, the frames before it keep the initial input
+    EXPECT_EQ(client.PlayFrame(UP), 0u);
+    EXPECT_EQ(client.GetLocalInput(1), NONE);
+    EXPECT_EQ(client.GetLocalInput(2), NONE);
+    EXPECT_EQ(client.GetLocalInput(3), UP);
+    const auto* playerInputPacket = client.GetLastInputPacket();
+    ASSERT_NE(playerInputPacket, nullptr);
+    EXPECT_EQ(playerInputPacket->currentFrame, 3u);
+    EXPECT_EQ(playerInputPacket->inputDelay, 3u);
+    EXPECT_EQ(playerInputPacket->inputs[0], UP);
+    //The server and the other players receive it three frames before simulating it
+    server.Receive(*playerInputPacket);
+    EXPECT_EQ(server.GetGameManager().GetRollbackManager().GetLastReceivedFrame(0), 3u);
+    EXPECT_EQ(server.GetLastRelay(0)->currentFrame, 3u);
+    EXPECT_EQ(server.GetLastRelay(0)->inputDelay, 3u);
+
+    EXPECT_EQ(client.PlayFrame(DOWN), 1u);
+    EXPECT_EQ(client.GetLocalInput(4), DOWN);
+    //Without a sampled input, the frame repeats the last sent input
+    EXPECT_EQ(client.RepeatFrame(), 2u);
+    EXPECT_EQ(client.GetLocalInput(5), DOWN);
+    EXPECT_EQ(client.GetLastInputPacket()->currentFrame, 5u);
+
+    //When the delay decreases, the inputs of the already sent frames are dropped
+    client.SetInputDelay(1);
+    EXPECT_EQ(client.PlayFrame(LEFT), 3u);
+    EXPECT_EQ(client.PlayFrame(RIGHT), 4u);
+    EXPECT_EQ(client.GetLocalInput(4), DOWN);
+    EXPECT_EQ(client.GetLocalInput(5), DOWN);
+    EXPECT_EQ(client.GetLastInputPacket()->currentFrame, 5u);
+    EXPECT_EQ(client.PlayFrame(ATTACK), 5u);
+    EXPECT_EQ(client.GetLocalInput(6), ATTACK);
+    EXPECT_EQ(client.GetLastInputPacket()->currentFrame, 6u);
+    EXPECT_EQ(client.GetLastInputPacket()->inputDelay, 1u);
+
+    //When the delay increases, the skipped frames repeat the last sent input
+    client.SetInputDelay(4);
+    EXPECT_EQ(client.PlayFrame(UP), 6u);
+    for (game::Frame frame = 7; frame < 10; frame++)
+    {
+        EXPECT_EQ(client.GetLocalInput(frame), ATTACK) << "frame " << frame;
+    }
+    EXPECT_EQ(client.GetLocalInput(10), UP);
+    EXPECT_EQ(client.GetLastInputPacket()->currentFrame, 10u);
+    const auto& localInputs = client.GetGameManager().GetRollbackManager().GetInputs(0);
+    for (game::Frame frame = 1; frame <= 10; frame++)
+    {
+        EXPECT_TRUE(localInputs.IsReceived(frame)) << "frame " << frame;
+    }
+}
+
+TEST(InputDelay, KeepsCurrentFrame)
+{
+    using namespace game::PlayerInputEnum;
+    constexpr game::Frame inputDelay = 4;
+    TestClient client(0, game::maxInputNmb);
+    client.SetInputDelay(inputDelay);
+    const auto& gameManager = client.GetGameManager();
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    for (game::Frame frame = 0; frame < 20; frame++)
+    {
+        const auto playerInput = frame % 2 == 0 ? LEFT : RIGHT;
+        EXPECT_EQ(client.PlayFrame(playerInput), frame);
+        //The delayed local input is stored ahead, the remote player is only predicted until the game frame
+        EXPECT_EQ(client.GetLocalInput(frame + inputDelay), playerInput);
+        EXPECT_EQ(rollbackManager.GetCurrentFrame(), gameManager.GetCurrentFrame());
+        EXPECT_EQ(rollbackManager.GetInputs(1).GetCurrentFrame(), gameManager.GetCurrentFrame());
+    }
+}
+
+namespace
+{
+/**
+ * \brief PlayWithLosses plays the two clients with a server through bursts of lost packets,
+ * and checks that the server validates the inputs the clients played with the checksums of the clients.
+ */
+void PlayWithLosses(const std::array<game::Frame, game::maxPlayerNmb>& inputDelays)
+{
+    constexpr game::Frame inputRedundancy = 10;
+    constexpr game::Frame frameNmb = 400;
+    TestServer server;
+    std::array<TestClient, game::maxPlayerNmb> clients{ TestClient(0, inputRedundancy), TestClient(1, inputRedundancy) };
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+    {
+        clients[playerNumber].SetInputDelay(inputDelays[playerNumber]);
+    }
+    //Client 0 loses its input packets for longer than its redundancy, then client 1 misses the relays for longer than maxInputNmb
+    const auto isClientPacketLost = [](game::PlayerNumber playerNumber, game::Frame frame)
+    {
+        return playerNumber == 0 && frame >= 50 && frame < 90;
+    };
+    const auto isServerPacketLost = [](game::PlayerNumber playerNumber, game::Frame frame)
+    {
+        return playerNumber == 1 && frame >= 150 && frame < 230;
+    };
+    std::array<std::vector<game::PlayerInput>, game::maxPlayerNmb> playedInputs;
+    game::Frame lastValidateFrame = 0;
+    for (game::Frame step = 0; step < frameNmb; step++)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            const auto playerInput = static_cast<game::PlayerInput>((step / (5u + playerNumber) + playerNumber) % 4u);
+            auto& client = clients[playerNumber];
+            //Some frames repeat the input of the previous frame without sampling it
+            const auto frame = step % 7 == 3 ? client.RepeatFrame() : client.PlayFrame(playerInput);
+            //The local inputs are final once sent, until the frame the input of this frame is applied on
+            auto& clientPlayedInputs = playedInputs[playerNumber];
+            for (auto inputFrame = static_cast<game::Frame>(clientPlayedInputs.size());
+                inputFrame <= client.GetGameManager().GetLocalInputFrame(frame); inputFrame++)
+            {
+                clientPlayedInputs.push_back(client.GetLocalInput(inputFrame));
+            }
+            for (const auto& packet : client.sentPackets)
+            {
+                if (!isClientPacketLost(playerNumber, step))
+                {
+                    server.Receive(packet);
+                }
+            }
+            client.sentPackets.clear();
+        }
+        server.ValidateFrames();
+        //The server only validates the inputs the clients played
+        const auto& serverRollbackManager = server.GetGameManager().GetRollbackManager();
+        const auto newValidateFrame = serverRollbackManager.GetLastValidateFrame();
+        for (game::Frame frame = lastValidateFrame + 1; frame <= newValidateFrame; frame++)
+        {
+            for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+            {
+                ASSERT_EQ(serverRollbackManager.GetInputs(playerNumber).GetInput(frame), playedInputs[playerNumber][frame])
+                    << "player " << static_cast<int>(playerNumber) << " frame " << frame;
+            }
+        }
+        lastValidateFrame = newValidateFrame;
+        for (const auto& packet : server.sentPackets)
+        {
+            for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+            {
+                if (!isServerPacketLost(playerNumber, step) || !std::holds_alternative<game::PlayerInputPacket>(packet))
+                {
+                    clients[playerNumber].ReceivePacket(packet);
+                }
+            }
+        }
+        server.sentPackets.clear();
+    }
+    //Both clients caught up after the losses and confirmed the validated frames with the same checksums as the server
+    EXPECT_GT(lastValidateFrame, frameNmb - inputRedundancy);
+    for (const auto& client : clients)
+    {
+        EXPECT_EQ(client.GetGameManager().GetLastValidateFrame(), lastValidateFrame);
+    }
+}
+}
+
+TEST(InputRelay, LossBurstsLongerThanRedundancy)
+{
+    PlayWithLosses({ 0, 0 });
+}
+
+TEST(InputDelay, LossBurstsLongerThanRedundancy)
+{
+    PlayWithLosses({ 2, 5 });
+}
@@ -0,0 +1,171 @@
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "network/packet_type.h"
+
+namespace
+{
+constexpr auto clientId = game::ClientId{ 3 };
+
+void ExpectSameFields(const game::JoinPacket& packet, const game::JoinPacket& expectedPacket)
+{
+    EXPECT_EQ(packet.clientId, expectedPacket.clientId);
+    EXPECT_EQ(packet.startTime, expectedPacket.startTime);
+}
+
+void ExpectSameFields(const game::JoinAckPacket& packet, const game::JoinAckPacket& expectedPacket)
+{
+    EXPECT_EQ(packet.clientId, expectedPacket.clientId);
+    EXPECT_EQ(packet.udpPort, expectedPacket.udpPort);
+}
+
+void ExpectSameFields(const game::SpawnPlayerPacket& packet, const game::SpawnPlayerPacket& expectedPacket)
+{
+    EXPECT_EQ(packet.clientId, expectedPacket.clientId);
+    EXPECT_EQ(packet.playerNumber, expectedPacket.playerNumber);
+    EXPECT_EQ(packet.pos.x, expectedPacket.pos.x);
+    EXPECT_EQ(packet.pos.y, expectedPacket.pos.y);
+    EXPECT_EQ(packet.angle.value(), expectedPacket.angle.value());
+}
+
+void ExpectSameFields(const game::PlayerInputPacket& packet, const game::PlayerInputPacket& expectedPacket)
+{
+    EXPECT_EQ(packet.playerNumber, expectedPacket.playerNumber);
+    EXPECT_EQ(packet.currentFrame, expectedPacket.currentFrame);
+    EXPECT_EQ(packet.ackFrame, expectedPacket.ackFrame);
+    EXPECT_EQ(packet.inputDelay, expectedPacket.inputDelay);
+    ASSERT_EQ(packet.inputNmb, expectedPacket.inputNmb);
+    for (std::size_t i = 0; i < expectedPacket.inputNmb; i++)
+    {
+        EXPECT_EQ(packet.inputs[i], expectedPacket.inputs[i]) << "input " << i;
+    }
+}
+
+void ExpectSameFields(const game::ValidateFramePacket& packet, const game::ValidateFramePacket& expectedPacket)
+{
+    EXPECT_EQ(packet.newValidateFrame, expectedPacket.newValidateFrame);
+    EXPECT_EQ(packet.checksum, expectedPacket.checksum);
+    ASSERT_EQ(packet.hasComponentChecksums, expectedPacket.hasComponentChecksums);
+    if (expectedPacket.hasComponentChecksums)
+    {
+        EXPECT_EQ(packet.componentChecksums, expectedPacket.componentChecksums);
+    }
+}
+
+void ExpectSameFields(const game::StartGamePacket&, const game::StartGamePacket&)
+{
+}
+
+void ExpectSameFields(const game::WinGamePacket& packet, const game::WinGamePacket& expectedPacket)
+{
+    EXPECT_EQ(packet.winner, expectedPacket.winner);
+}
+
+void ExpectSameFields(const game::PingPacket& packet, const game::PingPacket& expectedPacket)
+{
+    EXPECT_EQ(packet.time, expectedPacket.time);
+    EXPECT_EQ(packet.clientId, expectedPacket.clientId);
+}
+
+/**
+ * \brief CreatePackets gives a packet of each Packet alternative with all its fields set,
+ * and a ValidateFramePacket without its component checksums.
+ */
+std::vector<game::Packet> CreatePackets()
+{
+    std::vector<game::Packet> packets;
+    packets.emplace_back(game::JoinPacket{ clientId, 1'700'000'000'123ull });
+    game::SpawnPlayerPacket spawnPlayerPacket;
+    spawnPlayerPacket.clientId = clientId;
+    spawnPlayerPacket.playerNumber = 1u;
+    spawnPlayerPacket.pos = { -1.5f, 2.25f };
+    spawnPlayerPacket.angle = core::Degree(90.0f);
+    packets.emplace_back(spawnPlayerPacket);
+    game::PlayerInputPacket playerInputPacket;
+    playerInputPacket.playerNumber = 1u;
+    playerInputPacket.currentFrame = 300u;
+    playerInputPacket.ackFrame = 290u;
+    playerInputPacket.inputDelay = 2u;
+    playerInputPacket.inputNmb = 5u;
+    playerInputPacket.inputs = { game::PlayerInputEnum::UP, game::PlayerInputEnum::UP, game::PlayerInputEnum::LEFT,
+        game::PlayerInputEnum::ATTACK, game::PlayerInputEnum::NONE };
+    packets.emplace_back(playerInputPacket);
+    game::ValidateFramePacket validateFramePacket;
+    validateFramePacket.newValidateFrame = 280u;
+    validateFramePacket.checksum = 0x0123'4567'89ab'cdefull;
+    packets.emplace_back(validateFramePacket);
+    game::WriteWorldChecksum(validateFramePacket, { 0xfedc'ba98'7654'3210ull, { { 1u, 2u, 0xffff'ffff'ffff'ffffull, 4u } } });
+    packets.emplace_back(validateFramePacket);
+    packets.emplace_back(game::StartGamePacket{});
+    packets.emplace_back(game::JoinAckPacket{ clientId, 12345u });
+    packets.emplace_back(game::WinGamePacket{ 1u });
+    packets.emplace_back(game::PingPacket{ 1'700'000'000'456ull, clientId });
+    return packets;
+}
+}
+
+TEST(Packet, RoundTrip)
+{
+    for (const auto& packet : CreatePackets())
+    {
+        game::PacketBuffer buffer{};
+        const auto size = game::WritePacket(buffer, packet);
+        ASSERT_LE(size, game::maxPacketSize);
+        const auto readPacket = game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), size));
+        ASSERT_TRUE(readPacket.has_value()) << "packet type " << static_cast<int>(game::GetPacketType(packet));
+        ASSERT_EQ(readPacket->index(), packet.index());
+        std::visit([&readPacket](const auto& expectedPacket)
+        {
+            using PacketT = std::decay_t<decltype(expectedPacket)>;
+            ExpectSameFields(std::get<PacketT>(*readPacket), expectedPacket);
+        }, packet);
+    }
+}
+
+TEST(Packet, WireSize)
+{
+    for (const auto& packet : CreatePackets())
+    {
+        game::PacketBuffer buffer{};
+        const auto size = game::WritePacket(buffer, packet);
+        std::visit([size](const auto& typedPacket)
+        {
+            using PacketT = std::decay_t<decltype(typedPacket)>;
+            //The inputs are run-length encoded and the component checksums are optional, the other packets have a fixed size
+            if constexpr (std::is_same_v<PacketT, game::PlayerInputPacket>)
+            {
+                EXPECT_LT(size, sizeof(game::PacketType) + PacketT::wireSize);
+            }
+            else if constexpr (std::is_same_v<PacketT, game::ValidateFramePacket>)
+            {
+                EXPECT_EQ(size, sizeof(game::PacketType) + PacketT::wireSize -
+                    (typedPacket.hasComponentChecksums ? 0u : sizeof(game::Checksum) * game::checksumComponentNmb));
+            }
+            else
+            {
+                EXPECT_EQ(size, sizeof(game::PacketType) + PacketT::wireSize);
+            }
+        }, packet);
+    }
+}
+
+TEST(Packet, Truncated)
+{
+    for (const auto& packet : CreatePackets())
+    {
+        game::PacketBuffer buffer{};
+        const auto size = game::WritePacket(buffer, packet);
+        for (std::size_t truncatedSize = 0; truncatedSize < size; truncatedSize++)
+        {
+            EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), truncatedSize)).has_value())
+                << "packet type " << static_cast<int>(game::GetPacketType(packet)) << " size " << truncatedSize;
+        }
+    }
+}
+
+TEST(Packet, UnknownType)
+{
+    game::PacketBuffer buffer{};
+    buffer[0] = static_cast<std::uint8_t>(game::PacketType::NONE);
+    EXPECT_FALSE(game::ReadPacket(std::span<const std::uint8_t>(buffer.data(), buffer.size())).has_value());
+}
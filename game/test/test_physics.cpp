@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "game/physics_manager.h"
+
+namespace
+{
+/**
+ * \brief ScalarIntegrate is the update of the positions of the bodies one by one, before the vectorised kernels.
+ */
+void ScalarIntegrate(std::vector<game::Body>& bodies, const std::vector<bool>& simulatedBodies, core::Scalar dt)
+{
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        if (!simulatedBodies[i])
+            continue;
+        auto& body = bodies[i];
+        if (body.bodyType == game::BodyType::DYNAMIC || body.bodyType == game::BodyType::KINEMATIC)
+        {
+            body.position += body.velocity * dt;
+            body.rotation += body.angularVelocity * dt;
+        }
+        if (body.bodyType == game::BodyType::STATIC)
+        {
+            body.velocity = core::Vec2f::zero();
+            body.angularVelocity = core::Degree(0.0f);
+        }
+    }
+}
+
+/**
+ * \brief ScalarGravityAndGround is the gravity then ground update of the bodies one by one, before the vectorised kernels.
+ */
+void ScalarGravityAndGround(std::vector<game::Body>& bodies, const std::vector<bool>& simulatedBodies, core::Scalar dt)
+{
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        auto& body = bodies[i];
+        if (simulatedBodies[i] && body.affectedByGravity_)
+        {
+            body.velocity += game::gravity * dt;
+        }
+    }
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        auto& body = bodies[i];
+        if (simulatedBodies[i] && body.affectedByGravity_ && body.position.y <= game::groundLevel)
+        {
+            body.position.y = game::groundLevel;
+            body.velocity.y = 0.0f;
+        }
+    }
+}
+
+bool IsSameScalar(core::Scalar a, core::Scalar b)
+{
+    //Compares the bits, as -0.0 == 0.0
+    return std::memcmp(&a, &b, sizeof(core::Scalar)) == 0;
+}
+
+/**
+ * \brief ReadBody gives the stored body of an Entity, even when the Entity has lost its Body component.
+ */
+game::Body ReadBody(const game::BodyArenaLayout& layout, const core::Arena& arena, core::Entity entity)
+{
+    const auto index = layout.sparseSet.GetIndex(arena, entity);
+    return { arena.Get<core::Vec2f>(layout.positions)[index], arena.Get<core::Vec2f>(layout.velocities)[index],
+        arena.Get<core::Degree>(layout.angularVelocities)[index], arena.Get<core::Degree>(layout.rotations)[index],
+        arena.Get<game::BodyType>(layout.bodyTypes)[index], arena.Get<std::uint8_t>(layout.affectedByGravity)[index] != 0 };
+}
+
+void ExpectSameBody(const game::Body& body, const game::Body& expectedBody, std::size_t bodyIndex, int step)
+{
+    EXPECT_TRUE(IsSameScalar(body.position.x, expectedBody.position.x)) << "body " << bodyIndex << " step " << step;
+    EXPECT_TRUE(IsSameScalar(body.position.y, expectedBody.position.y)) << "body " << bodyIndex << " step " << step;
+    EXPECT_TRUE(IsSameScalar(body.velocity.x, expectedBody.velocity.x)) << "body " << bodyIndex << " step " << step;
+    EXPECT_TRUE(IsSameScalar(body.velocity.y, expectedBody.velocity.y)) << "body " << bodyIndex << " step " << step;
+    EXPECT_TRUE(IsSameScalar(body.rotation.value(), expectedBody.rotation.value())) << "body " << bodyIndex << " step " << step;
+    EXPECT_TRUE(IsSameScalar(body.angularVelocity.value(), expectedBody.angularVelocity.value())) << "body " << bodyIndex << " step " << step;
+}
+
+/**
+ * \brief ContactRecorder is a contact listener keeping the contacts of the last PhysicsManager::FixedUpdate.
+ */
+struct ContactRecorder
+{
+    void OnContacts(const std::vector<game::Contact>& newContacts) { contacts = newContacts; }
+    std::vector<game::Contact> contacts;
+};
+
+/**
+ * \brief BoxScene is a set of static boxes that are not moved by the physics update.
+ */
+struct BoxScene
+{
+    explicit BoxScene(std::size_t boxNmb) : physicsLayout(arenaLayout), arena(arenaLayout, boxNmb + 1),
+        physicsManager(entityManager, physicsLayout, arena)
+    {
+    }
+    void AddBox(core::Vec2f position, core::Vec2f extends)
+    {
+        const auto entity = entityManager.CreateEntity();
+        game::Body body;
+        body.position = position;
+        body.bodyType = game::BodyType::STATIC;
+        body.affectedByGravity_ = false;
+        physicsManager.AddBody(entity);
+        physicsManager.SetBody(entity, body);
+        game::Box box;
+        box.extends = extends;
+        physicsManager.AddBox(entity);
+        physicsManager.SetBox(entity, box);
+        entities.push_back(entity);
+        bodies.push_back({ position, extends });
+    }
+    /**
+     * \brief FindBruteForceContacts tests every pair of boxes, in ascending Entity order.
+     */
+    [[nodiscard]] std::vector<game::Contact> FindBruteForceContacts() const
+    {
+        std::vector<game::Contact> contacts;
+        for (std::size_t i = 0; i < entities.size(); i++)
+        {
+            for (std::size_t j = i + 1; j < entities.size(); j++)
+            {
+                const auto& [position1, extends1] = bodies[i];
+                const auto& [position2, extends2] = bodies[j];
+                if (position1.x - extends1.x <= position2.x + extends2.x &&
+                    position1.y - extends1.y <= position2.y + extends2.y &&
+                    position1.x + extends1.x >= position2.x - extends2.x &&
+                    position1.y + extends1.y >= position2.y - extends2.y)
+                {
+                    contacts.push_back({ entities[i], entities[j] });
+                }
+            }
+        }
+        return contacts;
+    }
+    [[nodiscard]] std::vector<game::Contact> FindContacts(std::unique_ptr<game::BroadphaseInterface> broadphase)
+    {
+        physicsManager.SetBroadphase(std::move(broadphase));
+        ContactRecorder contactRecorder;
+        physicsManager.FixedUpdate(sf::seconds(0.0f), contactRecorder);
+        return contactRecorder.contacts;
+    }
+
+    core::EntityManager entityManager;
+    core::ArenaLayout arenaLayout;
+    game::PhysicsArenaLayout physicsLayout;
+    core::Arena arena;
+    game::PhysicsManager physicsManager;
+    std::vector<core::Entity> entities;
+    std::vector<std::pair<core::Vec2f, core::Vec2f>> bodies;
+};
+
+/**
+ * \brief ExpectSameContacts checks the contacts of both broadphases against the brute force ones, in the same order.
+ */
+void ExpectSameContacts(BoxScene& boxScene)
+{
+    const auto expectedContacts = boxScene.FindBruteForceContacts();
+    ASSERT_FALSE(expectedContacts.empty());
+    std::vector<std::unique_ptr<game::BroadphaseInterface>> broadphases;
+    broadphases.push_back(std::make_unique<game::SweepAndPruneBroadphase>());
+    broadphases.push_back(std::make_unique<game::UniformGridBroadphase>(1.0f));
+    for (std::size_t broadphaseIndex = 0; broadphaseIndex < 2; broadphaseIndex++)
+    {
+        const auto contacts = boxScene.FindContacts(std::move(broadphases[broadphaseIndex]));
+        ASSERT_EQ(contacts.size(), expectedContacts.size()) << "broadphase " << broadphaseIndex;
+        for (std::size_t i = 0; i < contacts.size(); i++)
+        {
+            EXPECT_EQ(contacts[i].entity1, expectedContacts[i].entity1) << "broadphase " << broadphaseIndex << " contact " << i;
+            EXPECT_EQ(contacts[i].entity2, expectedContacts[i].entity2) << "broadphase " << broadphaseIndex << " contact " << i;
+            //Ascending Entity order, the first Entity of a contact is always the lower one
+            EXPECT_LT(contacts[i].entity1, contacts[i].entity2);
+            if (i > 0)
+            {
+                EXPECT_TRUE(contacts[i - 1].entity1 < contacts[i].entity1 ||
+                    (contacts[i - 1].entity1 == contacts[i].entity1 && contacts[i - 1].entity2 < contacts[i].entity2));
+            }
+        }
+    }
+}
+}
+
+TEST(Physics, KernelsMatchScalarUpdate)
+{
+    constexpr std::size_t bodyNmb = 67;
+    constexpr int stepNmb = 100;
+    const core::Scalar dt = game::fixedPeriod;
+
+    core::EntityManager entityManager;
+    core::ArenaLayout arenaLayout;
+    const game::BodyArenaLayout layout(arenaLayout);
+    core::Arena arena(arenaLayout, bodyNmb + 1);
+    game::BodyManager bodyManager(entityManager, layout, arena);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> positionDistribution(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> velocityDistribution(-10.0f, 10.0f);
+    std::vector<core::Entity> entities;
+    std::vector<game::Body> expectedBodies;
+    std::vector<bool> simulatedBodies;
+    for (std::size_t i = 0; i < bodyNmb; i++)
+    {
+        game::Body body;
+        body.position = { positionDistribution(generator), positionDistribution(generator) };
+        body.velocity = { velocityDistribution(generator), velocityDistribution(generator) };
+        body.angularVelocity = core::Degree(velocityDistribution(generator));
+        body.rotation = core::Degree(positionDistribution(generator));
+        body.bodyType = static_cast<game::BodyType>(i % 3);
+        body.affectedByGravity_ = i % 4 != 0;
+        switch (i % 5)
+        {
+        case 0:
+            //Negative zeros need to stay negative when the body does not move
+            body.position = { -0.0f, -0.0f };
+            body.velocity = { -0.0f, -0.0f };
+            body.rotation = core::Degree(-0.0f);
+            break;
+        case 1:
+            body.position.y = game::groundLevel;
+            break;
+        case 2:
+            body.position.y = game::groundLevel - 1.0f;
+            break;
+        default:
+            break;
+        }
+        const auto entity = entityManager.CreateEntity();
+        bodyManager.AddComponent(entity);
+        bodyManager.SetComponent(entity, body);
+        //A stored body whose entity lost its Body component is not simulated anymore
+        const bool isSimulated = i % 7 != 0;
+        if (!isSimulated)
+        {
+            entityManager.RemoveComponent(entity, game::BodyManager::componentType);
+        }
+        entities.push_back(entity);
+        expectedBodies.push_back(body);
+        simulatedBodies.push_back(isSimulated);
+    }
+
+    for (int step = 0; step < stepNmb; step++)
+    {
+        bodyManager.Integrate(dt);
+        ScalarIntegrate(expectedBodies, simulatedBodies, dt);
+        bodyManager.ResolveGravityAndGround(dt);
+        ScalarGravityAndGround(expectedBodies, simulatedBodies, dt);
+        for (std::size_t i = 0; i < bodyNmb; i++)
+        {
+            ExpectSameBody(ReadBody(layout, arena, entities[i]), expectedBodies[i], i, step);
+        }
+        if (HasFailure())
+            return;
+    }
+}
+
+TEST(Physics, GroundClamp)
+{
+    core::EntityManager entityManager;
+    core::ArenaLayout arenaLayout;
+    const game::BodyArenaLayout layout(arenaLayout);
+    core::Arena arena(arenaLayout, 4);
+    game::BodyManager bodyManager(entityManager, layout, arena);
+
+    game::Body fallingBody;
+    fallingBody.position = { 1.0f, game::groundLevel + 0.01f };
+    fallingBody.velocity = { 2.0f, -5.0f };
+    const auto fallingEntity = entityManager.CreateEntity();
+    bodyManager.AddComponent(fallingEntity);
+    bodyManager.SetComponent(fallingEntity, fallingBody);
+
+    auto floatingBody = fallingBody;
+    floatingBody.affectedByGravity_ = false;
+    const auto floatingEntity = entityManager.CreateEntity();
+    bodyManager.AddComponent(floatingEntity);
+    bodyManager.SetComponent(floatingEntity, floatingBody);
+
+    const core::Scalar dt = game::fixedPeriod;
+    bodyManager.Integrate(dt);
+    bodyManager.ResolveGravityAndGround(dt);
+
+    const auto grounded = bodyManager.GetComponent(fallingEntity);
+    EXPECT_EQ(grounded.position.y, game::groundLevel);
+    EXPECT_EQ(grounded.velocity.y, 0.0f);
+    //The ground only stops the vertical velocity
+    EXPECT_EQ(grounded.velocity.x, fallingBody.velocity.x);
+    const auto floating = bodyManager.GetComponent(floatingEntity);
+    EXPECT_LT(floating.position.y, game::groundLevel);
+    EXPECT_EQ(floating.velocity.y, floatingBody.velocity.y);
+}
+
+TEST(Physics, BroadphasesMatchBruteForce)
+{
+    constexpr std::size_t boxNmb = 200;
+    BoxScene boxScene(boxNmb);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> positionDistribution(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> extendsDistribution(0.05f, 1.5f);
+    for (std::size_t i = 0; i < boxNmb; i++)
+    {
+        //Some boxes span several cells of the grid
+        const auto extendsFactor = i % 10 == 0 ? 3.0f : 1.0f;
+        boxScene.AddBox({ positionDistribution(generator), positionDistribution(generator) },
+            { extendsDistribution(generator) * extendsFactor, extendsDistribution(generator) * extendsFactor });
+    }
+    ExpectSameContacts(boxScene);
+}
+
+TEST(Physics, BroadphasesTouchingBoxes)
+{
+    //Positions on half meters and extends of a quarter or half meter are exact,
+    //so many boxes only touch by an edge or a corner, often on a cell border of the grid
+    constexpr std::size_t boxNmb = 150;
+    BoxScene boxScene(boxNmb + 4);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> positionDistribution(-12, 12);
+    std::uniform_int_distribution<int> extendsDistribution(1, 2);
+    for (std::size_t i = 0; i < boxNmb; i++)
+    {
+        boxScene.AddBox({ static_cast<float>(positionDistribution(generator)) * 0.5f, static_cast<float>(positionDistribution(generator)) * 0.5f },
+            { static_cast<float>(extendsDistribution(generator)) * 0.25f, static_cast<float>(extendsDistribution(generator)) * 0.25f });
+    }
+    //Two boxes only touching by their edge, and two only touching by their corner
+    boxScene.AddBox({ 20.0f, 0.0f }, { 0.5f, 0.5f });
+    boxScene.AddBox({ 21.0f, 0.25f }, { 0.5f, 0.5f });
+    boxScene.AddBox({ 30.0f, 30.0f }, { 0.5f, 0.5f });
+    boxScene.AddBox({ 31.0f, 31.0f }, { 0.5f, 0.5f });
+    const auto contacts = boxScene.FindBruteForceContacts();
+    const auto& entities = boxScene.entities;
+    const auto hasContact = [&contacts](core::Entity entity1, core::Entity entity2)
+    {
+        return std::any_of(contacts.begin(), contacts.end(), [entity1, entity2](const game::Contact& contact)
+        {
+            return contact.entity1 == entity1 && contact.entity2 == entity2;
+        });
+    };
+    EXPECT_TRUE(hasContact(entities[boxNmb], entities[boxNmb + 1]));
+    EXPECT_TRUE(hasContact(entities[boxNmb + 2], entities[boxNmb + 3]));
+    ExpectSameContacts(boxScene);
+}
@@ -0,0 +1,491 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "game/game_manager.h"
+
+namespace
+{
+/**
+ * \brief TestGameManager is a headless game::GameManager exposing its rollback manager.
+ */
+class TestGameManager final : public game::GameManager
+{
+public:
+    explicit TestGameManager(game::WorldMode worldMode = game::WorldMode::ROLLBACK) : GameManager(worldMode) {}
+    game::RollbackManager& GetMutableRollbackManager() { return rollbackManager_; }
+    void StartNewFrame(game::Frame newFrame)
+    {
+        currentFrame_ = newFrame;
+        rollbackManager_.StartNewFrame(newFrame);
+    }
+    void SpawnPlayers()
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            SpawnPlayer(playerNumber, game::spawnPositions[playerNumber]);
+        }
+    }
+    /**
+     * \brief SpawnCharacter spawns a player character that is not one of the players of the game, only moved by the contacts.
+     */
+    core::Entity SpawnCharacter(game::PlayerNumber playerNumber, core::Vec2f position)
+    {
+        const auto entity = entityManager_.CreateEntity();
+        rollbackManager_.SpawnPlayer(playerNumber, entity, position);
+        return entity;
+    }
+    [[nodiscard]] const core::EntityManager& GetEntityManager() const { return entityManager_; }
+    [[nodiscard]] bool IsDestroyed(core::Entity entity) const
+    {
+        return entityManager_.HasComponent(entity, static_cast<core::EntityMask>(game::ComponentType::DESTROYED));
+    }
+    /**
+     * \brief GetAttackNmb gives the number of attacks not destroyed in the current world.
+     */
+    [[nodiscard]] std::size_t GetAttackNmb() const
+    {
+        std::vector<core::Entity> attacks;
+        entityManager_.FindEntities(static_cast<core::EntityMask>(game::ComponentType::PLAYER_ATTACK),
+            static_cast<core::EntityMask>(game::ComponentType::DESTROYED), attacks);
+        return attacks.size();
+    }
+};
+}
+
+namespace
+{
+/**
+ * \brief FindContacts gives the pairs of entities in contact, in ascending Entity order like the PhysicsManager.
+ */
+std::vector<game::Contact> FindContacts(TestGameManager& gameManager, const std::vector<core::Entity>& entities)
+{
+    auto& physicsManager = gameManager.GetMutableRollbackManager().GetCurrentPhysicsManager();
+    std::vector<game::Contact> contacts;
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        for (std::size_t j = i + 1; j < entities.size(); j++)
+        {
+            if (physicsManager.IsInContact(entities[i], entities[j]))
+            {
+                contacts.push_back({ entities[i], entities[j] });
+            }
+        }
+    }
+    return contacts;
+}
+
+/**
+ * \brief DispatchPairByPair dispatches the contacts like the former trigger callbacks,
+ * each pair is tested with the positions and the entities left by the previous ones.
+ */
+void DispatchPairByPair(TestGameManager& gameManager, const std::vector<game::Contact>& contacts)
+{
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    for (const auto& contact : contacts)
+    {
+        if (gameManager.IsDestroyed(contact.entity1) || gameManager.IsDestroyed(contact.entity2) ||
+            !rollbackManager.GetCurrentPhysicsManager().IsInContact(contact.entity1, contact.entity2))
+        {
+            continue;
+        }
+        rollbackManager.OnContacts({ contact });
+    }
+}
+
+/**
+ * \brief ExpectSameContactResults compares the bodies, the characters and the destroyed entities of both worlds.
+ */
+void ExpectSameContactResults(TestGameManager& gameManager, TestGameManager& expectedGameManager,
+    const std::vector<core::Entity>& entities, const std::vector<core::Entity>& characters)
+{
+    auto& physicsManager = gameManager.GetMutableRollbackManager().GetCurrentPhysicsManager();
+    auto& expectedPhysicsManager = expectedGameManager.GetMutableRollbackManager().GetCurrentPhysicsManager();
+    for (const auto entity : entities)
+    {
+        EXPECT_EQ(gameManager.IsDestroyed(entity), expectedGameManager.IsDestroyed(entity)) << "entity " << entity;
+        const auto body = physicsManager.GetBody(entity);
+        const auto expectedBody = expectedPhysicsManager.GetBody(entity);
+        EXPECT_EQ(body.position.x, expectedBody.position.x) << "entity " << entity;
+        EXPECT_EQ(body.position.y, expectedBody.position.y) << "entity " << entity;
+        EXPECT_EQ(body.velocity.x, expectedBody.velocity.x) << "entity " << entity;
+        EXPECT_EQ(body.velocity.y, expectedBody.velocity.y) << "entity " << entity;
+    }
+    for (const auto character : characters)
+    {
+        const auto& playerCharacter = gameManager.GetRollbackManager().GetPlayerCharacterManager().GetComponent(character);
+        const auto& expectedPlayerCharacter = expectedGameManager.GetRollbackManager().GetPlayerCharacterManager().GetComponent(character);
+        EXPECT_EQ(playerCharacter.health, expectedPlayerCharacter.health) << "character " << character;
+        EXPECT_EQ(playerCharacter.playerState, expectedPlayerCharacter.playerState) << "character " << character;
+    }
+}
+}
+
+TEST(RollbackManager, AttackOverlappingBothPlayers)
+{
+    TestGameManager gameManager;
+    TestGameManager expectedGameManager;
+    std::vector<core::Entity> entities;
+    for (auto* testGameManager : { &gameManager, &expectedGameManager })
+    {
+        //The players overlap each other, the push moves player 1 out of the attack of player 2 grazing it
+        testGameManager->SpawnPlayer(0, { 0.0f, 0.0f });
+        testGameManager->SpawnPlayer(1, { 0.4f, 0.0f });
+        //The attack of player 1 overlaps both players and hits player 2
+        const auto attack = testGameManager->SpawnAttack(0, { 0.2f, 0.0f });
+        const auto grazingAttack = testGameManager->SpawnAttack(1, { 0.32f, 0.0f });
+        entities = { testGameManager->GetEntityFromPlayerNumber(0), testGameManager->GetEntityFromPlayerNumber(1), attack, grazingAttack };
+    }
+    const auto contacts = FindContacts(gameManager, entities);
+    ASSERT_EQ(contacts.size(), 6u);
+    gameManager.GetMutableRollbackManager().OnContacts(contacts);
+    DispatchPairByPair(expectedGameManager, contacts);
+    const std::vector<core::Entity> characters(entities.begin(), entities.begin() + 2);
+    ExpectSameContactResults(gameManager, expectedGameManager, entities, characters);
+
+    const auto& playerManager = gameManager.GetRollbackManager().GetPlayerCharacterManager();
+    EXPECT_EQ(playerManager.GetComponent(entities[0]).health, game::playerHealth);
+    EXPECT_EQ(playerManager.GetComponent(entities[1]).health, game::playerHealth - 1);
+    EXPECT_TRUE(gameManager.IsDestroyed(entities[2]));
+    EXPECT_FALSE(gameManager.IsDestroyed(entities[3]));
+}
+
+TEST(RollbackManager, TwoPlayerContactsInOneFrame)
+{
+    TestGameManager gameManager;
+    TestGameManager expectedGameManager;
+    std::vector<core::Entity> entities;
+    for (auto* testGameManager : { &gameManager, &expectedGameManager })
+    {
+        //The second player pushes the first one to the right, out of the character grazing its top left corner
+        testGameManager->SpawnPlayer(0, { 0.0f, 0.0f });
+        testGameManager->SpawnPlayer(1, { -0.4f, -0.2f });
+        const auto character = testGameManager->SpawnCharacter(1, { -0.48f, 0.45f });
+        entities = { testGameManager->GetEntityFromPlayerNumber(0), testGameManager->GetEntityFromPlayerNumber(1), character };
+    }
+    const auto contacts = FindContacts(gameManager, entities);
+    ASSERT_EQ(contacts.size(), 2u);
+    gameManager.GetMutableRollbackManager().OnContacts(contacts);
+    DispatchPairByPair(expectedGameManager, contacts);
+    ExpectSameContactResults(gameManager, expectedGameManager, entities, entities);
+
+    //The grazing character is not pushed anymore
+    const auto characterBody = gameManager.GetMutableRollbackManager().GetCurrentPhysicsManager().GetBody(entities[2]);
+    EXPECT_EQ(characterBody.position.x, -0.48f);
+    EXPECT_EQ(characterBody.position.y, 0.45f);
+}
+
+TEST(RollbackManager, BudgetedRollbackCatchesUp)
+{
+    constexpr game::Frame rollbackDepth = 20;
+    TestGameManager gameManager;
+    gameManager.SpawnPlayers();
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    rollbackManager.SetSimulationBudget({ 2u, std::chrono::microseconds(0) });
+
+    //Each frame, the late remote input mispredicts a frame deeper than the budget simulates
+    game::Frame completeFrameNmb = 0;
+    game::Frame incompleteFrameNmb = 0;
+    for (game::Frame frame = 1; frame <= 100; frame++)
+    {
+        gameManager.StartNewFrame(frame);
+        if (frame > rollbackDepth)
+        {
+            const auto remoteFrame = frame - rollbackDepth;
+            gameManager.SetPlayerInput(1, remoteFrame % 2 == 0 ? game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT, remoteFrame);
+        }
+        if (rollbackManager.SimulateToCurrentFrame())
+        {
+            EXPECT_EQ(rollbackManager.GetSimulatedFrame(), frame);
+            completeFrameNmb++;
+            incompleteFrameNmb = 0;
+        }
+        else
+        {
+            incompleteFrameNmb++;
+            EXPECT_LE(incompleteFrameNmb, game::maxIncompleteSimulationNmb) << "frame " << frame;
+        }
+    }
+    EXPECT_GE(completeFrameNmb, 100u / (game::maxIncompleteSimulationNmb + 1));
+}
+
+TEST(RollbackManager, AdoptedSpeculationMatchesResimulation)
+{
+    constexpr game::Frame rollbackDepth = 4;
+    constexpr game::Frame frameNmb = 120;
+    //The remote player changes one direction button at a time, always guessed by one of the branches.
+    //Attacks are left out as a branch creating entities is not adoptable
+    constexpr std::array<game::PlayerInput, 6> remoteInputs
+    {
+        game::PlayerInputEnum::RIGHT,
+        game::PlayerInputEnum::RIGHT | game::PlayerInputEnum::UP,
+        game::PlayerInputEnum::UP,
+        game::PlayerInputEnum::NONE,
+        game::PlayerInputEnum::LEFT,
+        game::PlayerInputEnum::LEFT | game::PlayerInputEnum::UP
+    };
+    const auto getRemoteInput = [&remoteInputs](game::Frame frame) { return remoteInputs[frame / 7 % remoteInputs.size()]; };
+    const auto getLocalInput = [](game::Frame frame) { return frame / 11 % 2 == 0 ? game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT; };
+
+    TestGameManager speculatingGameManager;
+    TestGameManager gameManager;
+    auto& speculatingRollbackManager = speculatingGameManager.GetMutableRollbackManager();
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    speculatingRollbackManager.SetSpeculativeBranchNmb(game::playerInputBitNmb);
+    speculatingGameManager.SpawnPlayers();
+    gameManager.SpawnPlayers();
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        for (auto* testGameManager : { &speculatingGameManager, &gameManager })
+        {
+            testGameManager->StartNewFrame(frame);
+            testGameManager->SetPlayerInput(0, getLocalInput(frame), frame);
+            if (frame > rollbackDepth)
+            {
+                testGameManager->SetPlayerInput(1, getRemoteInput(frame - rollbackDepth), frame - rollbackDepth);
+            }
+            ASSERT_TRUE(testGameManager->GetMutableRollbackManager().SimulateToCurrentFrame());
+        }
+        //The branches finish before the next inputs, such that the adoption does not depend on the worker threads
+        while (speculatingRollbackManager.IsSpeculating())
+        {
+            std::this_thread::yield();
+        }
+        //Nothing new was received, the idle branches are not loaded again
+        const auto branchNmb = speculatingRollbackManager.GetSpeculationStats().branchNmb;
+        ASSERT_TRUE(speculatingRollbackManager.SimulateToCurrentFrame());
+        EXPECT_EQ(speculatingRollbackManager.GetSpeculationStats().branchNmb, branchNmb);
+
+        if (frame > rollbackDepth)
+        {
+            speculatingGameManager.Validate(frame - rollbackDepth);
+            gameManager.Validate(frame - rollbackDepth);
+            ASSERT_EQ(speculatingRollbackManager.GetValidateChecksum().value, rollbackManager.GetValidateChecksum().value)
+                << "frame " << frame - rollbackDepth;
+        }
+    }
+    const auto& speculationStats = speculatingRollbackManager.GetSpeculationStats();
+    EXPECT_GT(speculationStats.adoptionNmb, 0u);
+    EXPECT_GT(speculationStats.adoptedFrameNmb, speculationStats.adoptionNmb);
+}
+
+TEST(RollbackManager, ValidatedWorldMatchesRollbackWorld)
+{
+    constexpr game::Frame rollbackDepth = 6;
+    constexpr game::Frame frameNmb = 200;
+    //Both players move and attack, the attacks are spawned and destroyed while the remote inputs are mispredicted
+    const auto getInput = [](game::PlayerNumber playerNumber, game::Frame frame) -> game::PlayerInput
+    {
+        const auto cycleFrame = (frame + playerNumber * 40u) % 80u;
+        //An attack starts from a player standing still
+        if (cycleFrame >= 60u && cycleFrame < 63u)
+            return game::PlayerInputEnum::ATTACK;
+        if (cycleFrame >= 45u)
+            return game::PlayerInputEnum::NONE;
+        game::PlayerInput input = cycleFrame < 25u ? game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT;
+        if (cycleFrame >= 10u && cycleFrame < 13u)
+        {
+            input |= game::PlayerInputEnum::UP;
+        }
+        return input;
+    };
+
+    TestGameManager serverGameManager(game::WorldMode::VALIDATED);
+    TestGameManager clientGameManager;
+    serverGameManager.SpawnPlayers();
+    clientGameManager.SpawnPlayers();
+    auto& clientRollbackManager = clientGameManager.GetMutableRollbackManager();
+    std::size_t spawnedAttackNmb = 0;
+    std::size_t destroyedAttackNmb = 0;
+    std::size_t attackNmb = 0;
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            serverGameManager.SetPlayerInput(playerNumber, getInput(playerNumber, frame), frame);
+        }
+        //The client receives the remote inputs late and rollbacks on each change
+        clientGameManager.StartNewFrame(frame);
+        clientGameManager.SetPlayerInput(0, getInput(0, frame), frame);
+        if (frame <= rollbackDepth)
+        {
+            ASSERT_TRUE(clientRollbackManager.SimulateToCurrentFrame());
+            continue;
+        }
+        const auto validateFrame = frame - rollbackDepth;
+        clientGameManager.SetPlayerInput(1, getInput(1, validateFrame), validateFrame);
+        ASSERT_TRUE(clientRollbackManager.SimulateToCurrentFrame());
+
+        serverGameManager.Validate(validateFrame);
+        clientGameManager.Validate(validateFrame);
+        const auto newAttackNmb = serverGameManager.GetAttackNmb();
+        spawnedAttackNmb += newAttackNmb > attackNmb ? newAttackNmb - attackNmb : 0u;
+        destroyedAttackNmb += newAttackNmb < attackNmb ? attackNmb - newAttackNmb : 0u;
+        attackNmb = newAttackNmb;
+        const auto& serverChecksum = serverGameManager.GetRollbackManager().GetValidateChecksum();
+        const auto& clientChecksum = clientRollbackManager.GetValidateChecksum();
+        ASSERT_EQ(serverChecksum.value, clientChecksum.value) << "frame " << validateFrame;
+    }
+    //The checksums matched on the frames where attacks were spawned and destroyed
+    EXPECT_GT(spawnedAttackNmb, 1u);
+    EXPECT_GT(destroyedAttackNmb, 1u);
+}
+
+TEST(RollbackManager, DirtyFrameResimulationMatchesFullResimulation)
+{
+    constexpr game::Frame lateFrame = 30;
+    constexpr game::Frame frameNmb = 60;
+    const auto getLocalInput = [](game::Frame frame) -> game::PlayerInput
+    {
+        if (frame % 20u >= 15u)
+            return frame % 20u < 17u ? game::PlayerInputEnum::ATTACK : game::PlayerInputEnum::NONE;
+        return frame / 11 % 2 == 0 ? game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT;
+    };
+    const auto getRemoteInput = [](game::Frame frame) -> game::PlayerInput
+    {
+        if (frame < lateFrame)
+            return game::PlayerInputEnum::LEFT;
+        return frame % 8u < 4u ? game::PlayerInputEnum::RIGHT | game::PlayerInputEnum::UP : game::PlayerInputEnum::RIGHT;
+    };
+
+    //The remote inputs from the late frame are received at the end, the world simulated with the predictions goes back to the late frame
+    TestGameManager gameManager;
+    gameManager.SpawnPlayers();
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        gameManager.StartNewFrame(frame);
+        gameManager.SetPlayerInput(0, getLocalInput(frame), frame);
+        if (frame < lateFrame)
+        {
+            gameManager.SetPlayerInput(1, getRemoteInput(frame), frame);
+        }
+        while (!rollbackManager.SimulateToCurrentFrame()) {}
+    }
+    ASSERT_EQ(rollbackManager.GetResimulatedFrameNmb(), 0u);
+    for (game::Frame frame = lateFrame; frame <= frameNmb; frame++)
+    {
+        gameManager.SetPlayerInput(1, getRemoteInput(frame), frame);
+    }
+    while (!rollbackManager.SimulateToCurrentFrame()) {}
+    EXPECT_EQ(rollbackManager.GetResimulatedFrameNmb(), frameNmb - lateFrame + 1);
+
+    //The same inputs simulated once all received, from the last validated frame
+    TestGameManager fullGameManager;
+    fullGameManager.SpawnPlayers();
+    auto& fullRollbackManager = fullGameManager.GetMutableRollbackManager();
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        fullGameManager.StartNewFrame(frame);
+        fullGameManager.SetPlayerInput(0, getLocalInput(frame), frame);
+        fullGameManager.SetPlayerInput(1, getRemoteInput(frame), frame);
+    }
+    ASSERT_EQ(fullRollbackManager.GetSimulatedFrame(), fullRollbackManager.GetLastValidateFrame());
+    while (!fullRollbackManager.SimulateToCurrentFrame()) {}
+    EXPECT_EQ(fullRollbackManager.GetResimulatedFrameNmb(), 0u);
+
+    //Validating copies the snapshots of the simulated frames, before and after the late frame
+    for (const auto validateFrame : { lateFrame - 1, lateFrame, frameNmb })
+    {
+        gameManager.Validate(validateFrame);
+        fullGameManager.Validate(validateFrame);
+        ASSERT_EQ(rollbackManager.GetValidateChecksum().value, fullRollbackManager.GetValidateChecksum().value)
+            << "frame " << validateFrame;
+    }
+}
+
+TEST(RollbackManager, OnlyMispredictionsRollback)
+{
+    constexpr game::Frame receivedFrame = 10;
+    constexpr game::Frame frameNmb = 20;
+    TestGameManager gameManager;
+    gameManager.SpawnPlayers();
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        gameManager.StartNewFrame(frame);
+        gameManager.SetPlayerInput(0, game::PlayerInputEnum::RIGHT, frame);
+        if (frame <= receivedFrame)
+        {
+            gameManager.SetPlayerInput(1, game::PlayerInputEnum::LEFT, frame);
+        }
+        while (!rollbackManager.SimulateToCurrentFrame()) {}
+    }
+    ASSERT_EQ(rollbackManager.GetDirtyFrame(), game::INVALID_FRAME);
+
+    //The late input was predicted by repeating the last received one
+    gameManager.SetPlayerInput(1, game::PlayerInputEnum::LEFT, receivedFrame + 1);
+    EXPECT_EQ(rollbackManager.GetDirtyFrame(), game::INVALID_FRAME);
+    EXPECT_EQ(rollbackManager.GetPredictionStats(1).confirmationNmb, 1u);
+    EXPECT_EQ(rollbackManager.GetPredictionStats(1).mispredictionNmb, 0u);
+    while (!rollbackManager.SimulateToCurrentFrame()) {}
+    EXPECT_EQ(rollbackManager.GetResimulatedFrameNmb(), 0u);
+
+    //A mispredicted input rolls back to its frame, not before
+    const auto mispredictedFrame = receivedFrame + 2;
+    gameManager.SetPlayerInput(1, game::PlayerInputEnum::RIGHT, mispredictedFrame);
+    EXPECT_EQ(rollbackManager.GetDirtyFrame(), mispredictedFrame);
+    EXPECT_EQ(rollbackManager.GetPredictionStats(1).confirmationNmb, 1u);
+    EXPECT_EQ(rollbackManager.GetPredictionStats(1).mispredictionNmb, 1u);
+    while (!rollbackManager.SimulateToCurrentFrame()) {}
+    EXPECT_EQ(rollbackManager.GetResimulatedFrameNmb(), frameNmb - mispredictedFrame + 1);
+    EXPECT_EQ(rollbackManager.GetSimulatedFrame(), frameNmb);
+    EXPECT_EQ(rollbackManager.GetDirtyFrame(), game::INVALID_FRAME);
+}
+
+TEST(RollbackManager, CreatedAndDestroyedEntityInWindow)
+{
+    constexpr game::Frame receivedFrame = 2;
+    constexpr game::Frame frameNmb = 60;
+    //The local player attacks once, its attack is destroyed when it expires, before the remote inputs are received
+    const auto getLocalInput = [](game::Frame frame) -> game::PlayerInput
+    {
+        return frame >= 5 && frame < 7 ? game::PlayerInputEnum::ATTACK : game::PlayerInputEnum::NONE;
+    };
+    const auto getRemoteInput = [](game::Frame frame) -> game::PlayerInput
+    {
+        return frame <= receivedFrame ? game::PlayerInputEnum::NONE : game::PlayerInputEnum::UP;
+    };
+    TestGameManager serverGameManager(game::WorldMode::VALIDATED);
+    TestGameManager gameManager;
+    serverGameManager.SpawnPlayers();
+    gameManager.SpawnPlayers();
+    auto& rollbackManager = gameManager.GetMutableRollbackManager();
+    const auto& entityManager = gameManager.GetEntityManager();
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        serverGameManager.SetPlayerInput(0, getLocalInput(frame), frame);
+        serverGameManager.SetPlayerInput(1, getRemoteInput(frame), frame);
+        gameManager.StartNewFrame(frame);
+        gameManager.SetPlayerInput(0, getLocalInput(frame), frame);
+        if (frame <= receivedFrame)
+        {
+            gameManager.SetPlayerInput(1, getRemoteInput(frame), frame);
+        }
+        while (!rollbackManager.SimulateToCurrentFrame()) {}
+    }
+    //The attack uses the first free Entity after the players
+    const core::Entity attackEntity = 2;
+    ASSERT_TRUE(entityManager.HasComponent(attackEntity, static_cast<core::EntityMask>(game::ComponentType::PLAYER_ATTACK)));
+    ASSERT_TRUE(gameManager.IsDestroyed(attackEntity));
+    const auto generation = entityManager.GetGeneration(attackEntity);
+
+    //The rollback before the creation destroys the attack, the resimulation creates it again on the same Entity
+    for (game::Frame frame = receivedFrame + 1; frame <= frameNmb; frame++)
+    {
+        gameManager.SetPlayerInput(1, getRemoteInput(frame), frame);
+    }
+    while (!rollbackManager.SimulateToCurrentFrame()) {}
+    EXPECT_EQ(entityManager.GetGeneration(attackEntity), generation + 1);
+    EXPECT_TRUE(entityManager.HasComponent(attackEntity, static_cast<core::EntityMask>(game::ComponentType::PLAYER_ATTACK)));
+    EXPECT_TRUE(gameManager.IsDestroyed(attackEntity));
+    EXPECT_FALSE(entityManager.EntityExists(attackEntity + 1));
+
+    //Validating the destroy frame destroys the attack definitely
+    gameManager.Validate(frameNmb);
+    serverGameManager.Validate(frameNmb);
+    EXPECT_FALSE(entityManager.EntityExists(attackEntity));
+    EXPECT_EQ(entityManager.GetGeneration(attackEntity), generation + 2);
+    EXPECT_FALSE(entityManager.EntityExists(attackEntity + 1));
+    EXPECT_EQ(rollbackManager.GetValidateChecksum().value, serverGameManager.GetRollbackManager().GetValidateChecksum().value);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "game/time_sync.h"
+
+namespace
+{
+game::TimeSync CreateTimeSync(float frameAdvantage)
+{
+    game::TimeSync timeSync;
+    //The first sample is taken as is by the moving average
+    constexpr game::Frame remoteFrame = 1000;
+    timeSync.AddSample(static_cast<game::Frame>(static_cast<float>(remoteFrame) + frameAdvantage), remoteFrame, 0.0f);
+    return timeSync;
+}
+}
+
+TEST(TimeSync, NoSample)
+{
+    const game::TimeSync timeSync;
+    EXPECT_FLOAT_EQ(timeSync.GetFrameAdvantage(), 0.0f);
+    EXPECT_FLOAT_EQ(timeSync.GetTimeScale(), 1.0f);
+}
+
+TEST(TimeSync, DeadZone)
+{
+    //A frame advantage up to the dead zone is not corrected
+    for (const auto frameAdvantage : { -game::frameAdvantageDeadZone, 0.0f, game::frameAdvantageDeadZone })
+    {
+        const auto timeSync = CreateTimeSync(frameAdvantage);
+        EXPECT_FLOAT_EQ(timeSync.GetFrameAdvantage(), frameAdvantage);
+        EXPECT_FLOAT_EQ(timeSync.GetTimeScale(), 1.0f) << frameAdvantage;
+    }
+}
+
+TEST(TimeSync, SlowsDownWhenAhead)
+{
+    const auto timeSync = CreateTimeSync(3.0f);
+    EXPECT_FLOAT_EQ(timeSync.GetTimeScale(), 1.0f - (3.0f - game::frameAdvantageDeadZone) * game::timeDilationPerFrame);
+    EXPECT_LT(timeSync.GetTimeScale(), 1.0f);
+}
+
+TEST(TimeSync, SpeedsUpWhenBehind)
+{
+    const auto timeSync = CreateTimeSync(-3.0f);
+    EXPECT_FLOAT_EQ(timeSync.GetTimeScale(), 1.0f + (3.0f - game::frameAdvantageDeadZone) * game::timeDilationPerFrame);
+    EXPECT_GT(timeSync.GetTimeScale(), 1.0f);
+}
+
+TEST(TimeSync, Clamping)
+{
+    EXPECT_FLOAT_EQ(CreateTimeSync(100.0f).GetTimeScale(), 1.0f - game::maxTimeDilation);
+    EXPECT_FLOAT_EQ(CreateTimeSync(-100.0f).GetTimeScale(), 1.0f + game::maxTimeDilation);
+}
+
+TEST(TimeSync, RoundTripTime)
+{
+    //The remote inputs are a round trip time old, 100 ms are 5 frames at 50 fps
+    game::TimeSync timeSync;
+    timeSync.AddSample(105, 100, 5.0f * game::fixedPeriod * 1000.0f);
+    EXPECT_NEAR(timeSync.GetFrameAdvantage(), 0.0f, 1e-3f);
+}
+
+TEST(TimeSync, Smoothing)
+{
+    auto timeSync = CreateTimeSync(0.0f);
+    timeSync.AddSample(110, 100, 0.0f);
+    EXPECT_FLOAT_EQ(timeSync.GetFrameAdvantage(), 10.0f * game::frameAdvantageSmoothing);
+}